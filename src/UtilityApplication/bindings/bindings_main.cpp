@@ -4,9 +4,11 @@
 
 // --- External Includes ---
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 
 // --- Core Includes ---
 #include "includes/define_python.h"
+#include "spaces/ublas_space.h"
 
 // --- UtilityApp Includes ---
 #include "bindings/UtilityApplication.hpp"
@@ -15,11 +17,104 @@
 #include "UtilityApp/AMGCLWrapper.hpp"
 #include "UtilityApp/MultifreedomConstraintToElementProcess.hpp"
 #include "UtilityApp/FEUtilities.hpp"
+#include "UtilityApp/ModelPartIO.hpp"
+#include "UtilityApp/IORegistry.hpp"
+
+// --- STL Includes ---
+#include <memory> // shared_ptr, unique_ptr
+#include <set> // set
+#include <optional> // optional
 
 
 namespace Kratos::Python{
 
 
+namespace {
+
+
+/// @brief Share a Python object with C++ code that may copy and release it without holding the GIL.
+std::shared_ptr<pybind11::object> MakeSharedObject(pybind11::object Object)
+{
+    return std::shared_ptr<pybind11::object>(new pybind11::object(std::move(Object)), [](pybind11::object* p_object) {
+        pybind11::gil_scoped_acquire gil;
+        delete p_object;
+    });
+}
+
+
+/// @brief @ref UtilityApp::ModelPartIO forwarding to a Python object's Read and Write methods.
+class PythonModelPartIO final : public UtilityApp::ModelPartIO
+{
+public:
+    explicit PythonModelPartIO(pybind11::object Object)
+        : mpObject(MakeSharedObject(std::move(Object)))
+    {
+    }
+
+    void Read(UtilityApp::Ref<ModelPart> rTarget) const override
+    {
+        pybind11::gil_scoped_acquire gil;
+        mpObject->attr("Read")(pybind11::cast(&rTarget, pybind11::return_value_policy::reference));
+    }
+
+    void Write(UtilityApp::Ref<const ModelPart> rSource) override
+    {
+        pybind11::gil_scoped_acquire gil;
+        mpObject->attr("Write")(pybind11::cast(&const_cast<ModelPart&>(rSource), pybind11::return_value_policy::reference));
+    }
+
+private:
+    std::shared_ptr<pybind11::object> mpObject;
+}; // class PythonModelPartIO
+
+
+/// @brief Names of the formats registered from Python, which are removed before the interpreter shuts down.
+std::set<std::string>& GetPythonFormatNames()
+{
+    static std::set<std::string> names;
+    return names;
+}
+
+
+void RegisterPythonFormat(const std::string& rName,
+                          const std::vector<std::string>& rExtensions,
+                          pybind11::object Sniffer,
+                          pybind11::object Factory)
+{
+    UtilityApp::IORegistry::Format format {rName, rExtensions, {}, {}};
+
+    if (!Sniffer.is_none()) {
+        format.mSniffer = [p_sniffer = MakeSharedObject(std::move(Sniffer))](const std::filesystem::path& rFilePath, std::span<const char> Head) {
+            pybind11::gil_scoped_acquire gil;
+            const pybind11::object verdict = (*p_sniffer)(rFilePath.string(), pybind11::bytes(Head.data(), Head.size()));
+            return verdict.is_none() ? std::optional<bool>() : std::optional<bool>(verdict.cast<bool>());
+        };
+    }
+
+    format.mFactory = [p_factory = MakeSharedObject(std::move(Factory))](const std::filesystem::path& rFilePath) {
+        pybind11::gil_scoped_acquire gil;
+        return std::unique_ptr<UtilityApp::ModelPartIO>(new PythonModelPartIO((*p_factory)(rFilePath.string())));
+    };
+
+    UtilityApp::IORegistry::Get().Register(std::move(format));
+    GetPythonFormatNames().insert(rName);
+}
+
+
+/// @brief Destroy an @ref UtilityApp::AsyncModelPartIO without the GIL, since its worker may need it to finish pending writes.
+struct AsyncModelPartIODeleter
+{
+    void operator()(UtilityApp::AsyncModelPartIO* pIO) const
+    {
+        pybind11::gil_scoped_release release;
+        delete pIO;
+    }
+}; // struct AsyncModelPartIODeleter
+
+
+} // unnamed namespace
+
+
 PYBIND11_MODULE(KratosUtilityApplication, module) {
     pybind11::class_<UtilityApplication,
                      UtilityApplication::Pointer,
@@ -27,6 +122,49 @@ PYBIND11_MODULE(KratosUtilityApplication, module) {
         .def(pybind11::init<>())
         ;
 
+    pybind11::class_<UtilityApp::ModelPartIO>(module, "ModelPartIO")
+        .def("Read", &UtilityApp::ModelPartIO::Read, pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("Write", &UtilityApp::ModelPartIO::Write, pybind11::call_guard<pybind11::gil_scoped_release>())
+        ;
+
+    // AsyncModelPartIO(path, queue_size = 1): writes through IOFactory(path) on a background thread.
+    // Not derived from ModelPartIO on the Python side, because its holder releases the GIL.
+    pybind11::class_<UtilityApp::AsyncModelPartIO,
+                     std::unique_ptr<UtilityApp::AsyncModelPartIO,AsyncModelPartIODeleter>>(module, "AsyncModelPartIO")
+        .def(pybind11::init([](const std::string& rFilePath, std::size_t QueueSize) {
+                return std::unique_ptr<UtilityApp::AsyncModelPartIO,AsyncModelPartIODeleter>(
+                    new UtilityApp::AsyncModelPartIO(UtilityApp::IOFactory(rFilePath), QueueSize));
+             }),
+             pybind11::arg("path"),
+             pybind11::arg("queue_size") = 1)
+        .def("Read", &UtilityApp::AsyncModelPartIO::Read, pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("Write", &UtilityApp::AsyncModelPartIO::Write, pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("Flush", &UtilityApp::AsyncModelPartIO::Flush, pybind11::call_guard<pybind11::gil_scoped_release>())
+        ;
+
+    module.def("IOFactory",
+               [](const std::string& rFilePath) {return UtilityApp::IOFactory(rFilePath);},
+               pybind11::call_guard<pybind11::gil_scoped_release>());
+
+    // RegisterModelPartIO(name, extensions, sniffer, factory)
+    // - sniffer: None or callable(path: str, head: bytes) -> bool, or None if the head is inconclusive
+    // - factory: callable(path: str) -> object with Read(model_part) and Write(model_part)
+    module.def("RegisterModelPartIO", &RegisterPythonFormat);
+    module.def("UnregisterModelPartIO", [](const std::string& rName) {
+        UtilityApp::IORegistry::Get().Unregister(rName);
+        GetPythonFormatNames().erase(rName);
+    });
+    module.def("GetModelPartIOFormats", []() {return UtilityApp::IORegistry::Get().GetNames();});
+    module.def("DetectModelPartIOFormat",
+               [](const std::string& rFilePath) {return UtilityApp::IORegistry::Get().Detect(rFilePath);},
+               pybind11::call_guard<pybind11::gil_scoped_release>());
+
+    // Python callables must not outlive the interpreter.
+    pybind11::module_::import("atexit").attr("register")(pybind11::cpp_function([]() {
+        for (const auto& r_name : GetPythonFormatNames()) UtilityApp::IORegistry::Get().Unregister(r_name);
+        GetPythonFormatNames().clear();
+    }));
+
     pybind11::class_<Kratos::UtilityApp::FindElementsByCrossSectionOperation,
                      std::shared_ptr<Kratos::UtilityApp::FindElementsByCrossSectionOperation>,
                      Operation>(module, "FindElementsByCrossSectionOperation")
@@ -51,6 +189,34 @@ PYBIND11_MODULE(KratosUtilityApplication, module) {
     .def(pybind11::init<Model&, Parameters>())
     ;
 
+    pybind11::class_<AMGCLLevelStatistics>(module, "AMGCLLevelStatistics")
+        .def_readonly("row_count", &AMGCLLevelStatistics::mRowCount)
+        .def_readonly("nonzero_count", &AMGCLLevelStatistics::mNonZeroCount)
+        .def_readonly("memory", &AMGCLLevelStatistics::mMemory)
+        ;
+
+    pybind11::class_<AMGCLSolveStatistics>(module, "AMGCLSolveStatistics")
+        .def_readonly("setup_time", &AMGCLSolveStatistics::mSetupTime)
+        .def_readonly("solve_time", &AMGCLSolveStatistics::mSolveTime)
+        .def_readonly("iteration_count", &AMGCLSolveStatistics::mIterationCount)
+        .def_readonly("residual", &AMGCLSolveStatistics::mResidual)
+        .def_readonly("reused_hierarchy", &AMGCLSolveStatistics::mReusedHierarchy)
+        .def_readonly("operator_complexity", &AMGCLSolveStatistics::mOperatorComplexity)
+        .def_readonly("grid_complexity", &AMGCLSolveStatistics::mGridComplexity)
+        .def_readonly("fallback_count", &AMGCLSolveStatistics::mFallbackCount)
+        .def_readonly("fallback_time", &AMGCLSolveStatistics::mFallbackTime)
+        .def_readonly("levels", &AMGCLSolveStatistics::mLevels)
+        ;
+
+    using AMGCLWrapperType = AMGCLWrapper<TUblasSparseSpace<double>,TUblasDenseSpace<double>>;
+    pybind11::class_<AMGCLWrapperType,
+                     AMGCLWrapperType::Pointer,
+                     LinearSolver<TUblasSparseSpace<double>,TUblasDenseSpace<double>>>(module, "AMGCLWrapper")
+        .def(pybind11::init<Parameters>())
+        .def("GetStatistics", &AMGCLWrapperType::GetStatistics)
+        .def_static("GetDefaultParameters", &AMGCLWrapperType::GetDefaultParameters)
+        ;
+
     pybind11::class_<UtilityApp::FEUtilities>(module, "FEUtilities")
         .def_static("Interpolate", [](
             UtilityApp::Ref<const Geometry<Node>> g,
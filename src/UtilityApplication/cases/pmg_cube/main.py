@@ -146,3 +146,20 @@ if __name__ == "__main__":
 
     # Run!
     analysis.Run()
+
+    # Dump the statistics of the linear solver for plot_performance.py.
+    linear_solver = analysis._GetSolver()._GetLinearSolver()
+    if hasattr(linear_solver, "GetStatistics"):
+        with open("statistics.json", "w") as file:
+            json.dump([{"setup_time" : statistics.setup_time,
+                        "solve_time" : statistics.solve_time,
+                        "iteration_count" : statistics.iteration_count,
+                        "residual" : statistics.residual,
+                        "reused_hierarchy" : statistics.reused_hierarchy,
+                        "operator_complexity" : statistics.operator_complexity,
+                        "grid_complexity" : statistics.grid_complexity,
+                        "fallback_count" : statistics.fallback_count,
+                        "fallback_time" : statistics.fallback_time}
+                       for statistics in linear_solver.GetStatistics()],
+                      file,
+                      indent = 4)
@@ -9,6 +9,7 @@ import re
 import typing
 from collections import OrderedDict
 import itertools
+import json
 
 
 script_dir = pathlib.Path(__file__).absolute().parent
@@ -69,6 +70,33 @@ class Dataset:
 
 
 
+class StatisticsDataset:
+    """@brief Value computed from the statistics of the linear solver, dumped by main.py."""
+
+    def __init__(self, key: str, reduction: typing.Callable[[list[float]],typing.Optional[float]]) -> None:
+        self.__key: str = key
+        self.__values: "list[float]" = []
+        self.__reduction: typing.Callable[[list[float]],typing.Optional[float]] = reduction
+
+
+    def Parse(self, line: str) -> bool:
+        return False
+
+
+    def Load(self, statistics: "list[dict]") -> None:
+        self.__values.extend(float(item[self.__key]) for item in statistics)
+
+
+    def Clone(self) -> "StatisticsDataset":
+        return StatisticsDataset(self.__key, self.__reduction)
+
+
+    @property
+    def value(self) -> typing.Optional[float]:
+        return self.__reduction(self.__values)
+
+
+
 def Max(values: "list[float]") -> typing.Optional[float]:
     return max(values) if values else None
 
@@ -81,14 +109,15 @@ def Avg(values: "list[float]") -> typing.Optional[float]:
     return (sum(values, 0.0) / len(values)) if values else None
 
 
-datasets: "dict[str,Dataset]" = {
+datasets: "dict[str,typing.Union[Dataset,StatisticsDataset]]" = {
     "nodes" : Dataset(R".*Number of Nodes +: ([0-9]+)", Max),
     "elements" : Dataset(R".*Number of Elements +: ([0-9]+)", Max),
     "conditions" : Dataset(R".*Number of Conditions +: ([0-9]+)", Max),
     "read_time" : Dataset(R""".*Reading file ".*" took (""" + time_pattern + R""") \[s\]""", Max),
     "allocation_time" : Dataset(f".*System Construction Time: ({time_pattern})", Max),
     "assembly_time" : Dataset(f"ResidualBasedBlockBuilderAndSolver: (?:Build time: ({time_pattern})|Constraints build time: ({time_pattern}))", Sum),
-    "solution_time" : Dataset(f".*System solve time: ({time_pattern})", Avg)
+    "solution_time" : Dataset(f".*System solve time: ({time_pattern})", Avg),
+    "iterations" : StatisticsDataset("iteration_count", Avg)
 }
 dataset_names: "list[str]" = list(datasets.keys())
 
@@ -106,7 +135,7 @@ class Case:
         self.__level: int = int(m.group(2))
         self.__solver: str = "pmg" if m.group(3) == "hierarchical_solver" else "amg"
         self.__constrained_group: str = m.group(4)
-        self.__datasets: "dict[str,Dataset]" = {name : dataset.Clone() for name, dataset in datasets.items()}
+        self.__datasets: "dict[str,typing.Union[Dataset,StatisticsDataset]]" = {name : dataset.Clone() for name, dataset in datasets.items()}
 
 
     def Parse(self, file: typing.TextIO) -> None:
@@ -115,6 +144,12 @@ class Case:
                 dataset.Parse(line)
 
 
+    def LoadStatistics(self, statistics: "list[dict]") -> None:
+        for dataset in self.__datasets.values():
+            if isinstance(dataset, StatisticsDataset):
+                dataset.Load(statistics)
+
+
     @property
     def order(self) -> int:
         return self.__order
@@ -136,7 +171,7 @@ class Case:
 
 
     @property
-    def datasets(self) -> "dict[str,Dataset]":
+    def datasets(self) -> "dict[str,typing.Union[Dataset,StatisticsDataset]]":
         return self.__datasets
 
 
@@ -196,6 +231,11 @@ for path in pathlib.Path(".").glob("*/log"):
         with open(path, "r") as file:
             case.Parse(file)
 
+        statistics_path = path.parent / "statistics.json"
+        if statistics_path.is_file():
+            with open(statistics_path, "r") as file:
+                case.LoadStatistics(json.load(file))
+
         if arguments.group == "all":
             groups.setdefault("all", []).append(case)
         else:
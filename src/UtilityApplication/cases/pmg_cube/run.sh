@@ -27,7 +27,7 @@ for mesh in "x1" "x2" "x4" "linear_x1" "linear_x2" "linear_x4"; do
     for solver in "hierarchical_solver" "standalone_amgcl_raw_solver"; do
         for constrained_group in "top_10" "top_40" "top_90" "volume_10"; do
             # Clean the current directory of old output
-            find "$(pwd)" -maxdepth 1 \( -name "*.mm" -o -name "*.png" -o -name "*.h5" -o -name "*.journal" -o -name "*.xdmf" \) -delete
+            find "$(pwd)" -maxdepth 1 \( -name "*.mm" -o -name "*.png" -o -name "*.h5" -o -name "*.journal" -o -name "*.xdmf" -o -name "statistics.json" \) -delete
 
             # Create new directory for results
             directory_name="${mesh}_mesh_${solver}_${constrained_group}"
@@ -44,6 +44,7 @@ for mesh in "x1" "x2" "x4" "linear_x1" "linear_x2" "linear_x4"; do
             fi
 
             for f in *.h5; do mv $f $directory_name; done
+            if [ -f statistics.json ]; then mv statistics.json "$directory_name"; fi
 
             # Move result output
             cd "$script_dir"
@@ -0,0 +1,164 @@
+/// @author Máté Kelemen
+/// @details Measure the effect of the @a "first_touch" option of @ref Kratos::AMGCLWrapper.
+///          First, a STREAM triad (a = b + s * c) runs on arrays initialized by a single
+///          thread and on arrays initialized in parallel with the triad's own partitioning,
+///          to show the memory bandwidth available to each placement. Then a serially
+///          assembled 3D Poisson problem is solved with and without first touch allocation.
+///          Usage: amgcl_first_touch_benchmark [points per edge = 100] [triad size = 2^26] [repetitions = 5]
+
+// --- UtilityApp Includes ---
+#include "UtilityApp/AMGCLWrapper.hpp"
+
+// --- Core Includes ---
+#include "spaces/ublas_space.h"
+#include "utilities/parallel_utilities.h"
+#include "utilities/builtin_timer.h"
+
+// --- STL Includes ---
+#include <iostream> // cerr, cout
+#include <memory> // unique_ptr
+#include <string> // stoul
+#include <algorithm> // min
+#include <limits> // numeric_limits
+
+
+namespace Kratos::UtilityApp {
+
+
+using SparseSpace = TUblasSparseSpace<double>;
+
+using DenseSpace = TUblasDenseSpace<double>;
+
+
+/// @brief Best triad bandwidth [GB/s] on arrays whose pages were first touched serially or in parallel.
+double MeasureTriad(std::size_t Size, std::size_t RepetitionCount, bool ParallelInitialization)
+{
+    // new[] leaves the arrays uninitialized, so the initialization below is the first touch.
+    std::unique_ptr<double[]> a(new double[Size]), b(new double[Size]), c(new double[Size]);
+    const auto initialize = [&a, &b, &c](std::size_t i) {
+        a[i] = 0.0;
+        b[i] = 1.0;
+        c[i] = 2.0;
+    };
+    if (ParallelInitialization) {
+        IndexPartition<std::size_t>(Size).for_each(initialize);
+    } else {
+        for (std::size_t i=0; i<Size; ++i) initialize(i);
+    }
+
+    const double scale = 3.0;
+    double best_time = std::numeric_limits<double>::max();
+    for (std::size_t i_repetition=0; i_repetition<RepetitionCount; ++i_repetition) {
+        BuiltinTimer timer;
+        IndexPartition<std::size_t>(Size).for_each([&a, &b, &c, scale](std::size_t i) {
+            a[i] = b[i] + scale * c[i];
+        });
+        best_time = std::min(best_time, timer.ElapsedSeconds());
+    }
+
+    return 3.0 * sizeof(double) * Size / best_time / 1e9;
+}
+
+
+/// @brief Fastest solve time [s] of the Poisson system with or without first touch allocation.
+double MeasureSolve(SparseSpace::MatrixType& rA,
+                    const SparseSpace::VectorType& rB,
+                    std::size_t RepetitionCount,
+                    bool FirstTouch)
+{
+    Parameters settings(R"({
+        "solver_type" : "amgcl_wrapper",
+        "verbosity" : 0,
+        "amgcl_settings" : {
+            "precond" : {
+                "class" : "amg",
+                "relax" : {"type" : "spai0"},
+                "coarsening" : {"type" : "smoothed_aggregation"}
+            },
+            "solver" : {
+                "type" : "cg",
+                "maxiter" : 1000,
+                "tol" : 1e-8
+            }
+        }
+    })");
+    settings.AddInt("statistics_history", RepetitionCount);
+    settings.AddBool("first_touch", FirstTouch);
+
+    AMGCLWrapper<SparseSpace,DenseSpace> solver(settings);
+    for (std::size_t i_repetition=0; i_repetition<RepetitionCount; ++i_repetition) {
+        SparseSpace::VectorType x(rB.size(), 0.0), b = rB;
+        solver.Solve(rA, x, b);
+    }
+
+    double best_time = std::numeric_limits<double>::max();
+    for (const auto& r_statistics : solver.GetStatistics()) {
+        best_time = std::min(best_time, r_statistics.mSolveTime);
+    }
+    return best_time;
+}
+
+
+int main(int argc, const char** argv)
+{
+    std::size_t edge_size = 100, triad_size = std::size_t(1) << 26, repetition_count = 5;
+    try {
+        if (1 < argc) edge_size = std::stoul(argv[1]);
+        if (2 < argc) triad_size = std::stoul(argv[2]);
+        if (3 < argc) repetition_count = std::stoul(argv[3]);
+    } catch (...) {
+        std::cerr << "invalid number of points per edge, triad size or repetitions\n";
+        return 1;
+    }
+
+    const double serial_bandwidth = MeasureTriad(triad_size, repetition_count, false);
+    const double parallel_bandwidth = MeasureTriad(triad_size, repetition_count, true);
+
+    // Assemble the system on a single thread, keeping Dirichlet boundaries as identity rows.
+    const std::size_t system_size = edge_size * edge_size * edge_size;
+    SparseSpace::MatrixType A(system_size, system_size, 7 * system_size);
+    SparseSpace::VectorType b(system_size);
+    const double h2i = static_cast<double>((edge_size - 1) * (edge_size - 1));
+    const std::size_t stride_j = edge_size, stride_k = edge_size * edge_size;
+
+    for (std::size_t i_row=0; i_row<system_size; ++i_row) {
+        const std::size_t i = i_row % edge_size;
+        const std::size_t j = (i_row / edge_size) % edge_size;
+        const std::size_t k = i_row / (edge_size * edge_size);
+        if (i == 0 || i == edge_size - 1 || j == 0 || j == edge_size - 1 || k == 0 || k == edge_size - 1) {
+            A.push_back(i_row, i_row, 1.0);
+            b[i_row] = 0.0;
+        } else {
+            A.push_back(i_row, i_row - stride_k, -h2i);
+            A.push_back(i_row, i_row - stride_j, -h2i);
+            A.push_back(i_row, i_row - 1, -h2i);
+            A.push_back(i_row, i_row, 6.0 * h2i);
+            A.push_back(i_row, i_row + 1, -h2i);
+            A.push_back(i_row, i_row + stride_j, -h2i);
+            A.push_back(i_row, i_row + stride_k, -h2i);
+            b[i_row] = 1.0;
+        }
+    }
+    A.complete_index1_data();
+
+    const double default_time = MeasureSolve(A, b, repetition_count, false);
+    const double first_touch_time = MeasureSolve(A, b, repetition_count, true);
+
+    std::cout << "threads          : " << ParallelUtilities::GetNumThreads() << "\n"
+              << "                 \tserial\tparallel\tratio\n"
+              << "triad [GB/s]     \t" << serial_bandwidth << "\t" << parallel_bandwidth << "\t" << parallel_bandwidth / serial_bandwidth << "\n"
+              << "unknowns         : " << system_size << "\n"
+              << "                 \tdefault\tfirst touch\tspeedup\n"
+              << "solve [s]        \t" << default_time << "\t" << first_touch_time << "\t" << default_time / first_touch_time << "\n";
+
+    return 0;
+} // int main
+
+
+} // namespace Kratos::UtilityApp
+
+
+int main(int argc, const char** argv)
+{
+    return Kratos::UtilityApp::main(argc, argv);
+} // int main
@@ -0,0 +1,159 @@
+/// @author Máté Kelemen
+/// @details Strong scaling comparison of AMGCL's CG against @ref Kratos::UtilityApp::PipelinedCG
+///          and @ref Kratos::UtilityApp::SingleReductionCG, solving a 3D Poisson problem
+///          (7-point stencil on a cube) with @ref Kratos::AMGCLWrapper on an increasing number
+///          of threads (powers of 2 up to the maximum).
+///          Usage: amgcl_krylov_scaling [points per edge = 100] [max threads = all] [repetitions = 3]
+
+// --- UtilityApp Includes ---
+#include "UtilityApp/AMGCLWrapper.hpp"
+
+// --- Core Includes ---
+#include "spaces/ublas_space.h"
+#include "utilities/parallel_utilities.h"
+
+// --- STL Includes ---
+#include <iostream> // cerr, cout
+#include <string> // string, stoul
+#include <array> // array
+#include <vector> // vector
+#include <algorithm> // min
+#include <limits> // numeric_limits
+
+
+namespace Kratos::UtilityApp {
+
+
+using SparseSpace = TUblasSparseSpace<double>;
+
+using DenseSpace = TUblasDenseSpace<double>;
+
+
+struct ScalingResult
+{
+    double mSolveTime = std::numeric_limits<double>::max();
+
+    std::size_t mIterationCount = 0;
+
+    double mResidual = 0.0;
+}; // struct ScalingResult
+
+
+ScalingResult Run(SparseSpace::MatrixType& rA,
+                  const SparseSpace::VectorType& rB,
+                  const std::string& rSolverType,
+                  std::size_t RepetitionCount)
+{
+    Parameters settings(R"({
+        "solver_type" : "amgcl_wrapper",
+        "verbosity" : 0,
+        "static_dispatch" : false,
+        "amgcl_settings" : {
+            "precond" : {
+                "class" : "amg",
+                "relax" : {"type" : "spai0"},
+                "coarsening" : {"type" : "smoothed_aggregation"}
+            },
+            "solver" : {
+                "maxiter" : 1000,
+                "tol" : 1e-8
+            }
+        }
+    })");
+    settings.AddInt("statistics_history", RepetitionCount);
+    settings["amgcl_settings"]["solver"].AddString("type", rSolverType);
+
+    AMGCLWrapper<SparseSpace,DenseSpace> solver(settings);
+    for (std::size_t i_repetition=0; i_repetition<RepetitionCount; ++i_repetition) {
+        SparseSpace::VectorType x(rB.size(), 0.0), b = rB;
+        solver.Solve(rA, x, b);
+    }
+
+    // Report the fastest repetition to filter out noise.
+    ScalingResult result;
+    for (const auto& r_statistics : solver.GetStatistics()) {
+        result.mSolveTime = std::min(result.mSolveTime, r_statistics.mSolveTime);
+        result.mIterationCount = r_statistics.mIterationCount;
+        result.mResidual = r_statistics.mResidual;
+    }
+    return result;
+}
+
+
+int main(int argc, const char** argv)
+{
+    std::size_t edge_size = 100, max_threads = ParallelUtilities::GetNumThreads(), repetition_count = 3;
+    try {
+        if (1 < argc) edge_size = std::stoul(argv[1]);
+        if (2 < argc) max_threads = std::stoul(argv[2]);
+        if (3 < argc) repetition_count = std::stoul(argv[3]);
+    } catch (...) {
+        std::cerr << "invalid number of points per edge, threads or repetitions\n";
+        return 1;
+    }
+
+    // Assemble the system, keeping Dirichlet boundaries as identity rows.
+    const std::size_t system_size = edge_size * edge_size * edge_size;
+    SparseSpace::MatrixType A(system_size, system_size, 7 * system_size);
+    SparseSpace::VectorType b(system_size);
+    const double h2i = static_cast<double>((edge_size - 1) * (edge_size - 1));
+    const std::size_t stride_j = edge_size, stride_k = edge_size * edge_size;
+
+    for (std::size_t i_row=0; i_row<system_size; ++i_row) {
+        const std::size_t i = i_row % edge_size;
+        const std::size_t j = (i_row / edge_size) % edge_size;
+        const std::size_t k = i_row / (edge_size * edge_size);
+        if (i == 0 || i == edge_size - 1 || j == 0 || j == edge_size - 1 || k == 0 || k == edge_size - 1) {
+            A.push_back(i_row, i_row, 1.0);
+            b[i_row] = 0.0;
+        } else {
+            A.push_back(i_row, i_row - stride_k, -h2i);
+            A.push_back(i_row, i_row - stride_j, -h2i);
+            A.push_back(i_row, i_row - 1, -h2i);
+            A.push_back(i_row, i_row, 6.0 * h2i);
+            A.push_back(i_row, i_row + 1, -h2i);
+            A.push_back(i_row, i_row + stride_j, -h2i);
+            A.push_back(i_row, i_row + stride_k, -h2i);
+            b[i_row] = 1.0;
+        }
+    }
+    A.complete_index1_data();
+
+    const std::array<std::string,3> solver_types {"cg", "pipelined_cg", "single_reduction_cg"};
+    std::array<double,3> serial_times {0.0, 0.0, 0.0};
+
+    std::cout << "unknowns : " << system_size << "\n"
+              << "threads";
+    for (const auto& r_type : solver_types) std::cout << "\t" << r_type << " [s]\titerations\tspeedup\tefficiency";
+    std::cout << "\n";
+
+    std::vector<std::size_t> thread_counts;
+    for (std::size_t thread_count=1; thread_count<max_threads; thread_count*=2) thread_counts.push_back(thread_count);
+    thread_counts.push_back(max_threads);
+
+    for (std::size_t thread_count : thread_counts) {
+        ParallelUtilities::SetNumThreads(thread_count);
+        std::cout << thread_count;
+        for (std::size_t i_type=0; i_type<solver_types.size(); ++i_type) {
+            const auto result = Run(A, b, solver_types[i_type], repetition_count);
+            if (thread_count == thread_counts.front()) serial_times[i_type] = result.mSolveTime * thread_count;
+            const double speedup = serial_times[i_type] / result.mSolveTime;
+            std::cout << "\t" << result.mSolveTime
+                      << "\t" << result.mIterationCount
+                      << "\t" << speedup
+                      << "\t" << speedup / thread_count;
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+} // int main
+
+
+} // namespace Kratos::UtilityApp
+
+
+int main(int argc, const char** argv)
+{
+    return Kratos::UtilityApp::main(argc, argv);
+} // int main
@@ -0,0 +1,167 @@
+/// @author Máté Kelemen
+/// @details Solve a 3D Poisson problem (7-point stencil on a cube) distributed over
+///          MPI ranks with @ref Kratos::AMGCLWrapper, to test its MPI path on a single box.
+///          Usage: mpirun -np 4 amgcl_mpi_poisson [points per edge = 64] [solver settings JSON]
+
+// --- UtilityApp Includes ---
+#include "UtilityApp/AMGCLWrapper.hpp"
+
+// --- Core Includes ---
+#include "spaces/ublas_space.h"
+#include "includes/parallel_environment.h"
+#include "utilities/builtin_timer.h"
+
+#ifdef KRATOS_USING_MPI
+#include "mpi/includes/mpi_manager.h"
+#endif
+
+// --- STL Includes ---
+#include <iostream> // cerr, cout
+#include <fstream> // ifstream
+#include <sstream> // stringstream
+#include <string> // stoul
+#include <cmath> // sqrt
+
+
+namespace Kratos::UtilityApp {
+
+
+using SparseSpace = TUblasSparseSpace<double>;
+
+using DenseSpace = TUblasDenseSpace<double>;
+
+
+int main(int argc, const char** argv)
+{
+    #ifdef KRATOS_USING_MPI
+    ParallelEnvironment::SetUpMPIEnvironment(MPIManager::Create());
+    const DataCommunicator& r_communicator = ParallelEnvironment::GetDataCommunicator("World");
+    const int rank = r_communicator.Rank();
+    const int rank_count = r_communicator.Size();
+
+    std::size_t edge_size = 64;
+    if (1 < argc) {
+        try {
+            edge_size = std::stoul(argv[1]);
+        } catch (...) {
+            if (!rank) std::cerr << "invalid number of points per edge: " << argv[1] << "\n";
+            return 1;
+        }
+    }
+
+    Parameters settings(R"({
+        "solver_type" : "amgcl_wrapper",
+        "verbosity" : 1,
+        "data_communicator" : "World",
+        "amgcl_settings" : {
+            "precond" : {
+                "coarsening" : {
+                    "type" : "smoothed_aggregation"
+                },
+                "relax" : {
+                    "type" : "spai0"
+                }
+            },
+            "solver" : {
+                "type" : "cg",
+                "maxiter" : 500,
+                "tol" : 1e-8
+            }
+        }
+    })");
+    if (2 < argc) {
+        std::ifstream file(argv[2]);
+        if (!file) {
+            if (!rank) std::cerr << "cannot open solver settings: " << argv[2] << "\n";
+            return 1;
+        }
+        std::stringstream contents;
+        contents << file.rdbuf();
+        settings = Parameters(contents.str());
+    }
+
+    // Partition the rows evenly, the first ranks taking the remainder.
+    const std::size_t system_size = edge_size * edge_size * edge_size;
+    const std::size_t row_count = system_size / rank_count + (static_cast<std::size_t>(rank) < system_size % rank_count);
+    const std::size_t row_begin = r_communicator.ScanSum(row_count) - row_count;
+
+    // Assemble the local strip of rows with global column indices.
+    SparseSpace::MatrixType A(row_count, system_size, 7 * row_count);
+    SparseSpace::VectorType b(row_count), x(row_count);
+    const double h2i = static_cast<double>((edge_size - 1) * (edge_size - 1));
+
+    for (std::size_t i_local=0; i_local<row_count; ++i_local) {
+        const std::size_t i_row = row_begin + i_local;
+        const std::size_t i = i_row % edge_size;
+        const std::size_t j = (i_row / edge_size) % edge_size;
+        const std::size_t k = i_row / (edge_size * edge_size);
+
+        // Dirichlet boundaries are kept in the system as identity rows.
+        if (i == 0 || i == edge_size - 1 || j == 0 || j == edge_size - 1 || k == 0 || k == edge_size - 1) {
+            A.push_back(i_local, i_row, 1.0);
+            b[i_local] = 0.0;
+        } else {
+            const std::size_t stride_j = edge_size, stride_k = edge_size * edge_size;
+            A.push_back(i_local, i_row - stride_k, -h2i);
+            A.push_back(i_local, i_row - stride_j, -h2i);
+            A.push_back(i_local, i_row - 1, -h2i);
+            A.push_back(i_local, i_row, 6.0 * h2i);
+            A.push_back(i_local, i_row + 1, -h2i);
+            A.push_back(i_local, i_row + stride_j, -h2i);
+            A.push_back(i_local, i_row + stride_k, -h2i);
+            b[i_local] = 1.0;
+        }
+        x[i_local] = 0.0;
+    }
+    A.complete_index1_data();
+
+    // Solve
+    AMGCLWrapper<SparseSpace,DenseSpace> solver(settings);
+    BuiltinTimer timer;
+    const bool converged = solver.Solve(A, x, b);
+    const double elapsed = r_communicator.MaxAll(timer.ElapsedSeconds());
+
+    // Check the residual independently of AMGCL
+    SparseSpace::VectorType x_global(system_size);
+    {
+        const auto global = r_communicator.AllGatherv(std::vector<double>(x.begin(), x.end()));
+        std::copy(global.begin(), global.end(), x_global.begin());
+    }
+    SparseSpace::VectorType r(row_count);
+    SparseSpace::Mult(A, x_global, r);
+    double local_residual = 0.0, local_norm = 0.0;
+    for (std::size_t i_local=0; i_local<row_count; ++i_local) {
+        local_residual += (b[i_local] - r[i_local]) * (b[i_local] - r[i_local]);
+        local_norm += b[i_local] * b[i_local];
+    }
+    const double residual = std::sqrt(r_communicator.SumAll(local_residual) / r_communicator.SumAll(local_norm));
+
+    if (!rank) {
+        const auto statistics = solver.GetStatistics();
+        std::cout << "ranks      : " << rank_count << "\n"
+                  << "unknowns   : " << system_size << "\n"
+                  << "time       : " << elapsed << " [s]\n"
+                  << "residual   : " << residual << "\n";
+        if (!statistics.empty()) {
+            std::cout << "setup time : " << statistics.back().mSetupTime << " [s]\n"
+                      << "solve time : " << statistics.back().mSolveTime << " [s]\n"
+                      << "iterations : " << statistics.back().mIterationCount << "\n"
+                      << "levels     : " << statistics.back().mLevels.size() << "\n";
+        }
+    }
+
+    return converged ? 0 : 1;
+    #else
+    std::cerr << "amgcl_mpi_poisson requires compiling with MPI support\n";
+    return 1;
+    #endif
+} // int main
+
+
+} // namespace Kratos::UtilityApp
+
+
+int main(int argc, const char** argv)
+{
+    return Kratos::UtilityApp::main(argc, argv);
+} // int main
@@ -0,0 +1,233 @@
+/// @author Máté Kelemen
+/// @details Measure the peak memory of constructing the AMG hierarchy of a 3D Poisson problem,
+///          either through @ref Kratos::AMGCLWrapper (which builds the hierarchy's matrix directly
+///          from the arrays of the system matrix) or through the adapter path the wrapper used
+///          before: a CRS copy of amgcl::backend::map, which amg copies once more.
+///          Only one path is measured per process, so that memory released by the other one
+///          cannot be reused without showing up in the peak. The peak is scoped to the setup by
+///          resetting the high water mark (/proc/self/clear_refs) right before it; where that
+///          is unavailable, the process-wide getrusage peak is reported instead.
+///          Usage: amgcl_setup_memory_benchmark <wrapper|adapter> [points per edge = 100]
+
+// --- UtilityApp Includes ---
+#include "UtilityApp/AMGCLWrapper.hpp"
+
+// --- Core Includes ---
+#include "spaces/ublas_space.h"
+#include "utilities/parallel_utilities.h"
+#include "utilities/builtin_timer.h"
+
+// --- External Includes ---
+#include "amgcl/adapter/ublas.hpp"
+#include "amgcl/backend/builtin.hpp"
+#include "amgcl/make_solver.hpp"
+#include "amgcl/solver/runtime.hpp"
+#include "amgcl/preconditioner/runtime.hpp"
+#include "boost/property_tree/ptree.hpp"
+#include "boost/property_tree/json_parser.hpp"
+
+// --- STL Includes ---
+#include <iostream> // cerr, cout
+#include <fstream> // ifstream, ofstream
+#include <sstream> // stringstream
+#include <memory> // make_shared
+#include <string> // string, stoul
+#include <string_view> // string_view
+#include <optional> // optional
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h> // getrusage
+#endif
+
+
+namespace Kratos::UtilityApp {
+
+
+using SparseSpace = TUblasSparseSpace<double>;
+
+using DenseSpace = TUblasDenseSpace<double>;
+
+
+/// @brief Value of a "<Key>: <value> kB" entry in /proc/self/status in bytes, if present.
+std::optional<std::size_t> ReadProcessStatus(std::string_view Key)
+{
+    std::ifstream file("/proc/self/status");
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.size() > Key.size() && std::string_view(line).substr(0, Key.size()) == Key && line[Key.size()] == ':') {
+            return std::stoul(line.substr(Key.size() + 1)) * 1024;
+        }
+    }
+    return {};
+}
+
+
+/// @brief Peak resident set size of the process since the last @ref Reset, in bytes.
+struct PeakMemory
+{
+    /// @brief Reset the high water mark to the current resident set size.
+    /// @return False if the high water mark cannot be reset, in which case
+    ///         @ref Get reports the peak since the process started.
+    static bool Reset()
+    {
+        std::ofstream file("/proc/self/clear_refs");
+        file << "5";
+        file.flush();
+        return file.good() && ReadProcessStatus("VmHWM").has_value();
+    }
+
+    static std::size_t Get()
+    {
+        if (const auto maybe_peak = ReadProcessStatus("VmHWM"); maybe_peak.has_value()) {
+            return maybe_peak.value();
+        }
+
+        #if defined(__unix__) || defined(__APPLE__)
+            rusage usage;
+            if (getrusage(RUSAGE_SELF, &usage) == 0) {
+                #ifdef __APPLE__
+                    return static_cast<std::size_t>(usage.ru_maxrss);
+                #else
+                    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+                #endif
+            }
+        #endif
+        return 0;
+    }
+
+    static std::size_t GetCurrent()
+    {
+        return ReadProcessStatus("VmRSS").value_or(0);
+    }
+}; // struct PeakMemory
+
+
+constexpr char Settings[] = R"({
+    "precond" : {
+        "class" : "amg",
+        "relax" : {"type" : "spai0"},
+        "coarsening" : {"type" : "smoothed_aggregation"}
+    },
+    "solver" : {
+        "type" : "cg",
+        "maxiter" : 1000,
+        "tol" : 1e-8
+    }
+})";
+
+
+/// @brief Construct the hierarchy the way @ref AMGCLWrapper did before it built its matrix from the ublas arrays.
+void SetupAdapter(const SparseSpace::MatrixType& rA)
+{
+    using Backend = amgcl::backend::builtin<double>;
+    using Solver = amgcl::make_solver<amgcl::runtime::preconditioner<Backend>,
+                                      amgcl::runtime::solver::wrapper<Backend>>;
+
+    boost::property_tree::ptree settings;
+    {
+        std::stringstream stream(Settings);
+        boost::property_tree::read_json(stream, settings);
+    }
+
+    auto p_adapter = std::make_shared<amgcl::backend::crs<double>>(amgcl::backend::map(rA));
+    Solver solver(*p_adapter, settings);
+}
+
+
+/// @brief Construct the hierarchy in @ref AMGCLWrapper::InitializeSolutionStep.
+void SetupWrapper(SparseSpace::MatrixType& rA, SparseSpace::VectorType& rB)
+{
+    Parameters settings(R"({
+        "solver_type" : "amgcl_wrapper",
+        "verbosity" : 0
+    })");
+    settings.AddValue("amgcl_settings", Parameters(Settings));
+
+    AMGCLWrapper<SparseSpace,DenseSpace> solver(settings);
+    SparseSpace::VectorType x(rB.size(), 0.0);
+    solver.InitializeSolutionStep(rA, x, rB);
+}
+
+
+int main(int argc, const char** argv)
+{
+    if (argc < 2 || 3 < argc || (std::string_view(argv[1]) != "wrapper" && std::string_view(argv[1]) != "adapter")) {
+        std::cerr << "Usage: amgcl_setup_memory_benchmark <wrapper|adapter> [points per edge = 100]\n";
+        return 1;
+    }
+    const bool use_wrapper = std::string_view(argv[1]) == "wrapper";
+
+    std::size_t edge_size = 100;
+    try {
+        if (2 < argc) edge_size = std::stoul(argv[2]);
+    } catch (...) {
+        std::cerr << "invalid number of points per edge\n";
+        return 1;
+    }
+
+    // Assemble the system, keeping Dirichlet boundaries as identity rows.
+    const std::size_t system_size = edge_size * edge_size * edge_size;
+    SparseSpace::MatrixType A(system_size, system_size, 7 * system_size);
+    SparseSpace::VectorType b(system_size);
+    const double h2i = static_cast<double>((edge_size - 1) * (edge_size - 1));
+    const std::size_t stride_j = edge_size, stride_k = edge_size * edge_size;
+
+    for (std::size_t i_row=0; i_row<system_size; ++i_row) {
+        const std::size_t i = i_row % edge_size;
+        const std::size_t j = (i_row / edge_size) % edge_size;
+        const std::size_t k = i_row / (edge_size * edge_size);
+        if (i == 0 || i == edge_size - 1 || j == 0 || j == edge_size - 1 || k == 0 || k == edge_size - 1) {
+            A.push_back(i_row, i_row, 1.0);
+            b[i_row] = 0.0;
+        } else {
+            A.push_back(i_row, i_row - stride_k, -h2i);
+            A.push_back(i_row, i_row - stride_j, -h2i);
+            A.push_back(i_row, i_row - 1, -h2i);
+            A.push_back(i_row, i_row, 6.0 * h2i);
+            A.push_back(i_row, i_row + 1, -h2i);
+            A.push_back(i_row, i_row + stride_j, -h2i);
+            A.push_back(i_row, i_row + stride_k, -h2i);
+            b[i_row] = 1.0;
+        }
+    }
+    A.complete_index1_data();
+
+    const std::size_t matrix_size = A.nnz() * (sizeof(double) + sizeof(std::size_t))
+                                    + (A.size1() + 1) * sizeof(std::size_t);
+
+    const bool is_scoped = PeakMemory::Reset();
+    const std::size_t baseline = is_scoped ? PeakMemory::GetCurrent() : PeakMemory::Get();
+    double setup_time = 0.0;
+
+    try {
+        BuiltinTimer timer;
+        if (use_wrapper) SetupWrapper(A, b);
+        else SetupAdapter(A);
+        setup_time = timer.ElapsedSeconds();
+    } catch (std::exception& rException) {
+        std::cerr << rException.what() << "\n";
+        return 1;
+    }
+
+    const std::size_t peak = PeakMemory::Get();
+    const double peak_increase = (baseline < peak ? peak - baseline : 0) / double(1 << 20);
+
+    std::cout << "path               : " << argv[1] << "\n"
+              << "threads            : " << ParallelUtilities::GetNumThreads() << "\n"
+              << "unknowns           : " << system_size << "\n"
+              << "system matrix [MB] : " << matrix_size / double(1 << 20) << "\n"
+              << "setup [s]          : " << setup_time << "\n"
+              << "setup peak [MB]    : " << peak_increase
+              << (is_scoped ? "\n" : " (process-wide peak, the high water mark could not be reset)\n");
+
+    return 0;
+} // int main
+
+
+} // namespace Kratos::UtilityApp
+
+
+int main(int argc, const char** argv)
+{
+    return Kratos::UtilityApp::main(argc, argv);
+} // int main
@@ -0,0 +1,169 @@
+/// @author Máté Kelemen
+/// @details Compare the compile-time and runtime configured solvers of @ref Kratos::AMGCLWrapper
+///          on the same system read from a MatrixMarket file.
+///          Usage: amgcl_static_dispatch_benchmark <matrix.mtx> [block size = 3] [repetitions = 5]
+///                                                 [coarsening = smoothed_aggregation] [relaxation = ilu0]
+
+// --- External Includes ---
+#include "amgcl/io/mm.hpp"
+
+// --- UtilityApp Includes ---
+#include "UtilityApp/AMGCLWrapper.hpp"
+
+// --- Core Includes ---
+#include "spaces/ublas_space.h"
+
+// --- STL Includes ---
+#include <iostream> // cerr, cout
+#include <filesystem> // path, exists
+#include <vector> // vector
+#include <string> // string, stoul
+#include <algorithm> // min_element, copy
+#include <limits> // numeric_limits
+#include <tuple> // get
+
+
+namespace Kratos::UtilityApp {
+
+
+using SparseSpace = TUblasSparseSpace<double>;
+
+using DenseSpace = TUblasDenseSpace<double>;
+
+
+struct BenchmarkResult
+{
+    double mSetupTime = std::numeric_limits<double>::max();
+
+    double mSolveTime = std::numeric_limits<double>::max();
+
+    std::size_t mIterationCount = 0;
+
+    double mResidual = 0.0;
+}; // struct BenchmarkResult
+
+
+BenchmarkResult Run(SparseSpace::MatrixType& rA,
+                    const SparseSpace::VectorType& rB,
+                    std::size_t BlockSize,
+                    std::size_t RepetitionCount,
+                    const std::string& rCoarsening,
+                    const std::string& rRelaxation,
+                    bool StaticDispatch)
+{
+    Parameters settings(R"({
+        "solver_type" : "amgcl_wrapper",
+        "verbosity" : 0,
+        "amgcl_settings" : {
+            "precond" : {
+                "class" : "amg",
+                "relax" : {},
+                "coarsening" : {},
+                "coarse_enough" : 500,
+                "npre" : 1,
+                "npost" : 1
+            },
+            "solver" : {
+                "type" : "cg",
+                "maxiter" : 1000,
+                "tol" : 1e-8
+            }
+        }
+    })");
+    settings.AddInt("block_size", BlockSize);
+    settings.AddInt("statistics_history", RepetitionCount);
+    settings.AddBool("static_dispatch", StaticDispatch);
+    settings["amgcl_settings"]["precond"]["relax"].AddString("type", rRelaxation);
+    settings["amgcl_settings"]["precond"]["coarsening"].AddString("type", rCoarsening);
+
+    AMGCLWrapper<SparseSpace,DenseSpace> solver(settings);
+    for (std::size_t i_repetition=0; i_repetition<RepetitionCount; ++i_repetition) {
+        SparseSpace::VectorType x(rB.size(), 0.0), b = rB;
+        solver.Solve(rA, x, b);
+    }
+
+    // Report the fastest repetition to filter out noise.
+    BenchmarkResult result;
+    for (const auto& r_statistics : solver.GetStatistics()) {
+        result.mSetupTime = std::min(result.mSetupTime, r_statistics.mSetupTime);
+        result.mSolveTime = std::min(result.mSolveTime, r_statistics.mSolveTime);
+        result.mIterationCount = r_statistics.mIterationCount;
+        result.mResidual = r_statistics.mResidual;
+    }
+    return result;
+}
+
+
+int main(int argc, const char** argv)
+{
+    if (argc < 2) {
+        std::cerr << "missing argument for input matrix\n";
+        return 1;
+    }
+
+    const std::filesystem::path matrix_path(argv[1]);
+    if (!std::filesystem::exists(matrix_path)) {
+        std::cerr << "File not found: " << matrix_path << "\n";
+        return 1;
+    }
+
+    std::size_t block_size = 3, repetition_count = 5;
+    try {
+        if (2 < argc) block_size = std::stoul(argv[2]);
+        if (3 < argc) repetition_count = std::stoul(argv[3]);
+    } catch (...) {
+        std::cerr << "invalid block size or repetition count\n";
+        return 1;
+    }
+    const std::string coarsening = 4 < argc ? argv[4] : "smoothed_aggregation";
+    const std::string relaxation = 5 < argc ? argv[5] : "ilu0";
+
+    // Read the matrix and convert it to a ublas matrix.
+    SparseSpace::MatrixType A;
+    {
+        std::vector<std::ptrdiff_t> row_extents, column_indices;
+        std::vector<double> values;
+        amgcl::io::mm_reader reader(matrix_path.string());
+        if (reader.rows() != reader.cols()) {
+            std::cerr << "expecting a square matrix, but got " << reader.rows() << "x" << reader.cols() << "\n";
+            return 1;
+        }
+        const std::size_t size = std::get<0>(reader(row_extents, column_indices, values));
+
+        A = SparseSpace::MatrixType(size, size, values.size());
+        std::copy(row_extents.begin(), row_extents.end(), A.index1_data().begin());
+        std::copy(column_indices.begin(), column_indices.end(), A.index2_data().begin());
+        std::copy(values.begin(), values.end(), A.value_data().begin());
+        A.set_filled(size + 1, values.size());
+    }
+    const SparseSpace::VectorType b(A.size1(), 1.0);
+
+    const auto runtime = Run(A, b, block_size, repetition_count, coarsening, relaxation, false);
+    const auto compiled = Run(A, b, block_size, repetition_count, coarsening, relaxation, true);
+
+    std::cout << "configuration : " << coarsening << " + " << relaxation << " + cg, block size " << block_size << "\n"
+              << "unknowns      : " << A.size1() << "\n"
+              << "nonzeros      : " << A.nnz() << "\n"
+              << "              \truntime\tstatic\tspeedup\n"
+              << "setup [s]     \t" << runtime.mSetupTime << "\t" << compiled.mSetupTime << "\t" << runtime.mSetupTime / compiled.mSetupTime << "\n"
+              << "solve [s]     \t" << runtime.mSolveTime << "\t" << compiled.mSolveTime << "\t" << runtime.mSolveTime / compiled.mSolveTime << "\n"
+              << "iterations    \t" << runtime.mIterationCount << "\t" << compiled.mIterationCount << "\n"
+              << "residual      \t" << runtime.mResidual << "\t" << compiled.mResidual << "\n";
+
+    // Both paths must produce the same solver.
+    if (runtime.mIterationCount != compiled.mIterationCount) {
+        std::cerr << "iteration counts differ between the runtime and static paths\n";
+        return 1;
+    }
+
+    return 0;
+} // int main
+
+
+} // namespace Kratos::UtilityApp
+
+
+int main(int argc, const char** argv)
+{
+    return Kratos::UtilityApp::main(argc, argv);
+} // int main
@@ -0,0 +1,177 @@
+/// @author Máté Kelemen
+/// @details Emulate a time loop that moves the nodes of a model part and writes it to a new
+///          file every step (sync_<step><ext> and async_<step><ext>), once writing directly and once
+///          through @ref Kratos::UtilityApp::AsyncModelPartIO, then report how long the loop was
+///          blocked by writing.
+///          Usage: async_write_benchmark <path to input> <output directory> <output extension> [steps = 10]
+
+// --- Utility Includes ---
+#include "UtilityApp/ModelPartIO.hpp"
+
+// --- Core Includes ---
+#include "containers/model.h"
+#include "includes/kratos_application.h"
+#include "utilities/parallel_utilities.h"
+#include "utilities/builtin_timer.h"
+
+// --- STL Includes ---
+#include <iostream> // cerr, cout
+#include <filesystem> // path, exists, is_directory, remove
+#include <memory> // unique_ptr
+#include <vector> // vector
+#include <string> // string, stoul, to_string
+#include <cmath> // sin
+
+
+namespace Kratos::UtilityApp {
+
+
+struct LoopTimes
+{
+    // Time spent in Write (and the final Flush).
+    double mBlocked = 0.0;
+
+    double mTotal = 0.0;
+}; // struct LoopTimes
+
+
+/// @brief IO writing each model part it gets to a new file <prefix>_<index><extension>.
+/// @details Some formats (HDF5) refuse to overwrite existing files, so each step goes to its own
+///          file, and files left over from earlier runs are removed first.
+class SteppedModelPartIO final : public ModelPartIO
+{
+public:
+    SteppedModelPartIO(RightRef<std::filesystem::path> rPrefix, RightRef<std::string> rExtension)
+        : mPrefix(std::move(rPrefix)),
+          mExtension(std::move(rExtension))
+    {
+    }
+
+    void Read(Ref<ModelPart>) const override
+    {
+        KRATOS_ERROR << "SteppedModelPartIO is write-only\n";
+    }
+
+    void Write(Ref<const ModelPart> rSource) override
+    {
+        std::filesystem::path file_path = mPrefix;
+        file_path += "_" + std::to_string(mIndex++) + mExtension;
+        std::filesystem::remove(file_path);
+        IOFactory(file_path)->Write(rSource);
+    }
+
+private:
+    std::filesystem::path mPrefix;
+
+    std::string mExtension;
+
+    std::size_t mIndex = 0;
+}; // class SteppedModelPartIO
+
+
+/// @brief Run the time loop, writing each step with @p pIO, which is destroyed at the end.
+LoopTimes RunLoop(ModelPart& rModelPart,
+                  std::size_t StepCount,
+                  std::unique_ptr<ModelPartIO>&& pIO)
+{
+    LoopTimes times;
+    BuiltinTimer total_timer;
+
+    for (std::size_t i_step=0; i_step<StepCount; ++i_step) {
+        // Stand-in for the solution step.
+        const double time = static_cast<double>(i_step + 1);
+        IndexPartition<std::size_t>(rModelPart.NumberOfNodes()).for_each([&rModelPart, time](std::size_t i_node) {
+            auto& r_node = *(rModelPart.NodesBegin() + i_node);
+            r_node.X() = r_node.X0() + 1e-3 * std::sin(time + r_node.Y0());
+            r_node.Y() = r_node.Y0() + 1e-3 * std::sin(time + r_node.Z0());
+            r_node.Z() = r_node.Z0() + 1e-3 * std::sin(time + r_node.X0());
+        });
+
+        BuiltinTimer timer;
+        pIO->Write(rModelPart);
+        times.mBlocked += timer.ElapsedSeconds();
+    }
+
+    {
+        BuiltinTimer timer;
+        if (auto p_async = dynamic_cast<AsyncModelPartIO*>(pIO.get())) p_async->Flush();
+        pIO.reset();
+        times.mBlocked += timer.ElapsedSeconds();
+    }
+
+    times.mTotal = total_timer.ElapsedSeconds();
+    return times;
+}
+
+
+int main(int argc, const char** argv)
+{
+    if (argc < 4 || 5 < argc) {
+        std::cerr << "Usage: async_write_benchmark <path to input> <output directory> <output extension> [steps = 10]\n";
+        return 1;
+    }
+
+    const std::filesystem::path input_path(argv[1]), output_directory(argv[2]);
+    std::string extension(argv[3]);
+    if (!extension.empty() && extension.front() != '.') extension = "." + extension;
+
+    if (!std::filesystem::exists(input_path)) {
+        std::cerr << "File not found: " << input_path << "\n";
+        return 1;
+    }
+    if (!std::filesystem::is_directory(output_directory)) {
+        std::cerr << "not an existing directory: " << output_directory << "\n";
+        return 1;
+    }
+
+    std::size_t step_count = 10;
+    try {
+        if (4 < argc) step_count = std::stoul(argv[4]);
+    } catch (...) {
+        std::cerr << "invalid number of steps\n";
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<KratosApplication>> applications;
+    applications.emplace_back(new KratosApplication("KratosCore"));
+    for (const auto& rp_application : applications) {
+        rp_application->Register();
+    }
+
+    Model model;
+    ModelPart& r_model_part = model.CreateModelPart("root");
+
+    LoopTimes sync_times, async_times;
+    try {
+        IOFactory(input_path)->Read(r_model_part);
+
+        sync_times = RunLoop(r_model_part,
+                             step_count,
+                             std::unique_ptr<ModelPartIO>(new SteppedModelPartIO(output_directory / "sync", std::string(extension))));
+        async_times = RunLoop(r_model_part,
+                              step_count,
+                              std::unique_ptr<ModelPartIO>(new AsyncModelPartIO(
+                                  std::unique_ptr<ModelPartIO>(new SteppedModelPartIO(output_directory / "async", std::string(extension))))));
+    } catch (std::exception& rException) {
+        std::cerr << rException.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "file        : " << input_path << "\n"
+              << "threads     : " << ParallelUtilities::GetNumThreads() << "\n"
+              << "steps       : " << step_count << "\n"
+              << "\tblocked [s]\ttotal [s]\n"
+              << "sync\t" << sync_times.mBlocked << "\t" << sync_times.mTotal << "\n"
+              << "async\t" << async_times.mBlocked << "\t" << async_times.mTotal << "\n";
+
+    return 0;
+} // int main
+
+
+} // namespace Kratos::UtilityApp
+
+
+int main(int argc, const char** argv)
+{
+    return Kratos::UtilityApp::main(argc, argv);
+} // int main
@@ -0,0 +1,152 @@
+/// @author Máté Kelemen
+/// @details Round trip test of @ref Kratos::UtilityApp::WriteCollectiveHDF5 and
+///          @ref Kratos::UtilityApp::ReadCollectiveHDF5 on a single shared file.
+///          1) Rank 0 writes the input model part into <output directory>/serial.h5.
+///          2) All ranks read it back, repartitioning it over the MPI ranks.
+///          3) All ranks write their partitions into <output directory>/collective.h5 collectively.
+///          4) Rank 0 reads collective.h5 on its own and compares it to the input model part.
+///          Usage: mpirun -np 4 hdf5_collective_roundtrip <input model part> <output directory> [compression level = 0]
+
+// --- Utility Includes ---
+#include "UtilityApp/CollectiveHDF5.hpp"
+#include "UtilityApp/ModelPartIO.hpp"
+#include "ModelPartComparison.hpp"
+
+// --- Core Includes ---
+#include "containers/model.h"
+#include "includes/kratos_application.h"
+#include "includes/parallel_environment.h"
+#include "includes/variables.h"
+#include "utilities/builtin_timer.h"
+
+// --- Structural Mechanics Includes ---
+#include "structural_mechanics_application.h"
+
+#ifdef KRATOS_USING_MPI
+#include "mpi/includes/mpi_manager.h"
+#include "mpi/utilities/parallel_fill_communicator.h"
+#endif
+
+// --- STL Includes ---
+#include <iostream> // cerr, cout
+#include <filesystem> // path, exists, is_directory, remove
+#include <memory> // unique_ptr
+#include <vector> // vector
+#include <string> // string, stoi
+
+
+namespace Kratos::UtilityApp {
+
+
+int main(int argc, const char** argv)
+{
+    #ifdef KRATOS_USING_MPI
+    ParallelEnvironment::SetUpMPIEnvironment(MPIManager::Create());
+    const DataCommunicator& r_world = ParallelEnvironment::GetDataCommunicator("World");
+    const DataCommunicator& r_serial = ParallelEnvironment::GetDataCommunicator("Serial");
+    const int rank = r_world.Rank();
+
+    if (argc < 3 || 4 < argc) {
+        if (!rank) std::cerr << "Usage: mpirun -np <ranks> hdf5_collective_roundtrip <input model part> <output directory> [compression level = 0]\n";
+        return 1;
+    }
+
+    const std::filesystem::path input_path(argv[1]), output_directory(argv[2]);
+    if (!std::filesystem::exists(input_path) || !std::filesystem::is_directory(output_directory)) {
+        if (!rank) std::cerr << "missing input file " << input_path << " or output directory " << output_directory << "\n";
+        return 1;
+    }
+
+    CollectiveHDF5Settings settings;
+    try {
+        if (3 < argc) settings.mCompressionLevel = std::stoi(argv[3]);
+    } catch (...) {
+        if (!rank) std::cerr << "invalid compression level: " << argv[3] << "\n";
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<KratosApplication>> applications;
+    applications.emplace_back(new KratosApplication("KratosCore"));
+    applications.emplace_back(new KratosStructuralMechanicsApplication);
+    for (const auto& rp_application : applications) {
+        rp_application->Register();
+    }
+
+    Model model;
+    ModelPart& r_reference = model.CreateModelPart("reference");
+    IOFactory(input_path)->Read(r_reference);
+
+    // 1) Serial write
+    const std::filesystem::path serial_path = output_directory / "serial.h5";
+    const std::filesystem::path collective_path = output_directory / "collective.h5";
+    if (!rank) {
+        std::filesystem::remove(serial_path);
+        std::filesystem::remove(collective_path);
+        WriteCollectiveHDF5(serial_path, r_reference, r_serial, settings);
+    }
+    r_world.Barrier();
+
+    // 2) Repartitioning read
+    ModelPart& r_distributed = model.CreateModelPart("distributed");
+    r_distributed.AddNodalSolutionStepVariable(PARTITION_INDEX);
+    BuiltinTimer read_timer;
+    ReadCollectiveHDF5(serial_path, r_distributed, r_world, settings);
+    const double read_time = r_world.MaxAll(read_timer.ElapsedSeconds());
+    ParallelFillCommunicator(r_distributed, r_world).Execute();
+
+    const std::size_t element_count = r_world.SumAll(r_distributed.NumberOfElements());
+    const std::size_t condition_count = r_world.SumAll(r_distributed.NumberOfConditions());
+    const std::size_t node_count = r_world.SumAll(r_distributed.GetCommunicator().LocalMesh().NumberOfNodes());
+    if (element_count != r_reference.NumberOfElements()
+        || condition_count != r_reference.NumberOfConditions()
+        || node_count != r_reference.NumberOfNodes()) {
+        if (!rank) std::cerr << "the repartitioned model part has "
+                             << node_count << " nodes, " << element_count << " elements and " << condition_count << " conditions "
+                             << "instead of " << r_reference.NumberOfNodes() << ", " << r_reference.NumberOfElements()
+                             << " and " << r_reference.NumberOfConditions() << "\n";
+        return 1;
+    }
+
+    // 3) Collective write
+    BuiltinTimer write_timer;
+    WriteCollectiveHDF5(collective_path, r_distributed, r_world, settings);
+    const double write_time = r_world.MaxAll(write_timer.ElapsedSeconds());
+
+    // 4) Serial read and comparison
+    int status = 0;
+    if (!rank) {
+        ModelPart& r_roundtrip = model.CreateModelPart("roundtrip");
+        ReadCollectiveHDF5(collective_path, r_roundtrip, r_serial, settings);
+        // Geometries are not part of the format.
+        ComparedContents contents;
+        contents.mGeometries = false;
+        const std::string difference = Compare(r_reference, r_roundtrip, contents);
+        if (!difference.empty()) {
+            std::cerr << "model parts differ after the round trip: " << difference << "\n";
+            status = 1;
+        } else {
+            std::cout << "ranks            : " << r_world.Size() << "\n"
+                      << "nodes            : " << node_count << "\n"
+                      << "elements         : " << element_count << "\n"
+                      << "conditions       : " << condition_count << "\n"
+                      << "file size        : " << std::filesystem::file_size(collective_path) << " [B]\n"
+                      << "collective read  : " << read_time << " [s]\n"
+                      << "collective write : " << write_time << " [s]\n";
+        }
+    }
+
+    return r_world.MaxAll(status);
+    #else
+    std::cerr << "hdf5_collective_roundtrip requires compiling with MPI support\n";
+    return 1;
+    #endif
+} // int main
+
+
+} // namespace Kratos::UtilityApp
+
+
+int main(int argc, const char** argv)
+{
+    return Kratos::UtilityApp::main(argc, argv);
+} // int main
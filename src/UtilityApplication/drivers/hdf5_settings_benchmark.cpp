@@ -0,0 +1,154 @@
+/// @author Máté Kelemen
+/// @details Write a model part with @ref Kratos::UtilityApp::WriteCollectiveHDF5 using various chunk
+///          sizes and compression filters, and report the file size, the write time, the time it takes
+///          to read the whole mesh, and the time it takes to read only the nodes and elements (all
+///          a mesh topology check like find_hanging_nodes needs). Filters the HDF5 library was built
+///          without are skipped.
+///          Usage: hdf5_settings_benchmark <input model part> <output directory> [repetitions = 3]
+
+// --- Utility Includes ---
+#include "UtilityApp/CollectiveHDF5.hpp"
+#include "UtilityApp/ModelPartIO.hpp"
+
+// --- Core Includes ---
+#include "containers/model.h"
+#include "includes/kratos_application.h"
+#include "includes/parallel_environment.h"
+#include "utilities/builtin_timer.h"
+
+// --- Structural Mechanics Includes ---
+#include "structural_mechanics_application.h"
+
+// --- STL Includes ---
+#include <iostream> // cerr, cout
+#include <filesystem> // path, exists, is_directory, remove, file_size
+#include <memory> // unique_ptr
+#include <vector> // vector
+#include <string> // string, stoul
+#include <tuple> // tuple
+#include <algorithm> // min
+#include <limits> // numeric_limits
+
+
+namespace Kratos::UtilityApp {
+
+
+int main(int argc, const char** argv)
+{
+    if (argc < 3 || 4 < argc) {
+        std::cerr << "Usage: hdf5_settings_benchmark <input model part> <output directory> [repetitions = 3]\n";
+        return 1;
+    }
+
+    const std::filesystem::path input_path(argv[1]), output_directory(argv[2]);
+    if (!std::filesystem::exists(input_path) || !std::filesystem::is_directory(output_directory)) {
+        std::cerr << "missing input file " << input_path << " or output directory " << output_directory << "\n";
+        return 1;
+    }
+
+    std::size_t repetition_count = 3;
+    try {
+        if (3 < argc) repetition_count = std::stoul(argv[3]);
+    } catch (...) {
+        std::cerr << "invalid number of repetitions\n";
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<KratosApplication>> applications;
+    applications.emplace_back(new KratosApplication("KratosCore"));
+    applications.emplace_back(new KratosStructuralMechanicsApplication);
+    for (const auto& rp_application : applications) {
+        rp_application->Register();
+    }
+
+    Model model;
+    ModelPart& r_source = model.CreateModelPart("source");
+    IOFactory(input_path)->Read(r_source);
+    const DataCommunicator& r_serial = ParallelEnvironment::GetDataCommunicator("Serial");
+
+    const std::vector<std::tuple<std::string,HDF5Filter,int>> filters {{"none", HDF5Filter::None, 0},
+                                                                       {"deflate", HDF5Filter::Deflate, 1},
+                                                                       {"deflate", HDF5Filter::Deflate, 6},
+                                                                       {"deflate", HDF5Filter::Deflate, 9},
+                                                                       {"zstd", HDF5Filter::Zstd, 3},
+                                                                       {"zstd", HDF5Filter::Zstd, 19},
+                                                                       {"szip", HDF5Filter::Szip, 16}};
+    const std::vector<std::size_t> chunk_sizes {std::size_t(1) << 16, std::size_t(1) << 20, std::size_t(1) << 23};
+
+    const std::filesystem::path output_path = output_directory / "benchmark.h5";
+    std::cout << "nodes      : " << r_source.NumberOfNodes() << "\n"
+              << "elements   : " << r_source.NumberOfElements() << "\n"
+              << "conditions : " << r_source.NumberOfConditions() << "\n"
+              << "filter\tlevel\tchunk [B]\tsize [B]\twrite [s]\tread [s]\tread elements [s]\n";
+
+    for (const auto& [filter_name, filter, level] : filters) {
+        if (!IsHDF5FilterAvailable(filter)) {
+            std::cout << filter_name << "\t" << level << "\tunavailable\n";
+            continue;
+        }
+
+        for (std::size_t chunk_size : chunk_sizes) {
+            CollectiveHDF5Settings settings;
+            settings.mFilter = filter;
+            settings.mCompressionLevel = level;
+            settings.mChunkSize = chunk_size;
+
+            CollectiveHDF5Settings element_settings = settings;
+            element_settings.mEntityTypes = {"Elements"};
+
+            double write_time = std::numeric_limits<double>::max();
+            double read_time = std::numeric_limits<double>::max();
+            double element_read_time = std::numeric_limits<double>::max();
+            for (std::size_t i_repetition=0; i_repetition<repetition_count; ++i_repetition) {
+                {
+                    std::filesystem::remove(output_path);
+                    BuiltinTimer timer;
+                    WriteCollectiveHDF5(output_path, r_source, r_serial, settings);
+                    write_time = std::min(write_time, timer.ElapsedSeconds());
+                }
+
+                {
+                    Model read_model;
+                    ModelPart& r_target = read_model.CreateModelPart("target");
+                    BuiltinTimer timer;
+                    ReadCollectiveHDF5(output_path, r_target, r_serial, settings);
+                    read_time = std::min(read_time, timer.ElapsedSeconds());
+                    if (r_target.NumberOfNodes() != r_source.NumberOfNodes()
+                        || r_target.NumberOfElements() != r_source.NumberOfElements()
+                        || r_target.NumberOfConditions() != r_source.NumberOfConditions()) {
+                        std::cerr << "the model part read with " << filter_name << " (" << level << ") differs from the input\n";
+                        return 1;
+                    }
+                }
+
+                {
+                    Model read_model;
+                    ModelPart& r_target = read_model.CreateModelPart("target");
+                    BuiltinTimer timer;
+                    ReadCollectiveHDF5(output_path, r_target, r_serial, element_settings);
+                    element_read_time = std::min(element_read_time, timer.ElapsedSeconds());
+                }
+            }
+
+            std::cout << filter_name << "\t"
+                      << level << "\t"
+                      << chunk_size << "\t"
+                      << std::filesystem::file_size(output_path) << "\t"
+                      << write_time << "\t"
+                      << read_time << "\t"
+                      << element_read_time << "\n";
+        } // for chunk_size in chunk_sizes
+    } // for filter_name, filter, level in filters
+
+    std::filesystem::remove(output_path);
+    return 0;
+} // int main
+
+
+} // namespace Kratos::UtilityApp
+
+
+int main(int argc, const char** argv)
+{
+    return Kratos::UtilityApp::main(argc, argv);
+} // int main
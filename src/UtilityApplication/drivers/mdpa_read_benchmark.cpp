@@ -0,0 +1,112 @@
+/// @author Máté Kelemen
+/// @details Read an MDPA file with the sequential @ref Kratos::ModelPartIO and with
+///          @ref Kratos::UtilityApp::ReadMDPA, check that both produce identical model parts
+///          and report the read times. Meant to be run on the pmg_cube meshes
+///          (cases/pmg_cube/meshes/meshes.tar.gz).
+///          Usage: mdpa_read_benchmark <path to mdpa> [repetitions = 3]
+
+// --- Utility Includes ---
+#include "UtilityApp/ParallelMDPA.hpp"
+#include "ModelPartComparison.hpp"
+
+// --- Core Includes ---
+#include "containers/model.h"
+#include "includes/model_part_io.h"
+#include "includes/kratos_application.h"
+#include "utilities/parallel_utilities.h"
+#include "utilities/builtin_timer.h"
+
+// --- Structural Mechanics Includes ---
+#include "structural_mechanics_application.h"
+
+// --- STL Includes ---
+#include <iostream> // cerr, cout
+#include <filesystem> // path, exists
+#include <memory> // unique_ptr
+#include <vector> // vector
+#include <string> // string, stoul
+#include <algorithm> // min
+#include <limits> // numeric_limits
+
+
+namespace Kratos::UtilityApp {
+
+
+int main(int argc, const char** argv)
+{
+    if (argc < 2 || 3 < argc) {
+        std::cerr << "Usage: mdpa_read_benchmark <path to mdpa> [repetitions = 3]\n";
+        return 1;
+    }
+
+    const std::filesystem::path file_path(argv[1]);
+    if (!std::filesystem::exists(file_path) || file_path.extension() != ".mdpa") {
+        std::cerr << "not an existing mdpa file: " << file_path << "\n";
+        return 1;
+    }
+
+    std::size_t repetition_count = 3;
+    try {
+        if (2 < argc) repetition_count = std::stoul(argv[2]);
+    } catch (...) {
+        std::cerr << "invalid number of repetitions\n";
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<KratosApplication>> applications;
+    applications.emplace_back(new KratosApplication("KratosCore"));
+    applications.emplace_back(new KratosStructuralMechanicsApplication);
+    for (const auto& rp_application : applications) {
+        rp_application->Register();
+    }
+
+    std::filesystem::path stem = file_path;
+    stem.replace_extension("");
+
+    double sequential_time = std::numeric_limits<double>::max();
+    double parallel_time = std::numeric_limits<double>::max();
+    for (std::size_t i_repetition=0; i_repetition<repetition_count; ++i_repetition) {
+        Model model;
+        ModelPart& r_sequential = model.CreateModelPart("sequential");
+        ModelPart& r_parallel = model.CreateModelPart("parallel");
+
+        {
+            BuiltinTimer timer;
+            Kratos::ModelPartIO(stem, IO::READ).ReadModelPart(r_sequential);
+            sequential_time = std::min(sequential_time, timer.ElapsedSeconds());
+        }
+
+        {
+            BuiltinTimer timer;
+            if (!ReadMDPA(file_path, r_parallel)) {
+                std::cerr << file_path << " has blocks the parallel reader does not support\n";
+                return 1;
+            }
+            parallel_time = std::min(parallel_time, timer.ElapsedSeconds());
+        }
+
+        if (!i_repetition) {
+            const std::string difference = Compare(r_sequential, r_parallel);
+            if (!difference.empty()) {
+                std::cerr << "model parts differ: " << difference << "\n";
+                return 1;
+            }
+        }
+    }
+
+    std::cout << "file        : " << file_path << "\n"
+              << "threads     : " << ParallelUtilities::GetNumThreads() << "\n"
+              << "\tsequential [s]\tparallel [s]\tspeedup\n"
+              << "read\t" << sequential_time << "\t" << parallel_time << "\t" << sequential_time / parallel_time << "\n";
+
+    return 0;
+} // int main
+
+
+} // namespace Kratos::UtilityApp
+
+
+int main(int argc, const char** argv)
+{
+    return Kratos::UtilityApp::main(argc, argv);
+} // int main
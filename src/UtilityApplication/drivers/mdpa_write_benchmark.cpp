@@ -0,0 +1,129 @@
+/// @author Máté Kelemen
+/// @details Write a model part with the sequential @ref Kratos::ModelPartIO and with
+///          @ref Kratos::UtilityApp::WriteMDPA, check that the two files are identical
+///          byte for byte and report the write times.
+///          Usage: mdpa_write_benchmark <path to input mdpa> <output directory> [repetitions = 3]
+
+// --- Utility Includes ---
+#include "UtilityApp/ParallelMDPA.hpp"
+#include "UtilityApp/ModelPartIO.hpp"
+#include "UtilityApp/MappedFile.hpp"
+
+// --- Core Includes ---
+#include "containers/model.h"
+#include "includes/model_part_io.h"
+#include "includes/kratos_application.h"
+#include "utilities/parallel_utilities.h"
+#include "utilities/builtin_timer.h"
+
+// --- Structural Mechanics Includes ---
+#include "structural_mechanics_application.h"
+
+// --- STL Includes ---
+#include <iostream> // cerr, cout
+#include <filesystem> // path, exists, is_directory
+#include <memory> // unique_ptr
+#include <vector> // vector
+#include <string> // string, stoul
+#include <algorithm> // min, mismatch, count
+#include <limits> // numeric_limits
+
+
+namespace Kratos::UtilityApp {
+
+
+int main(int argc, const char** argv)
+{
+    if (argc < 3 || 4 < argc) {
+        std::cerr << "Usage: mdpa_write_benchmark <path to input mdpa> <output directory> [repetitions = 3]\n";
+        return 1;
+    }
+
+    const std::filesystem::path input_path(argv[1]), output_directory(argv[2]);
+    if (!std::filesystem::exists(input_path) || input_path.extension() != ".mdpa") {
+        std::cerr << "not an existing mdpa file: " << input_path << "\n";
+        return 1;
+    }
+    if (!std::filesystem::is_directory(output_directory)) {
+        std::cerr << "not an existing directory: " << output_directory << "\n";
+        return 1;
+    }
+
+    std::size_t repetition_count = 3;
+    try {
+        if (3 < argc) repetition_count = std::stoul(argv[3]);
+    } catch (...) {
+        std::cerr << "invalid number of repetitions\n";
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<KratosApplication>> applications;
+    applications.emplace_back(new KratosApplication("KratosCore"));
+    applications.emplace_back(new KratosStructuralMechanicsApplication);
+    for (const auto& rp_application : applications) {
+        rp_application->Register();
+    }
+
+    Model model;
+    ModelPart& r_model_part = model.CreateModelPart("root");
+    IOFactory(input_path)->Read(r_model_part);
+
+    const std::filesystem::path core_path = output_directory / "core.mdpa";
+    const std::filesystem::path parallel_path = output_directory / "parallel.mdpa";
+    std::filesystem::path core_stem = core_path;
+    core_stem.replace_extension("");
+
+    double core_time = std::numeric_limits<double>::max();
+    double parallel_time = std::numeric_limits<double>::max();
+    for (std::size_t i_repetition=0; i_repetition<repetition_count; ++i_repetition) {
+        {
+            std::filesystem::remove(core_path);
+            BuiltinTimer timer;
+            Kratos::ModelPartIO(core_stem, IO::WRITE | IO::SCIENTIFIC_PRECISION).WriteModelPart(r_model_part);
+            core_time = std::min(core_time, timer.ElapsedSeconds());
+        }
+
+        {
+            BuiltinTimer timer;
+            if (!WriteMDPA(parallel_path, r_model_part)) {
+                std::cerr << "the parallel writer does not support this model part\n";
+                return 1;
+            }
+            parallel_time = std::min(parallel_time, timer.ElapsedSeconds());
+        }
+    }
+
+    // Byte for byte comparison, reporting the line of the first difference.
+    const auto p_core = MappedFile::Open(core_path);
+    const auto p_parallel = MappedFile::Open(parallel_path);
+    if (!p_core || !p_parallel) {
+        std::cerr << "failed to open the written files\n";
+        return 1;
+    }
+    const char* p_core_begin = reinterpret_cast<const char*>(p_core->Data());
+    const char* p_core_end = p_core_begin + p_core->Size();
+    const char* p_parallel_begin = reinterpret_cast<const char*>(p_parallel->Data());
+    const char* p_parallel_end = p_parallel_begin + p_parallel->Size();
+    const auto [p_core_mismatch, p_parallel_mismatch] = std::mismatch(p_core_begin, p_core_end, p_parallel_begin, p_parallel_end);
+    if (p_core_mismatch != p_core_end || p_parallel_mismatch != p_parallel_end) {
+        std::cerr << "outputs differ on line " << std::count(p_core_begin, p_core_mismatch, '\n') + 1
+                  << " (the number format or layout of WriteMDPA no longer matches the core writer)\n";
+        return 1;
+    }
+
+    std::cout << "file        : " << input_path << " (" << p_core->Size() << " bytes written)\n"
+              << "threads     : " << ParallelUtilities::GetNumThreads() << "\n"
+              << "\tsequential [s]\tparallel [s]\tspeedup\n"
+              << "write\t" << core_time << "\t" << parallel_time << "\t" << core_time / parallel_time << "\n";
+
+    return 0;
+} // int main
+
+
+} // namespace Kratos::UtilityApp
+
+
+int main(int argc, const char** argv)
+{
+    return Kratos::UtilityApp::main(argc, argv);
+} // int main
@@ -0,0 +1,154 @@
+/// @author Máté Kelemen
+/// @details Displace the nodes of a model part, write it with @ref Kratos::UtilityApp::BinaryModelPartIO,
+///          read it back, check that the mesh (including initial coordinates and the properties of
+///          sub model parts) survived the round trip, and report the write and read times next to
+///          the ones of @ref Kratos::UtilityApp::MDPAModelPartIO.
+///          Usage: mdpb_roundtrip_benchmark <path to input> <output directory> [repetitions = 3]
+
+// --- Utility Includes ---
+#include "UtilityApp/ModelPartIO.hpp"
+#include "ModelPartComparison.hpp"
+
+// --- Core Includes ---
+#include "containers/model.h"
+#include "includes/kratos_application.h"
+#include "utilities/parallel_utilities.h"
+#include "utilities/builtin_timer.h"
+
+// --- Structural Mechanics Includes ---
+#include "structural_mechanics_application.h"
+
+// --- STL Includes ---
+#include <iostream> // cerr, cout
+#include <filesystem> // path, exists, is_directory, remove, file_size
+#include <memory> // unique_ptr
+#include <vector> // vector
+#include <string> // string, stoul
+#include <algorithm> // min
+#include <limits> // numeric_limits
+#include <cmath> // sin
+
+
+namespace Kratos::UtilityApp {
+
+
+struct RoundTripTimes
+{
+    double mWrite = std::numeric_limits<double>::max();
+
+    double mRead = std::numeric_limits<double>::max();
+}; // struct RoundTripTimes
+
+
+/// @brief Write @p rSource with @p rIO, then read it back into @p rTarget, keeping the shortest times in @p rTimes.
+void RoundTrip(const ModelPart& rSource,
+               ModelPart& rTarget,
+               ModelPartIO& rIO,
+               RoundTripTimes& rTimes)
+{
+    {
+        BuiltinTimer timer;
+        rIO.Write(rSource);
+        rTimes.mWrite = std::min(rTimes.mWrite, timer.ElapsedSeconds());
+    }
+
+    {
+        BuiltinTimer timer;
+        rIO.Read(rTarget);
+        rTimes.mRead = std::min(rTimes.mRead, timer.ElapsedSeconds());
+    }
+}
+
+
+int main(int argc, const char** argv)
+{
+    if (argc < 3 || 4 < argc) {
+        std::cerr << "Usage: mdpb_roundtrip_benchmark <path to input> <output directory> [repetitions = 3]\n";
+        return 1;
+    }
+
+    const std::filesystem::path input_path(argv[1]), output_directory(argv[2]);
+    if (!std::filesystem::exists(input_path)) {
+        std::cerr << "File not found: " << input_path << "\n";
+        return 1;
+    }
+    if (!std::filesystem::is_directory(output_directory)) {
+        std::cerr << "not an existing directory: " << output_directory << "\n";
+        return 1;
+    }
+
+    std::size_t repetition_count = 3;
+    try {
+        if (3 < argc) repetition_count = std::stoul(argv[3]);
+    } catch (...) {
+        std::cerr << "invalid number of repetitions\n";
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<KratosApplication>> applications;
+    applications.emplace_back(new KratosApplication("KratosCore"));
+    applications.emplace_back(new KratosStructuralMechanicsApplication);
+    for (const auto& rp_application : applications) {
+        rp_application->Register();
+    }
+
+    Model model;
+    ModelPart& r_source = model.CreateModelPart("root");
+    const std::filesystem::path mdpa_path = output_directory / "roundtrip.mdpa";
+    const std::filesystem::path mdpb_path = output_directory / "roundtrip.mdpb";
+    RoundTripTimes mdpa_times, mdpb_times;
+
+    try {
+        IOFactory(input_path)->Read(r_source);
+
+        // Deform the mesh so that current and initial coordinates differ.
+        IndexPartition<std::size_t>(r_source.NumberOfNodes()).for_each([&r_source](std::size_t i_node) {
+            auto& r_node = *(r_source.NodesBegin() + i_node);
+            r_node.X() = r_node.X0() + 1e-3 * std::sin(r_node.Y0());
+            r_node.Y() = r_node.Y0() + 1e-3 * std::sin(r_node.Z0());
+            r_node.Z() = r_node.Z0() + 1e-3 * std::sin(r_node.X0());
+        });
+
+        MDPAModelPartIO mdpa_io(std::filesystem::path(output_directory / "roundtrip"));
+        BinaryModelPartIO mdpb_io{std::filesystem::path(mdpb_path)};
+
+        for (std::size_t i_repetition=0; i_repetition<repetition_count; ++i_repetition) {
+            Model roundtrip_model;
+            std::filesystem::remove(mdpa_path);
+            RoundTrip(r_source, roundtrip_model.CreateModelPart("root"), mdpa_io, mdpa_times);
+
+            ModelPart& r_roundtrip = roundtrip_model.CreateModelPart("mdpb");
+            RoundTrip(r_source, r_roundtrip, mdpb_io, mdpb_times);
+
+            if (!i_repetition) {
+                const std::string difference = Compare(r_source, r_roundtrip);
+                if (!difference.empty()) {
+                    std::cerr << "model parts differ after the round trip: " << difference << "\n";
+                    return 1;
+                }
+            }
+        }
+    } catch (std::exception& rException) {
+        std::cerr << rException.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "file        : " << input_path << "\n"
+              << "threads     : " << ParallelUtilities::GetNumThreads() << "\n"
+              << "size [B]    : " << std::filesystem::file_size(mdpa_path) << " (mdpa) "
+                                  << std::filesystem::file_size(mdpb_path) << " (mdpb)\n"
+              << "\tmdpa [s]\tmdpb [s]\tspeedup\n"
+              << "write\t" << mdpa_times.mWrite << "\t" << mdpb_times.mWrite << "\t" << mdpa_times.mWrite / mdpb_times.mWrite << "\n"
+              << "read\t" << mdpa_times.mRead << "\t" << mdpb_times.mRead << "\t" << mdpa_times.mRead / mdpb_times.mRead << "\n";
+
+    return 0;
+} // int main
+
+
+} // namespace Kratos::UtilityApp
+
+
+int main(int argc, const char** argv)
+{
+    return Kratos::UtilityApp::main(argc, argv);
+} // int main
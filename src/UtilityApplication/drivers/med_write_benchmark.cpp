@@ -0,0 +1,124 @@
+/// @author Máté Kelemen
+/// @details Write a model part with @ref Kratos::MedModelPartIO and with
+///          @ref Kratos::UtilityApp::WriteMED, read both files back, check that they
+///          hold the same mesh and report the write times.
+///          Usage: med_write_benchmark <path to input med> <output directory> [repetitions = 3]
+
+// --- Utility Includes ---
+#include "UtilityApp/StreamingMED.hpp"
+#include "UtilityApp/ModelPartIO.hpp"
+#include "ModelPartComparison.hpp"
+
+// --- Core Includes ---
+#include "containers/model.h"
+#include "includes/kratos_application.h"
+#include "utilities/parallel_utilities.h"
+#include "utilities/builtin_timer.h"
+
+// --- Med Includes ---
+#include "custom_io/med_model_part_io.h"
+
+// --- STL Includes ---
+#include <iostream> // cerr, cout
+#include <filesystem> // path, exists, is_directory, remove, file_size
+#include <memory> // unique_ptr
+#include <vector> // vector
+#include <string> // string, stoul
+#include <algorithm> // min
+#include <limits> // numeric_limits
+
+
+namespace Kratos::UtilityApp {
+
+
+int main(int argc, const char** argv)
+{
+    if (argc < 3 || 4 < argc) {
+        std::cerr << "Usage: med_write_benchmark <path to input med> <output directory> [repetitions = 3]\n";
+        return 1;
+    }
+
+    const std::filesystem::path input_path(argv[1]), output_directory(argv[2]);
+    if (!std::filesystem::exists(input_path) || input_path.extension() != ".med") {
+        std::cerr << "not an existing med file: " << input_path << "\n";
+        return 1;
+    }
+    if (!std::filesystem::is_directory(output_directory)) {
+        std::cerr << "not an existing directory: " << output_directory << "\n";
+        return 1;
+    }
+
+    std::size_t repetition_count = 3;
+    try {
+        if (3 < argc) repetition_count = std::stoul(argv[3]);
+    } catch (...) {
+        std::cerr << "invalid number of repetitions\n";
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<KratosApplication>> applications;
+    applications.emplace_back(new KratosApplication("KratosCore"));
+    for (const auto& rp_application : applications) {
+        rp_application->Register();
+    }
+
+    Model model;
+    ModelPart& r_model_part = model.CreateModelPart("root");
+    IOFactory(input_path)->Read(r_model_part);
+
+    const std::filesystem::path core_path = output_directory / "core.med";
+    const std::filesystem::path streaming_path = output_directory / "streaming.med";
+
+    double core_time = std::numeric_limits<double>::max();
+    double streaming_time = std::numeric_limits<double>::max();
+    for (std::size_t i_repetition=0; i_repetition<repetition_count; ++i_repetition) {
+        {
+            std::filesystem::remove(core_path);
+            BuiltinTimer timer;
+            Kratos::MedModelPartIO(core_path, IO::WRITE).WriteModelPart(r_model_part);
+            core_time = std::min(core_time, timer.ElapsedSeconds());
+        }
+
+        {
+            std::filesystem::remove(streaming_path);
+            BuiltinTimer timer;
+            if (!WriteMED(streaming_path, r_model_part)) {
+                std::cerr << "the streaming writer does not support this model part\n";
+                return 1;
+            }
+            streaming_time = std::min(streaming_time, timer.ElapsedSeconds());
+        }
+    }
+
+    ModelPart& r_core = model.CreateModelPart("core");
+    ModelPart& r_streaming = model.CreateModelPart("streaming");
+    Kratos::MedModelPartIO(core_path, IO::READ).ReadModelPart(r_core);
+    Kratos::MedModelPartIO(streaming_path, IO::READ).ReadModelPart(r_streaming);
+    // MED files only hold nodes, geometries and groups.
+    ComparedContents contents;
+    contents.mProperties = false;
+    contents.mEntities = false;
+    const std::string difference = Compare(r_core, r_streaming, contents);
+    if (!difference.empty()) {
+        std::cerr << "the written meshes differ: " << difference << "\n";
+        return 1;
+    }
+
+    std::cout << "file        : " << input_path << "\n"
+              << "threads     : " << ParallelUtilities::GetNumThreads() << "\n"
+              << "size [B]    : " << std::filesystem::file_size(core_path) << " (core) "
+                                  << std::filesystem::file_size(streaming_path) << " (streaming)\n"
+              << "\tcore [s]\tstreaming [s]\tspeedup\n"
+              << "write\t" << core_time << "\t" << streaming_time << "\t" << core_time / streaming_time << "\n";
+
+    return 0;
+} // int main
+
+
+} // namespace Kratos::UtilityApp
+
+
+int main(int argc, const char** argv)
+{
+    return Kratos::UtilityApp::main(argc, argv);
+} // int main
@@ -0,0 +1,545 @@
+/// @author Máté Kelemen
+
+#pragma once
+
+// --- External Includes ---
+#include "amgcl/backend/builtin.hpp"
+#include "amgcl/solver/runtime.hpp"
+#include "amgcl/value_type/interface.hpp"
+#include "boost/property_tree/ptree.hpp"
+
+// --- Core Includes ---
+#include "includes/define.h"
+#include "utilities/parallel_utilities.h"
+#include "utilities/reduction_utilities.h"
+
+// --- STL Includes ---
+#include <tuple> // tuple
+#include <memory> // shared_ptr
+#include <variant> // variant
+#include <string> // string
+#include <ostream> // ostream
+#include <iostream> // cout
+#include <cmath> // sqrt
+#include <limits> // numeric_limits
+#include <type_traits> // remove_cv_t, is_same_v
+
+
+namespace Kratos::UtilityApp {
+
+
+namespace Detail {
+
+
+// Vector operations of the Krylov solvers below, composed of AMGCL backend operations.
+// Reductions are performed one by one.
+template <class TBackend>
+struct KrylovKernels
+{
+    using Vector = typename TBackend::vector;
+
+    using Coefficient = typename amgcl::math::inner_product_impl<
+        typename amgcl::math::rhs_of<typename TBackend::value_type>::type
+    >::return_type;
+
+    // (r, r), (r, u), (w, u)
+    static std::tuple<Coefficient,Coefficient,Coefficient> Dots(const Vector& rR,
+                                                                const Vector& rU,
+                                                                const Vector& rW)
+    {
+        return {amgcl::backend::inner_product(rR, rR),
+                amgcl::backend::inner_product(rR, rU),
+                amgcl::backend::inner_product(rW, rU)};
+    }
+
+    // p <= u + beta p, s <= w + beta s, x <= x + alpha p, r <= r - alpha s
+    template <class TSolution>
+    static void UpdateSearchDirection(Coefficient Alpha, Coefficient Beta,
+                                      const Vector& rU, const Vector& rW,
+                                      Vector& rP, Vector& rS,
+                                      TSolution& rX, Vector& rR)
+    {
+        const auto one = amgcl::math::identity<Coefficient>();
+        amgcl::backend::axpby(one, rU, Beta, rP);
+        amgcl::backend::axpby(one, rW, Beta, rS);
+        amgcl::backend::axpby(Alpha, rP, one, rX);
+        amgcl::backend::axpby(-Alpha, rS, one, rR);
+    }
+
+    // Pipelined recurrences followed by the reductions of the next iteration:
+    // z <= n + beta z, q <= m + beta q, s <= w + beta s, p <= u + beta p,
+    // x <= x + alpha p, r <= r - alpha s, u <= u - alpha q, w <= w - alpha z
+    template <class TSolution>
+    static std::tuple<Coefficient,Coefficient,Coefficient> UpdatePipelined(Coefficient Alpha, Coefficient Beta,
+                                                                           const Vector& rM, const Vector& rN,
+                                                                           Vector& rZ, Vector& rQ, Vector& rS, Vector& rP,
+                                                                           TSolution& rX, Vector& rR, Vector& rU, Vector& rW)
+    {
+        const auto one = amgcl::math::identity<Coefficient>();
+        amgcl::backend::axpby(one, rN, Beta, rZ);
+        amgcl::backend::axpby(one, rM, Beta, rQ);
+        amgcl::backend::axpby(one, rW, Beta, rS);
+        amgcl::backend::axpby(one, rU, Beta, rP);
+        amgcl::backend::axpby(Alpha, rP, one, rX);
+        amgcl::backend::axpby(-Alpha, rS, one, rR);
+        amgcl::backend::axpby(-Alpha, rQ, one, rU);
+        amgcl::backend::axpby(-Alpha, rZ, one, rW);
+        return Dots(rR, rU, rW);
+    }
+}; // struct KrylovKernels
+
+
+// The builtin backend's vectors reside in host memory, so the vector updates and
+// reductions of an iteration are fused into single parallel loops. This replaces
+// several synchronization points and passes over memory by one.
+template <class ...TArgs>
+struct KrylovKernels<amgcl::backend::builtin<TArgs...>>
+{
+    using Backend = amgcl::backend::builtin<TArgs...>;
+
+    using Vector = typename Backend::vector;
+
+    using Coefficient = typename amgcl::math::inner_product_impl<
+        typename amgcl::math::rhs_of<typename Backend::value_type>::type
+    >::return_type;
+
+    using Reduction = CombinedReduction<SumReduction<Coefficient>,
+                                        SumReduction<Coefficient>,
+                                        SumReduction<Coefficient>>;
+
+    static std::tuple<Coefficient,Coefficient,Coefficient> Dots(const Vector& rR,
+                                                                const Vector& rU,
+                                                                const Vector& rW)
+    {
+        return IndexPartition<std::size_t>(rR.size()).template for_each<Reduction>([&](std::size_t i) {
+            return std::make_tuple(amgcl::math::inner_product(rR[i], rR[i]),
+                                   amgcl::math::inner_product(rR[i], rU[i]),
+                                   amgcl::math::inner_product(rW[i], rU[i]));
+        });
+    }
+
+    template <class TSolution>
+    static void UpdateSearchDirection(Coefficient Alpha, Coefficient Beta,
+                                      const Vector& rU, const Vector& rW,
+                                      Vector& rP, Vector& rS,
+                                      TSolution& rX, Vector& rR)
+    {
+        IndexPartition<std::size_t>(rR.size()).for_each([&](std::size_t i) {
+            rP[i] = rU[i] + Beta * rP[i];
+            rS[i] = rW[i] + Beta * rS[i];
+            rX[i] += Alpha * rP[i];
+            rR[i] -= Alpha * rS[i];
+        });
+    }
+
+    template <class TSolution>
+    static std::tuple<Coefficient,Coefficient,Coefficient> UpdatePipelined(Coefficient Alpha, Coefficient Beta,
+                                                                           const Vector& rM, const Vector& rN,
+                                                                           Vector& rZ, Vector& rQ, Vector& rS, Vector& rP,
+                                                                           TSolution& rX, Vector& rR, Vector& rU, Vector& rW)
+    {
+        return IndexPartition<std::size_t>(rR.size()).template for_each<Reduction>([&](std::size_t i) {
+            rZ[i] = rN[i] + Beta * rZ[i];
+            rQ[i] = rM[i] + Beta * rQ[i];
+            rS[i] = rW[i] + Beta * rS[i];
+            rP[i] = rU[i] + Beta * rP[i];
+            rX[i] += Alpha * rP[i];
+            rR[i] -= Alpha * rS[i];
+            rU[i] -= Alpha * rQ[i];
+            rW[i] -= Alpha * rZ[i];
+            return std::make_tuple(amgcl::math::inner_product(rR[i], rR[i]),
+                                   amgcl::math::inner_product(rR[i], rU[i]),
+                                   amgcl::math::inner_product(rW[i], rU[i]));
+        });
+    }
+}; // struct KrylovKernels
+
+
+// Settings shared by the Krylov solvers below, parsed from the same keys as amgcl::solver::cg.
+template <class TScalar>
+struct KrylovParameters
+{
+    std::size_t maxiter = 100;
+
+    TScalar tol = 1e-8;
+
+    TScalar abstol = std::numeric_limits<TScalar>::min();
+
+    bool verbose = false;
+
+    KrylovParameters() = default;
+
+    KrylovParameters(const boost::property_tree::ptree& rSettings)
+        : maxiter(rSettings.get<std::size_t>("maxiter", 100)),
+          tol(rSettings.get<TScalar>("tol", 1e-8)),
+          abstol(rSettings.get<TScalar>("abstol", std::numeric_limits<TScalar>::min())),
+          verbose(rSettings.get<bool>("verbose", false))
+    {
+        for (const auto& r_item : rSettings) {
+            KRATOS_ERROR_IF_NOT(r_item.first == "maxiter"
+                                || r_item.first == "tol"
+                                || r_item.first == "abstol"
+                                || r_item.first == "verbose")
+                << "Unknown parameter " << r_item.first << "\n";
+        }
+    }
+
+    void get(boost::property_tree::ptree& rSettings, const std::string& rPath) const
+    {
+        rSettings.put(rPath + "maxiter", maxiter);
+        rSettings.put(rPath + "tol", tol);
+        rSettings.put(rPath + "abstol", abstol);
+        rSettings.put(rPath + "verbose", verbose);
+    }
+}; // struct KrylovParameters
+
+
+} // namespace Detail
+
+
+/// @brief Preconditioned pipelined conjugate gradients (Ghysels & Vanroose, 2014).
+/// @details Reformulates CG such that all reductions of an iteration are computed together
+///          and are independent of that iteration's preconditioner application and SpMV.
+///          The builtin backend fuses the vector recurrences and reductions into a single
+///          parallel loop, leaving one synchronization point per iteration instead of
+///          three, at the cost of 4 additional vectors. The recurrences accumulate more
+///          rounding error than standard CG, so the attainable accuracy may be lower.
+///          Compatible with @p amgcl::make_solver. Shared memory only.
+template <class TBackend>
+class PipelinedCG
+{
+public:
+    using backend_type = TBackend;
+
+    using vector = typename TBackend::vector;
+
+    using value_type = typename TBackend::value_type;
+
+    using backend_params = typename TBackend::params;
+
+    using scalar_type = typename amgcl::math::scalar_of<value_type>::type;
+
+    using params = Detail::KrylovParameters<scalar_type>;
+
+    PipelinedCG(std::size_t Size,
+                const params& rParameters = params(),
+                const backend_params& rBackendParameters = backend_params())
+        : mParameters(rParameters),
+          mSize(Size),
+          mpR(TBackend::create_vector(Size, rBackendParameters)),
+          mpU(TBackend::create_vector(Size, rBackendParameters)),
+          mpW(TBackend::create_vector(Size, rBackendParameters)),
+          mpM(TBackend::create_vector(Size, rBackendParameters)),
+          mpN(TBackend::create_vector(Size, rBackendParameters)),
+          mpZ(TBackend::create_vector(Size, rBackendParameters)),
+          mpQ(TBackend::create_vector(Size, rBackendParameters)),
+          mpS(TBackend::create_vector(Size, rBackendParameters)),
+          mpP(TBackend::create_vector(Size, rBackendParameters))
+    {
+    }
+
+    template <class TMatrix, class TPreconditioner, class TRHS, class TSolution>
+    std::tuple<std::size_t,scalar_type> operator()(const TMatrix& rA,
+                                                   const TPreconditioner& rPreconditioner,
+                                                   const TRHS& rRHS,
+                                                   TSolution&& rSolution) const
+    {
+        using Kernels = Detail::KrylovKernels<TBackend>;
+        using Coefficient = typename Kernels::Coefficient;
+        const auto one = amgcl::math::identity<Coefficient>();
+        const auto zero = amgcl::math::zero<Coefficient>();
+
+        const scalar_type rhs_norm = std::sqrt(std::abs(amgcl::backend::inner_product(rRHS, rRHS)));
+        if (rhs_norm == 0) {
+            amgcl::backend::clear(rSolution);
+            return {0, 0};
+        }
+        const scalar_type tolerance = std::max(mParameters.tol * rhs_norm, mParameters.abstol);
+
+        // r = b - A x, u = M r, w = A u
+        amgcl::backend::residual(rRHS, rA, rSolution, *mpR);
+        rPreconditioner.apply(*mpR, *mpU);
+        amgcl::backend::spmv(one, rA, *mpU, zero, *mpW);
+        for (auto p_vector : {mpZ, mpQ, mpS, mpP}) amgcl::backend::clear(*p_vector);
+
+        auto [rr, gamma, delta] = Kernels::Dots(*mpR, *mpU, *mpW);
+        Coefficient alpha = zero, gamma_old = zero;
+        std::size_t i_iteration = 0;
+
+        for (; i_iteration<mParameters.maxiter; ++i_iteration) {
+            const scalar_type residual_norm = std::sqrt(std::abs(rr));
+            if (mParameters.verbose) std::cout << i_iteration << "\t" << residual_norm / rhs_norm << std::endl;
+            if (residual_norm <= tolerance) break;
+
+            // m = M w, n = A m. Independent of the reductions above, which would overlap
+            // with them if the reductions were non-blocking.
+            rPreconditioner.apply(*mpW, *mpM);
+            amgcl::backend::spmv(one, rA, *mpM, zero, *mpN);
+
+            Coefficient beta = zero;
+            Coefficient denominator = delta;
+            if (i_iteration) {
+                beta = gamma / gamma_old;
+                denominator = delta - beta * gamma / alpha;
+            }
+            if (denominator == zero) break; // breakdown
+            alpha = gamma / denominator;
+            gamma_old = gamma;
+
+            std::tie(rr, gamma, delta) = Kernels::UpdatePipelined(alpha, beta,
+                                                                  *mpM, *mpN,
+                                                                  *mpZ, *mpQ, *mpS, *mpP,
+                                                                  rSolution, *mpR, *mpU, *mpW);
+        }
+
+        return {i_iteration, std::sqrt(std::abs(rr)) / rhs_norm};
+    }
+
+    template <class TPreconditioner, class TRHS, class TSolution>
+    std::tuple<std::size_t,scalar_type> operator()(const TPreconditioner& rPreconditioner,
+                                                   const TRHS& rRHS,
+                                                   TSolution&& rSolution) const
+    {
+        return (*this)(rPreconditioner.system_matrix(), rPreconditioner, rRHS, rSolution);
+    }
+
+    std::size_t bytes() const
+    {
+        return 9 * amgcl::backend::bytes(*mpR);
+    }
+
+    friend std::ostream& operator<<(std::ostream& rStream, const PipelinedCG& rSolver)
+    {
+        return rStream << "Type:             Pipelined CG"
+                       << "\nUnknowns:         " << rSolver.mSize
+                       << "\nMemory footprint: " << amgcl::human_readable_memory(rSolver.bytes())
+                       << std::endl;
+    }
+
+private:
+    params mParameters;
+
+    std::size_t mSize;
+
+    std::shared_ptr<vector> mpR, mpU, mpW, mpM, mpN, mpZ, mpQ, mpS, mpP;
+}; // class PipelinedCG
+
+
+/// @brief Preconditioned conjugate gradients with a single synchronization point per
+///        iteration (Chronopoulos & Gear, 1989).
+/// @details Standard CG reorganized so that the step length is computed from a recurrence,
+///          and (r, r), (r, u) and (w, u) are reduced together after the SpMV. This is not
+///          an s-step method: it still performs one SpMV and one preconditioner application
+///          per synchronization.
+///          Requires 2 additional vectors compared to standard CG, and is less prone to
+///          rounding error accumulation than @ref PipelinedCG, but the reductions cannot
+///          overlap with the SpMV and preconditioner. The builtin backend fuses the
+///          reductions into a single parallel loop, and the vector updates into another.
+///          Compatible with @p amgcl::make_solver. Shared memory only.
+template <class TBackend>
+class SingleReductionCG
+{
+public:
+    using backend_type = TBackend;
+
+    using vector = typename TBackend::vector;
+
+    using value_type = typename TBackend::value_type;
+
+    using backend_params = typename TBackend::params;
+
+    using scalar_type = typename amgcl::math::scalar_of<value_type>::type;
+
+    using params = Detail::KrylovParameters<scalar_type>;
+
+    SingleReductionCG(std::size_t Size,
+                       const params& rParameters = params(),
+                       const backend_params& rBackendParameters = backend_params())
+        : mParameters(rParameters),
+          mSize(Size),
+          mpR(TBackend::create_vector(Size, rBackendParameters)),
+          mpU(TBackend::create_vector(Size, rBackendParameters)),
+          mpW(TBackend::create_vector(Size, rBackendParameters)),
+          mpS(TBackend::create_vector(Size, rBackendParameters)),
+          mpP(TBackend::create_vector(Size, rBackendParameters))
+    {
+    }
+
+    template <class TMatrix, class TPreconditioner, class TRHS, class TSolution>
+    std::tuple<std::size_t,scalar_type> operator()(const TMatrix& rA,
+                                                   const TPreconditioner& rPreconditioner,
+                                                   const TRHS& rRHS,
+                                                   TSolution&& rSolution) const
+    {
+        using Kernels = Detail::KrylovKernels<TBackend>;
+        using Coefficient = typename Kernels::Coefficient;
+        const auto one = amgcl::math::identity<Coefficient>();
+        const auto zero = amgcl::math::zero<Coefficient>();
+
+        const scalar_type rhs_norm = std::sqrt(std::abs(amgcl::backend::inner_product(rRHS, rRHS)));
+        if (rhs_norm == 0) {
+            amgcl::backend::clear(rSolution);
+            return {0, 0};
+        }
+        const scalar_type tolerance = std::max(mParameters.tol * rhs_norm, mParameters.abstol);
+
+        // r = b - A x, u = M r, w = A u
+        amgcl::backend::residual(rRHS, rA, rSolution, *mpR);
+        rPreconditioner.apply(*mpR, *mpU);
+        amgcl::backend::spmv(one, rA, *mpU, zero, *mpW);
+        amgcl::backend::clear(*mpS);
+        amgcl::backend::clear(*mpP);
+
+        auto [rr, gamma, delta] = Kernels::Dots(*mpR, *mpU, *mpW);
+        Coefficient alpha = zero, gamma_old = zero;
+        std::size_t i_iteration = 0;
+
+        for (; i_iteration<mParameters.maxiter; ++i_iteration) {
+            const scalar_type residual_norm = std::sqrt(std::abs(rr));
+            if (mParameters.verbose) std::cout << i_iteration << "\t" << residual_norm / rhs_norm << std::endl;
+            if (residual_norm <= tolerance) break;
+
+            Coefficient beta = zero;
+            Coefficient denominator = delta;
+            if (i_iteration) {
+                beta = gamma / gamma_old;
+                denominator = delta - beta * gamma / alpha;
+            }
+            if (denominator == zero) break; // breakdown
+            alpha = gamma / denominator;
+            gamma_old = gamma;
+
+            Kernels::UpdateSearchDirection(alpha, beta, *mpU, *mpW, *mpP, *mpS, rSolution, *mpR);
+            rPreconditioner.apply(*mpR, *mpU);
+            amgcl::backend::spmv(one, rA, *mpU, zero, *mpW);
+            std::tie(rr, gamma, delta) = Kernels::Dots(*mpR, *mpU, *mpW);
+        }
+
+        return {i_iteration, std::sqrt(std::abs(rr)) / rhs_norm};
+    }
+
+    template <class TPreconditioner, class TRHS, class TSolution>
+    std::tuple<std::size_t,scalar_type> operator()(const TPreconditioner& rPreconditioner,
+                                                   const TRHS& rRHS,
+                                                   TSolution&& rSolution) const
+    {
+        return (*this)(rPreconditioner.system_matrix(), rPreconditioner, rRHS, rSolution);
+    }
+
+    std::size_t bytes() const
+    {
+        return 5 * amgcl::backend::bytes(*mpR);
+    }
+
+    friend std::ostream& operator<<(std::ostream& rStream, const SingleReductionCG& rSolver)
+    {
+        return rStream << "Type:             Single reduction CG"
+                       << "\nUnknowns:         " << rSolver.mSize
+                       << "\nMemory footprint: " << amgcl::human_readable_memory(rSolver.bytes())
+                       << std::endl;
+    }
+
+private:
+    params mParameters;
+
+    std::size_t mSize;
+
+    std::shared_ptr<vector> mpR, mpU, mpW, mpS, mpP;
+}; // class SingleReductionCG
+
+
+/// @brief Drop-in replacement for @p amgcl::runtime::solver::wrapper that additionally
+///        supports the iterative solvers of this application.
+/// @details The solver is selected by @a "type" in the settings:
+///          - @p "pipelined_cg": @ref PipelinedCG
+///          - @p "single_reduction_cg": @ref SingleReductionCG
+///          - anything else is forwarded to @p amgcl::runtime::solver::wrapper.
+template <class TBackend>
+class AMGCLSolverWrapper
+{
+public:
+    using backend_type = TBackend;
+
+    using value_type = typename TBackend::value_type;
+
+    using backend_params = typename TBackend::params;
+
+    using scalar_type = typename amgcl::math::scalar_of<value_type>::type;
+
+    using params = boost::property_tree::ptree;
+
+    AMGCLSolverWrapper(std::size_t Size,
+                       params Parameters = params(),
+                       const backend_params& rBackendParameters = backend_params())
+    {
+        const std::string type = Parameters.get<std::string>("type", "bicgstab");
+        if (type == "pipelined_cg") {
+            Parameters.erase("type");
+            mSolver.template emplace<PipelinedCG<TBackend>>(Size, Parameters, rBackendParameters);
+        } else if (type == "single_reduction_cg") {
+            Parameters.erase("type");
+            mSolver.template emplace<SingleReductionCG<TBackend>>(Size, Parameters, rBackendParameters);
+        } else {
+            mSolver.template emplace<amgcl::runtime::solver::wrapper<TBackend>>(Size, Parameters, rBackendParameters);
+        }
+    }
+
+    template <class TMatrix, class TPreconditioner, class TRHS, class TSolution>
+    std::tuple<std::size_t,scalar_type> operator()(const TMatrix& rA,
+                                                   const TPreconditioner& rPreconditioner,
+                                                   const TRHS& rRHS,
+                                                   TSolution&& rSolution) const
+    {
+        return std::visit(
+            [&](const auto& rSolver) -> std::tuple<std::size_t,scalar_type> {
+                using SolverType = std::remove_cv_t<std::remove_reference_t<decltype(rSolver)>>;
+                if constexpr (std::is_same_v<SolverType,std::monostate>) {
+                    KRATOS_ERROR << "uninitialized solver\n";
+                } else {
+                    return rSolver(rA, rPreconditioner, rRHS, rSolution);
+                }
+            },
+            mSolver);
+    }
+
+    template <class TPreconditioner, class TRHS, class TSolution>
+    std::tuple<std::size_t,scalar_type> operator()(const TPreconditioner& rPreconditioner,
+                                                   const TRHS& rRHS,
+                                                   TSolution&& rSolution) const
+    {
+        return (*this)(rPreconditioner.system_matrix(), rPreconditioner, rRHS, rSolution);
+    }
+
+    std::size_t bytes() const
+    {
+        return std::visit(
+            [](const auto& rSolver) -> std::size_t {
+                using SolverType = std::remove_cv_t<std::remove_reference_t<decltype(rSolver)>>;
+                if constexpr (std::is_same_v<SolverType,std::monostate>) return 0;
+                else return rSolver.bytes();
+            },
+            mSolver);
+    }
+
+    friend std::ostream& operator<<(std::ostream& rStream, const AMGCLSolverWrapper& rWrapper)
+    {
+        std::visit(
+            [&rStream](const auto& rSolver) {
+                using SolverType = std::remove_cv_t<std::remove_reference_t<decltype(rSolver)>>;
+                if constexpr (!std::is_same_v<SolverType,std::monostate>) rStream << rSolver;
+            },
+            rWrapper.mSolver);
+        return rStream;
+    }
+
+private:
+    std::variant<
+        std::monostate,
+        amgcl::runtime::solver::wrapper<TBackend>,
+        PipelinedCG<TBackend>,
+        SingleReductionCG<TBackend>
+    > mSolver;
+}; // class AMGCLSolverWrapper
+
+
+} // namespace Kratos::UtilityApp
@@ -19,17 +19,75 @@
 #include "includes/define.h"
 #include "linear_solvers/linear_solver.h"
 
+// --- STL Includes ---
+#include <vector> // vector
+#include <cstddef> // size_t
+
 
 namespace Kratos {
 
 
+/// @brief Statistics of a single level in an AMG hierarchy.
+/// @details Row counts refer to block rows if the system is solved with a block backend.
+struct AMGCLLevelStatistics
+{
+    std::size_t mRowCount = 0;
+
+    std::size_t mNonZeroCount = 0;
+
+    /// @brief Memory footprint of the level's operator and transfer operators in bytes.
+    /// @details Smoothers are not included.
+    std::size_t mMemory = 0;
+}; // struct AMGCLLevelStatistics
+
+
+/// @brief Statistics of a single call to @ref AMGCLWrapper::PerformSolutionStep.
+struct AMGCLSolveStatistics
+{
+    /// @brief Wall time spent constructing the hierarchy before this solve [s].
+    /// @details 0 if the solve used a hierarchy that was already used by a previous solve.
+    double mSetupTime = 0.0;
+
+    /// @brief Wall time spent in the iterative solver, including transfers to/from the backend [s].
+    double mSolveTime = 0.0;
+
+    std::size_t mIterationCount = 0;
+
+    /// @brief Relative residual reported by AMGCL.
+    double mResidual = 0.0;
+
+    /// @brief True if the hierarchy was constructed for a previous step and reused in this one.
+    bool mReusedHierarchy = false;
+
+    /// @brief Sum of nonzeros on all levels divided by the nonzeros of the finest level.
+    double mOperatorComplexity = 0.0;
+
+    /// @brief Sum of rows on all levels divided by the rows of the finest level.
+    double mGridComplexity = 0.0;
+
+    /// @brief Number of fallback solvers invoked after AMGCL failed to converge.
+    std::size_t mFallbackCount = 0;
+
+    /// @brief Wall time spent in fallback solvers [s].
+    double mFallbackTime = 0.0;
+
+    /// @brief Per-level statistics of the hierarchy, from finest to coarsest.
+    /// @details Empty if the preconditioner is not an AMG hierarchy or the system is distributed.
+    std::vector<AMGCLLevelStatistics> mLevels;
+}; // struct AMGCLSolveStatistics
+
+
 /** @brief A solver similar to @ref AMGCLSolver but with a direct interface to AMGCL.
  *  @details This class has 2 main differences compared to @ref AMGCLSolver:
- *           - the AMGCL solver instance is stored and does not get reconstructed
- *             at every call to @ref Solve, leading to better performance in cases
- *             when the solver is called repeatedly for the same system.
+ *           - the AMGCL solver instance is stored and, depending on @a "hierarchy_reuse",
+ *             does not get reconstructed at every call to @ref Solve, leading to better
+ *             performance in cases when the solver is called repeatedly for the same system.
  *           - if compiled with GPU support, a single precision GPU backend is
  *             supported in addition to the standard double precision backend.
+ *             Device-side system vectors persist between solves, and the right hand
+ *             side is uploaded while the hierarchy is being constructed.
+ *           - the AMG preconditioner can be stored and applied in single precision
+ *             while the iterative solver and its residual stay in double precision.
  *
  *           Default Parameters:
  *           @code
@@ -38,6 +96,22 @@ namespace Kratos {
  *              "verbosity" : 0,
  *              "tolerance" : 1e-6,
  *              "gpgpu_backend" : "",
+ *              "use_rigid_body_modes" : false,
+ *              "initial_guess" : "provided",
+ *              "static_dispatch" : true,
+ *              "first_touch" : false,
+ *              "reordering" : "none",
+ *              "data_communicator" : "",
+ *              "statistics_history" : 16,
+ *              "fallbacks" : [],
+ *              "hierarchy_reuse" : {
+ *                  "policy" : "rebuild",
+ *                  "rebuild_interval" : 0,
+ *                  "max_iteration_growth" : 0.5
+ *              },
+ *              "hierarchy_cache" : {
+ *                  "directory" : ""
+ *              },
  *              "amgcl_settings" : {
  *                  "precond" : {
  *                      "class" : "amg",
@@ -73,8 +147,114 @@ namespace Kratos {
  *                         this setting does not get passed on to AMGCL. Set the tolerance
  *                         directly in @a "amgcl_settings" to control AMGCL's tolerance.
  *          - "backend":   [@p "cpu" (default), @p "gpu"].
+ *          - "precision": [@p "full" (default), @p "mixed"]. @p "mixed" constructs and applies
+ *                         the preconditioner in single precision, while the iterative solver,
+ *                         its system matrix and residual remain in the sparse space's precision.
+ *                         This roughly halves the hierarchy's memory footprint and bandwidth.
+ *                         Only available on the @p "cpu" backend, and has no effect on
+ *                         systems that are already in single precision.
+ *          - "block_size": [@p "auto" (default) or a positive integer] number of DoFs per node.
+ *                          @p "auto" deduces it from the DoF set in @ref ProvideAdditionalData.
+ *                          Block sizes 2-6 solve the system with block-valued AMGCL backends
+ *                          (block CRS), any other block size is an error.
+ *          - "hierarchy_reuse": controls when the AMG hierarchy gets reconstructed.
+ *              - "policy": [@p "rebuild" (default), @p "unchanged", @p "adaptive"]
+ *                  - @p "rebuild": construct a new hierarchy at every step.
+ *                  - @p "unchanged": reuse the hierarchy if the system matrix resides at the same
+ *                                    address and its sparsity pattern and values are unchanged.
+ *                  - @p "adaptive": reuse the hierarchy as long as the matrix' address and sparsity
+ *                                   pattern are unchanged. Changed values are passed on to the
+ *                                   iterative solver, while the preconditioner is kept until
+ *                                   either of the criteria below triggers a reconstruction.
+ *              - "rebuild_interval": max number of consecutive reuses for @p "adaptive" (0 => no limit).
+ *              - "max_iteration_growth": relative increase of the iteration count compared to the
+ *                                        first solve after the setup that triggers a reconstruction
+ *                                        for @p "adaptive" (0.5 <=> 50%).
+ *          - "hierarchy_cache": stores the AMG levels (transfer operators and coarse operators) on disk
+ *                               and loads them in later runs instead of coarsening the same matrices again.
+ *              - "directory": directory the levels are stored in (created if necessary). Empty (default)
+ *                             disables caching. Levels are keyed by a hash of their matrix' pattern and
+ *                             values and the coarsening settings, so changed systems or settings fall
+ *                             back to a fresh setup. Cache files are memory mapped when loaded, and
+ *                             smoothers are always constructed anew. Only AMG preconditioners on the
+ *                             @p "cpu" backend in full precision without rigid body modes are cached.
+ *                             The directory is never cleaned up, and may be shared by concurrent analyses.
+ *          - "use_rigid_body_modes": construct rigid body modes from the nodal coordinates and the
+ *                                    DISPLACEMENT_* / ROTATION_* DoFs in @ref ProvideAdditionalData,
+ *                                    and pass them to AMGCL as near-nullspace vectors
+ *                                    (@a "precond.coarsening.nullspace"). Requires aggregation based
+ *                                    coarsening. Since AMGCL supports near-nullspaces for scalar systems
+ *                                    only, the system is solved with a scalar backend and the block size
+ *                                    is used for pointwise aggregation instead.
+ *          - "initial_guess": [@p "provided" (default), @p "zero", @p "previous", @p "extrapolated"]
+ *                             starting iterate of the iterative solver.
+ *              - @p "provided": the solution vector passed to @ref Solve as is.
+ *              - @p "zero": ignore the solution vector's contents and start from 0.
+ *              - @p "previous": start from the solution of the previous solve (warm start for
+ *                               transient and nonlinear analyses).
+ *              - @p "extrapolated": start from a linear extrapolation of the previous 2 solutions.
+ *              Warm starts use the provided vector until enough solutions were recorded, and are
+ *              disabled for multiple right hand sides.
+ *          - "static_dispatch": use a compile-time configured solver instead of AMGCL's runtime
+ *                               wrappers if @a "amgcl_settings" describe AMG with @p "aggregation" or
+ *                               @p "smoothed_aggregation" coarsening, @p "ilu0" or @p "spai0" relaxation
+ *                               and a @p "cg" solver, on the @p "cpu" backend in full precision with a
+ *                               block size of 1 or 3. Other settings, or settings the compile-time
+ *                               configured components reject, fall back to the runtime configuration.
+ *          - "first_touch": copy the system matrix and the matrices of each AMG level into arrays
+ *                           that are first written in parallel over the same contiguous row ranges
+ *                           the solve phase assigns to each thread, so that on NUMA machines each
+ *                           thread's rows reside in its local memory. Costs a copy of the system
+ *                           matrix and a transient copy of each level during setup. Requires an
+ *                           AMG preconditioner on the @p "cpu" backend in full precision. AMGCL's
+ *                           own vectors are always first touched in parallel.
+ *          - "data_communicator": name of a registered @ref DataCommunicator the system is
+ *                                 distributed over. If empty (default), the communicator of the
+ *                                 model part passed to @ref ProvideAdditionalData is used. Distributed
+ *                                 systems are solved with AMGCL's MPI components (distributed AMG
+ *                                 with a distributed iterative solver) on the CPU backend. Each rank
+ *                                 passes the system it assembled over its own DoF set (owned and ghost
+ *                                 DoFs, indexed by their local equation IDs), and the wrapper builds the
+ *                                 strip of rows it owns in the global system from the DoF set passed to
+ *                                 @ref ProvideAdditionalData: DoFs whose @a PARTITION_INDEX is this rank
+ *                                 are numbered contiguously (in ascending order across ranks), the rows
+ *                                 and right hand side entries of ghost DoFs are added to the rows of their
+ *                                 owners, and the solution of ghost DoFs is fetched from their owners.
+ *                                 DoFs with equation IDs beyond the system size are skipped. Without a
+ *                                 DoF set, each rank must pass the rows it owns with global column indices
+ *                                 along with vectors of its owned rows. @a "amgcl_settings" must then
+ *                                 be valid for AMGCL's MPI components (@a "precond.class" is ignored).
+ *                                 Hierarchy reuse, mixed precision, reordering and rigid body modes
+ *                                 are not supported for distributed systems. Requires compiling with MPI.
+ *          - "reordering": [@p "none" (default), @p "rcm"] permutation applied to the system before
+ *                          passing it on to AMGCL. @p "rcm" orders the nodes (groups of block size
+ *                          consecutive DoFs) with the reverse Cuthill-McKee algorithm to reduce the
+ *                          bandwidth of the system matrix, improving the cache locality of SpMV
+ *                          and smoothers. The permutation is computed once per sparsity pattern.
+ *          - "statistics_history": number of most recent solves whose statistics are kept for
+ *                                  @ref GetStatistics (0 disables collecting statistics).
+ *          - "rhs_lanes": max number of right hand sides solved concurrently when solving for
+ *                         multiple right hand sides (1 by default). AMGCL's solvers are not reentrant,
+ *                         so each additional lane constructs its own copy of the solver (including
+ *                         a hierarchy) from the same system, trading setup time and memory for
+ *                         throughput. AMGCL's parallel loops nested in a lane run on the lane's thread,
+ *                         so values close to the number of threads make the best use of the cores.
+ *                         Only used on the @p "cpu" backend for systems that are not distributed.
+ *          - "fallbacks": settings of linear solvers (as accepted by @ref LinearSolverFactory) tried in
+ *                         order if AMGCL fails to converge, until one of them succeeds. Each one starts
+ *                         from the same initial iterate as AMGCL did, and is constructed at its first use
+ *                         and kept for subsequent failures. For example, an @p "amgcl_wrapper" with more
+ *                         smoothing steps, then one with @p "gmres", then a direct solver such as
+ *                         @p "LinearSolversApplication.sparse_lu" (the providing application must be
+ *                         imported). Ignored for distributed systems.
  *          - "amgcl_settings": subparameter tree passed on directly to AMGCL. See AMGCL's
- *                              documentation for available options.
+ *                              documentation for available options. In addition to AMGCL's
+ *                              iterative solvers, @a "solver.type" accepts @p "pipelined_cg"
+ *                              (@ref UtilityApp::PipelinedCG) and @p "single_reduction_cg"
+ *                              (@ref UtilityApp::SingleReductionCG), which reduce the number of
+ *                              synchronization points per iteration on high core count nodes.
+ *                              They accept @a "maxiter", @a "tol", @a "abstol" and @a "verbose",
+ *                              and are not available for distributed systems.
  */
 template<class TSparseSpace,
          class TDenseSpace,
@@ -107,8 +287,27 @@ public:
     bool Solve(SparseMatrix& rA, Vector& rX, Vector& rB) override;
 
     /// @copydoc LinearSolver::Solve
+    /// @details Equivalent to the overload reporting the iteration counts and residuals of each column.
     bool Solve(SparseMatrix& rA, DenseMatrix& rX, DenseMatrix& rB) override;
 
+    /** @brief Solve the system for each column of @p rB on a shared hierarchy.
+     *  @details The hierarchy is constructed once. With @a "rhs_lanes" greater than 1, that many
+     *           columns are solved concurrently, each lane on its own copy of the solver (see
+     *           @a "rhs_lanes"), and columns that fail to converge are solved again with the
+     *           fallbacks, if there are any. Otherwise the columns are solved one after the other,
+     *           each solve being parallel internally. Columns of @p rX are used as initial guesses
+     *           if @p rX has the shape of @p rB, unless @a "initial_guess" is @p "zero". Warm starts
+     *           from previous solutions are disabled, since the columns are independent.
+     *  @param rIterationCounts Iteration count of each column's solve.
+     *  @param rResiduals Relative residual of each column's solve.
+     *  @returns True if all columns converged.
+     */
+    bool Solve(SparseMatrix& rA,
+               DenseMatrix& rX,
+               DenseMatrix& rB,
+               std::vector<std::size_t>& rIterationCounts,
+               std::vector<double>& rResiduals);
+
     /// @copydoc LinearSolver::PerformSolutionStep
     bool PerformSolutionStep(SparseMatrix& rA, Vector& rX, Vector& rB) override;
 
@@ -132,6 +331,10 @@ public:
         ModelPart& rModelPart
     ) override;
 
+    /// @brief Statistics of the most recent solves, ordered from oldest to newest.
+    /// @details At most @a "statistics_history" entries are kept.
+    std::vector<AMGCLSolveStatistics> GetStatistics() const;
+
     static Parameters GetDefaultParameters();
 
 private:
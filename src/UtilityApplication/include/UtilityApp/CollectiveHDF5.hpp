@@ -0,0 +1,103 @@
+/// @author Máté Kelemen
+
+#pragma once
+
+// --- Utility Includes ---
+#include "UtilityApp/common.hpp"
+
+// --- Core Includes ---
+#include "includes/model_part.h"
+#include "includes/data_communicator.h"
+
+// --- STL Includes ---
+#include <filesystem>
+#include <string>
+#include <vector>
+
+
+namespace Kratos::UtilityApp {
+
+
+/// @brief Compression filters of datasets written by @ref WriteCollectiveHDF5.
+enum class HDF5Filter
+{
+    None,
+    Deflate,    ///< built into HDF5, levels 1-9
+    Zstd,       ///< registered filter 32015, levels 1-22; requires the HDF5 plugin on HDF5_PLUGIN_PATH
+    Szip        ///< requires HDF5 built with szip (or libaec); the level is the number of pixels per block (even, 2-32)
+}; // enum class HDF5Filter
+
+
+/// @brief Check whether HDF5 can encode datasets with @p Filter.
+bool IsHDF5FilterAvailable(HDF5Filter Filter);
+
+
+/// @brief Settings of @ref WriteCollectiveHDF5 and @ref ReadCollectiveHDF5.
+struct CollectiveHDF5Settings
+{
+    /// @brief Group in the file holding the model part.
+    std::string mPrefix = "/ModelData";
+
+    /// @brief Approximate size of dataset chunks in bytes.
+    /// @details Chunks always consist of whole rows (a node's coordinates or an entity's connectivity).
+    std::size_t mChunkSize = std::size_t(1) << 20;
+
+    /// @brief Compression filter of datasets. Deflate and zstd are applied after byte shuffling.
+    HDF5Filter mFilter = HDF5Filter::Deflate;
+
+    /// @brief Level of @ref mFilter (0 => no compression).
+    int mCompressionLevel = 0;
+
+    /** @brief Parts of the mesh to read besides the nodes, which are always read (empty => everything).
+     *  @details Items are "Properties", "Elements", "Conditions", "SubModelParts", or registered names
+     *           of element or condition types to read only those groups. Elements and conditions still
+     *           get their properties if "Properties" is not listed, but without reading the list of
+     *           properties, so unreferenced ones are missing.
+     */
+    std::vector<std::string> mEntityTypes;
+
+    /// @brief Names of the sub model parts to read relative to the root, like "domain.inlet" (empty => all).
+    /// @details Descendants of listed sub model parts are read as well, and ancestors are created to hold them.
+    std::vector<std::string> mSubModelParts;
+}; // struct CollectiveHDF5Settings
+
+
+/** @brief Write a (distributed) model part into shared datasets of a single HDF5 file.
+ *  @details Each rank writes its owned nodes (the communicator's local mesh), elements and conditions
+ *           as a contiguous hyperslab of datasets shared by all ranks, in rank order, using collective
+ *           MPI-IO transfers. Layout under @ref CollectiveHDF5Settings::mPrefix :
+ *           - Nodes/Ids, Nodes/Coordinates (rows of x, y, z)
+ *           - Properties/Ids
+ *           - Elements/<registered name>/{Ids, PropertyIds (max uint64 if none), Connectivities (rows of node IDs)}
+ *           - Conditions/<registered name>/{Ids, PropertyIds, Connectivities}
+ *           - SubModelParts/<name>/{NodeIds, ElementIds, ConditionIds, PropertyIds, SubModelParts/...}
+ *           Only meshes are stored: no variables, data values or property values. All ranks must call
+ *           this function, and have the same sub model part tree and properties.
+ *  @param rDataCommunicator Communicator spanning the ranks the model part is distributed over.
+ */
+void WriteCollectiveHDF5(const std::filesystem::path& rFilePath,
+                         Ref<const ModelPart> rSource,
+                         const DataCommunicator& rDataCommunicator,
+                         const CollectiveHDF5Settings& rSettings = {});
+
+
+/** @brief Read a model part written by @ref WriteCollectiveHDF5 on any number of ranks.
+ *  @details The file is repartitioned independently of how many ranks wrote it: each rank reads an
+ *           equal contiguous share of the nodes and of each element and condition group, along with
+ *           the nodes its elements and conditions refer to. All reads are collective MPI-IO transfers,
+ *           and no rank reads more than its share of any dataset: referenced nodes and sub model part
+ *           IDs are exchanged with the ranks whose range of IDs contains them. Nodes are owned by the
+ *           rank whose share they are in; if @p rTarget has @ref PARTITION_INDEX as a nodal solution step variable, it
+ *           is set accordingly, so that @a ParallelFillCommunicator can set up the communicator.
+ *           Groups left out by @ref CollectiveHDF5Settings::mEntityTypes and
+ *           @ref CollectiveHDF5Settings::mSubModelParts are not touched, so their types need
+ *           not even be registered.
+ *  @param rDataCommunicator Communicator spanning the ranks the model part gets distributed over.
+ */
+void ReadCollectiveHDF5(const std::filesystem::path& rFilePath,
+                        Ref<ModelPart> rTarget,
+                        const DataCommunicator& rDataCommunicator,
+                        const CollectiveHDF5Settings& rSettings = {});
+
+
+} // namespace Kratos::UtilityApp
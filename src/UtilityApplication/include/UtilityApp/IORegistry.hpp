@@ -0,0 +1,98 @@
+/// @author Máté Kelemen
+
+#pragma once
+
+// --- Utility Includes ---
+#include "UtilityApp/common.hpp"
+#include "UtilityApp/ModelPartIO.hpp"
+
+// --- STL Includes ---
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+
+namespace Kratos::UtilityApp {
+
+
+/** @brief Registry of @ref ModelPartIO implementations @ref IOFactory picks from.
+ *  @details Each format has a list of extensions and an optional content sniffer. Existing
+ *           (non-empty) files are identified by their contents first when they're read, preferring
+ *           the format their extension belongs to if several sniffers accept them, and later
+ *           registrations otherwise. Files no sniffer recognizes fall back to their extension, unless
+ *           the format of the extension has a sniffer that rejected them: such files are reported
+ *           right away instead of failing somewhere in the middle of reading them. Files that are
+ *           written go by their extension only, regardless of what they contained before.
+ *           Built-in formats:
+ *           - "mdpa" (*.mdpa): first token is "Begin" (after comments; inconclusive if the head is all comments)
+ *           - "med" (*.med): HDF5 file with the "INFOS_GENERALES" group of MED
+ *           - "hdf5" (*.h5, *.hdf5): any other HDF5 file
+ *           - "mdpb" (*.mdpb): @ref BinaryModelPartIO magic bytes
+ */
+class IORegistry
+{
+public:
+    /// @brief Check whether a file belongs to a format, given its path and its first @ref SniffSize bytes (fewer if the file is shorter).
+    /// @details Returns an empty optional if the head is inconclusive, in which case the extension decides.
+    using Sniffer = std::function<std::optional<bool>(const std::filesystem::path&,std::span<const char>)>;
+
+    /// @brief Construct an IO for a file path (including its extension).
+    using Factory = std::function<std::unique_ptr<ModelPartIO>(const std::filesystem::path&)>;
+
+    struct Format
+    {
+        std::string mName;
+
+        /// @brief Extensions including the leading dot, matched case insensitively.
+        std::vector<std::string> mExtensions;
+
+        /// @brief Content check, or an empty function if the format can only be told by its extension.
+        Sniffer mSniffer;
+
+        Factory mFactory;
+    }; // struct Format
+
+    /// @brief Whether a file is identified for reading (by its contents) or for writing (by its extension).
+    enum class Access {Read, Write};
+
+    /// @brief Number of leading bytes passed to sniffers.
+    static constexpr std::size_t SniffSize = 4096;
+
+    /// @brief The registry @ref IOFactory uses, with the built-in formats registered.
+    static IORegistry& Get();
+
+    /// @brief Register a format, replacing the one with the same name if there's any.
+    void Register(Format NewFormat);
+
+    /// @brief Remove a format if it's registered.
+    void Unregister(const std::string& rName);
+
+    std::vector<std::string> GetNames() const;
+
+    /// @brief Name of the format a file gets read or written with. Throws if there's none.
+    std::string Detect(const std::filesystem::path& rFilePath, Access Mode = Access::Read) const;
+
+    /// @brief Construct an IO that writes with the format of the extension of @p rFilePath, and identifies the file on each @ref ModelPartIO::Read.
+    /// @details Throws right away if no format has the extension, unless the file exists and could be identified by its contents.
+    std::unique_ptr<ModelPartIO> Create(const std::filesystem::path& rFilePath) const;
+
+    /// @brief Format a file gets read or written with. Throws if there's none.
+    Format Find(const std::filesystem::path& rFilePath, Access Mode) const;
+
+private:
+    IORegistry();
+
+    IORegistry(const IORegistry&) = delete;
+
+    mutable std::mutex mMutex;
+
+    std::vector<Format> mFormats;
+}; // class IORegistry
+
+
+} // namespace Kratos::UtilityApp
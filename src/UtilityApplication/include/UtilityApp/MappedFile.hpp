@@ -0,0 +1,84 @@
+/// @author Máté Kelemen
+
+#pragma once
+
+// --- STL Includes ---
+#include <filesystem> // path, file_size
+#include <memory> // shared_ptr, unique_ptr
+#include <cstddef> // byte, size_t, max_align_t
+#include <fstream> // ifstream
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h> // mmap, munmap
+#include <fcntl.h> // open
+#include <unistd.h> // close
+#endif
+
+
+namespace Kratos::UtilityApp {
+
+
+/// @brief Memory mapping of a file's contents, or a copy of them on platforms without mmap.
+/// @details The mapping is private and writable, so callers may modify the contents in
+///          place without affecting the file. Pages are only read from the file when first
+///          accessed.
+class MappedFile
+{
+public:
+    /// @brief Map a file, or return nullptr if it cannot be opened or is empty.
+    static std::shared_ptr<MappedFile> Open(const std::filesystem::path& rPath)
+    {
+        std::error_code error;
+        const std::size_t size = std::filesystem::file_size(rPath, error);
+        if (error || !size) return nullptr;
+
+        auto p_file = std::shared_ptr<MappedFile>(new MappedFile);
+        #if defined(__unix__) || defined(__APPLE__)
+            const int descriptor = ::open(rPath.c_str(), O_RDONLY);
+            if (descriptor < 0) return nullptr;
+            void* p_data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+            ::close(descriptor);
+            if (p_data == MAP_FAILED) return nullptr;
+            p_file->mpData = static_cast<std::byte*>(p_data);
+        #else
+            std::ifstream file(rPath, std::ios::binary);
+            if (!file) return nullptr;
+            p_file->mBuffer.reset(new std::max_align_t[size / sizeof(std::max_align_t) + 1]);
+            p_file->mpData = reinterpret_cast<std::byte*>(p_file->mBuffer.get());
+            if (!file.read(reinterpret_cast<char*>(p_file->mpData), size)) return nullptr;
+        #endif
+        p_file->mSize = size;
+        return p_file;
+    }
+
+    ~MappedFile()
+    {
+        #if defined(__unix__) || defined(__APPLE__)
+            if (mpData) ::munmap(mpData, mSize);
+        #endif
+    }
+
+    std::byte* Data() noexcept {return mpData;}
+
+    const std::byte* Data() const noexcept {return mpData;}
+
+    std::size_t Size() const noexcept {return mSize;}
+
+    MappedFile(MappedFile&&) = delete;
+
+    MappedFile(const MappedFile&) = delete;
+
+private:
+    MappedFile() = default;
+
+    std::byte* mpData = nullptr;
+
+    std::size_t mSize = 0;
+
+    #if !(defined(__unix__) || defined(__APPLE__))
+        std::unique_ptr<std::max_align_t[]> mBuffer;
+    #endif
+}; // class MappedFile
+
+
+} // namespace Kratos::UtilityApp
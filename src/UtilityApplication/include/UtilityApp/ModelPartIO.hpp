@@ -8,6 +8,7 @@
 // --- Core Includes ---
 #include "containers/model.h"
 #include "includes/model_part.h"
+#include "includes/kratos_parameters.h"
 
 // --- STL Includes ---
 #include <filesystem>
@@ -28,6 +29,10 @@ public:
 }; // class ModelPartIO
 
 
+/// @brief Kratos' text format (*.mdpa).
+/// @details Reading and writing go through @ref ReadMDPA and @ref WriteMDPA, which process
+///          blocks in parallel, and fall back to @ref Kratos::ModelPartIO for contents they
+///          don't support.
 class MDPAModelPartIO final : public ModelPartIO
 {
 public:
@@ -47,6 +52,9 @@ private:
 }; // class MDPAModelPartIO
 
 
+/// @brief Salome's mesh format (*.med).
+/// @details Writing goes through @ref WriteMED, which writes nodes and connectivities in bulk,
+///          and falls back to @ref Kratos::MedModelPartIO for contents it doesn't support.
 class MedModelPartIO final : public ModelPartIO
 {
 public:
@@ -66,6 +74,37 @@ private:
 }; // class MedModelPartIO
 
 
+/** @brief Model part in an HDF5 file.
+ *  @details Default settings:
+ *           @code
+ *           {
+ *              "prefix" : "/ModelData",
+ *              "collective" : false,
+ *              "data_communicator" : "",
+ *              "chunk_size" : 1048576,
+ *              "filter" : "deflate",
+ *              "compression_level" : 0,
+ *              "entity_types" : [],
+ *              "sub_model_parts" : []
+ *           }
+ *           @endcode
+ *           - "prefix": group in the file holding the model part.
+ *           - "collective": use @ref WriteCollectiveHDF5 and @ref ReadCollectiveHDF5 instead of the
+ *             HDF5 application's layout. Each rank writes its partition into shared datasets with
+ *             collective MPI-IO, and reading repartitions the model part over any number of ranks.
+ *           - "data_communicator": name of the registered @ref DataCommunicator to open the file
+ *             with. Empty string => the model part's communicator.
+ *           - "chunk_size": approximate size of dataset chunks in bytes (collective only).
+ *           - "filter": compression filter of datasets, one of "none", "deflate", "zstd" or "szip"
+ *             (collective only). See @ref HDF5Filter.
+ *           - "compression_level": level of the filter, 0 disabling compression (collective only).
+ *             Deflate accepts 0-9, zstd 0-22, and szip takes the number of pixels per block instead.
+ *           - "entity_types": parts of the mesh to read besides the nodes: "Properties", "Elements",
+ *             "Conditions", "SubModelParts" or registered element and condition names. Empty => all
+ *             (collective only). See @ref CollectiveHDF5Settings::mEntityTypes.
+ *           - "sub_model_parts": names of the sub model parts to read, like "domain.inlet".
+ *             Empty => all (collective only).
+ */
 class HDF5ModelPartIO final : public ModelPartIO
 {
 public:
@@ -73,6 +112,8 @@ public:
 
     HDF5ModelPartIO(RightRef<std::filesystem::path> rFilePath);
 
+    HDF5ModelPartIO(RightRef<std::filesystem::path> rFilePath, Parameters Settings);
+
     ~HDF5ModelPartIO() override;
 
     void Read(Ref<ModelPart> rTarget) const override;
@@ -85,6 +126,72 @@ private:
 } ; // class HDF5ModelPartIO
 
 
+/// @brief Native binary snapshot of a model part's mesh (*.mdpb).
+/// @details Stores current and initial node coordinates as separate arrays, the connectivities
+///          of geometries, elements and conditions grouped by their registered names (in node
+///          indices), property IDs and the sub model part tree as index lists. All arrays are aligned
+///          so that reading maps the file and constructs the model part directly from it,
+///          without parsing anything. Nodal data, variables and property values are not stored.
+class BinaryModelPartIO final : public ModelPartIO
+{
+public:
+    BinaryModelPartIO();
+
+    explicit BinaryModelPartIO(RightRef<std::filesystem::path> rFilePath);
+
+    ~BinaryModelPartIO() override;
+
+    void Read(Ref<ModelPart> rTarget) const override;
+
+    void Write(Ref<const ModelPart> rSource) override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> mpImpl;
+}; // class BinaryModelPartIO
+
+
+/** @brief Decorator writing through another @ref ModelPartIO on a background thread.
+ *  @details @ref Write copies the mesh of the model part into a staging buffer and returns
+ *           as soon as the buffer is queued, instead of waiting for the file to be written.
+ *           The snapshot holds the node IDs with their initial and current coordinates, copies of
+ *           the properties and the process info, the connectivities of geometries, elements and
+ *           conditions (grouped by their registered names, in node indices) and the sub model part
+ *           tree as ID lists. A worker thread rebuilds a model part from each snapshot in a private
+ *           @ref Model and passes it to the wrapped IO, so the source model part can be modified or
+ *           destroyed right after @ref Write returns. Nodal solution step data, data values and
+ *           flags are not part of the snapshot.
+ *           At most @p QueueSize snapshots wait for the worker. @ref Write blocks while the queue
+ *           is full, so memory stays bounded if the solver outpaces the file system.
+ *           Errors of the worker are rethrown by the next call to @ref Write or @ref Flush, and
+ *           reported as warnings if the IO is destroyed before that.
+ *  @note Only serial model parts are supported: snapshots are rebuilt with the serial communicator
+ *        and hold no partitioning, so @ref Write throws for distributed model parts.
+ */
+class AsyncModelPartIO final : public ModelPartIO
+{
+public:
+    explicit AsyncModelPartIO(std::unique_ptr<ModelPartIO>&& pWrapped, std::size_t QueueSize = 1);
+
+    /// @brief Wait for pending writes, then stop the worker.
+    ~AsyncModelPartIO() override;
+
+    /// @brief Wait for pending writes, then read through the wrapped IO on the calling thread.
+    void Read(Ref<ModelPart> rTarget) const override;
+
+    /// @brief Snapshot the mesh of @p rSource and queue it for writing.
+    void Write(Ref<const ModelPart> rSource) override;
+
+    /// @brief Block until every queued snapshot is written, and rethrow the first error of the worker if there was one.
+    void Flush();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> mpImpl;
+}; // class AsyncModelPartIO
+
+
+/// @brief Construct an IO for a file, whose format @ref IORegistry detects from its contents when reading and from its extension when writing.
 std::unique_ptr<Kratos::UtilityApp::ModelPartIO> IOFactory(const std::filesystem::path& rFilePath);
 
 
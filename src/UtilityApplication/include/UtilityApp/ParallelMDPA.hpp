@@ -0,0 +1,56 @@
+/// @author Máté Kelemen
+
+#pragma once
+
+// --- Utility Includes ---
+#include "UtilityApp/common.hpp"
+
+// --- Core Includes ---
+#include "includes/model_part.h"
+
+// --- STL Includes ---
+#include <filesystem>
+
+
+namespace Kratos::UtilityApp {
+
+
+/** @brief Read an MDPA file, parsing its blocks in parallel.
+ *  @details The file is mapped and split into blocks, whose lines are then parsed concurrently
+ *           in chunks. Nodes, geometries, elements and conditions are constructed in parallel
+ *           and inserted into their containers in bulk, resulting in the same model part as
+ *           @ref Kratos::ModelPartIO. Supported blocks:
+ *           - @a Nodes, @a Geometries, @a Elements, @a Conditions
+ *           - @a Properties, @a ModelPartData (without data)
+ *           - @a SubModelPart with @a SubModelPartNodes, @a SubModelPartGeometries,
+ *             @a SubModelPartElements, @a SubModelPartConditions, @a SubModelPartProperties,
+ *             nested @a SubModelPart blocks and @a SubModelPartData / @a SubModelPartTables
+ *             without data.
+ *  @param rFilePath Path to the MDPA file, including its extension.
+ *  @param rTarget Root model part to read into.
+ *  @returns False if the file contains anything else (other blocks, property values, entities
+ *           that are not registered, references to missing nodes, etc.), or cannot be parsed.
+ *           @p rTarget is not modified in this case, and it's up to the caller to fall back to
+ *           @ref Kratos::ModelPartIO (which reports errors in the file).
+ */
+bool ReadMDPA(const std::filesystem::path& rFilePath, Ref<ModelPart> rTarget);
+
+
+/** @brief Write an MDPA file, formatting nodes and entities in parallel.
+ *  @details Lines are formatted with @a std::to_chars into per-thread buffers, which are written
+ *           to the file in order one batch at a time, so memory use does not grow with the model
+ *           part. Model part data and properties are written by @ref Kratos::ModelPartIO.
+ *           The output is meant to be byte for byte identical to that of @ref Kratos::ModelPartIO
+ *           with @a IO::SCIENTIFIC_PRECISION, whose number format is replicated here
+ *           (the mdpa_write_benchmark driver checks this).
+ *  @param rFilePath Path to the MDPA file, including its extension.
+ *  @param rSource Model part to write.
+ *  @returns False if @p rSource has anything besides nodes, elements, conditions, properties and
+ *           sub model parts (tables, geometries, constraints, variables or data values on any of
+ *           its entities). The file is not
+ *           created in this case, and it's up to the caller to fall back to @ref Kratos::ModelPartIO.
+ */
+bool WriteMDPA(const std::filesystem::path& rFilePath, Ref<const ModelPart> rSource);
+
+
+} // namespace Kratos::UtilityApp
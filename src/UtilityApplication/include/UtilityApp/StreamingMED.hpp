@@ -0,0 +1,36 @@
+/// @author Máté Kelemen
+
+#pragma once
+
+// --- Utility Includes ---
+#include "UtilityApp/common.hpp"
+
+// --- Core Includes ---
+#include "includes/model_part.h"
+
+// --- STL Includes ---
+#include <filesystem>
+
+
+namespace Kratos::UtilityApp {
+
+
+/** @brief Write the nodes, geometries and sub model parts of a model part into a MED file.
+ *  @details Node coordinates, and the connectivities of each geometry type are assembled in parallel
+ *           into contiguous arrays and written with a single MED call each. Sub model parts become
+ *           MED groups (named by their path relative to the root, like "domain.inlet") through
+ *           families of nodes and cells. Nodes of each geometry are permuted into MED's ordering
+ *           with the same fixed tables @ref Kratos::MedModelPartIO uses, so the file is read
+ *           exactly like one written by the MED application.
+ *  @param rFilePath Path to the MED file, including its extension. The file is written to
+ *                   "<rFilePath>.partial" first, and only replaces an existing file once it's complete.
+ *  @param rSource Model part to write.
+ *  @returns False if @p rSource has elements, conditions or geometry types MED or the MED application
+ *           cannot represent, IDs that overflow MED integers, or group names that are too long. The
+ *           file is not touched in this case, and it's up to the caller to fall back to
+ *           @ref Kratos::MedModelPartIO. Errors while writing throw, leaving existing files intact.
+ */
+bool WriteMED(const std::filesystem::path& rFilePath, Ref<const ModelPart> rSource);
+
+
+} // namespace Kratos::UtilityApp
@@ -19,9 +19,17 @@
 
 // Project includes
 #include "UtilityApp/AMGCLWrapper.hpp"
+#include "UtilityApp/AMGCLKrylovSolvers.hpp"
+#include "UtilityApp/MappedFile.hpp"
 #include "spaces/ublas_space.h"
 #include "utilities/profiler.h"
+#include "utilities/builtin_timer.h"
+#include "utilities/parallel_utilities.h"
+#include "utilities/reduction_utilities.h"
 #include "input_output/logger.h"
+#include "includes/variables.h"
+#include "includes/parallel_environment.h"
+#include "factories/linear_solver_factory.h"
 
 // External includes
 #include "amgcl/adapter/ublas.hpp"
@@ -29,9 +37,16 @@
 #include "amgcl/backend/builtin.hpp"
 #include "amgcl/value_type/static_matrix.hpp"
 #include "amgcl/make_solver.hpp"
-#include "amgcl/make_block_solver.hpp"
 #include "amgcl/solver/runtime.hpp"
 #include "amgcl/preconditioner/runtime.hpp"
+#include "amgcl/coarsening/runtime.hpp"
+#include "amgcl/relaxation/runtime.hpp"
+#include "amgcl/amg.hpp"
+#include "amgcl/coarsening/aggregation.hpp"
+#include "amgcl/coarsening/smoothed_aggregation.hpp"
+#include "amgcl/relaxation/ilu0.hpp"
+#include "amgcl/relaxation/spai0.hpp"
+#include "amgcl/solver/cg.hpp"
 #include "boost/property_tree/ptree.hpp"
 #include "boost/property_tree/json_parser.hpp"
 
@@ -40,9 +55,38 @@
 #include <amgcl/backend/vexcl_static_matrix.hpp>
 #endif
 
+#ifdef KRATOS_USING_MPI
+#include "mpi/includes/mpi_data_communicator.h"
+#include <amgcl/mpi/make_solver.hpp>
+#include <amgcl/mpi/amg.hpp>
+#include <amgcl/mpi/coarsening/runtime.hpp>
+#include <amgcl/mpi/relaxation/runtime.hpp>
+#include <amgcl/mpi/direct_solver/runtime.hpp>
+#include <amgcl/mpi/partition/runtime.hpp>
+#include <amgcl/mpi/solver/runtime.hpp>
+#endif
+
 // STL includes
 #include <sstream> // stringstream
+#include <algorithm> // any_of, find, lower_bound
 #include <variant> // variant
+#include <cstdint> // uint64_t
+#include <cstring> // memcpy
+#include <vector> // vector
+#include <memory> // unique_ptr, make_unique
+#include <deque> // deque
+#include <cmath> // ldexp
+#include <array> // array
+#include <numeric> // iota, partial_sum, exclusive_scan
+#include <limits> // numeric_limits
+#include <utility> // exchange
+#include <type_traits> // type_identity
+#include <optional> // optional
+#include <filesystem> // path, rename, file_size
+#include <fstream> // ifstream, ofstream
+#include <iomanip> // setw, setfill
+#include <random> // random_device
+#include <tuple> // tuple, tie
 
 
 namespace Kratos {
@@ -95,9 +139,15 @@ template <class TValue, unsigned TBlockSize>
 using AMGCLBlock = amgcl::static_matrix<TValue,TBlockSize,TBlockSize>;
 
 
+template <class TBackend>
+class RuntimePreconditioner;
+
+
 // Trait class defining an AMGCL backend for the provided template arguments,
-// and its associated preconditioner, wrapper, and solver.
-template <class TSparseSpace, unsigned TBlockSize>
+// and its associated preconditioner, wrapper, and solver. In mixed precision
+// mode, the preconditioner is stored and applied in single precision while the
+// iterative solver keeps operating on the backend's scalar type.
+template <class TSparseSpace, unsigned TBlockSize, bool TMixedPrecision = false>
 struct AMGCLTraits
 {
     template <template <class, class ...> class TBackend, class TValue, class ...TArgs>
@@ -118,6 +168,8 @@ struct AMGCLTraits
 
         constexpr static inline bool IsScalar = TBlockSize == 1;
 
+        constexpr static inline bool IsMixedPrecision = TMixedPrecision;
+
         using Scalar = TValue;
 
         using Value = std::conditional_t<
@@ -132,16 +184,17 @@ struct AMGCLTraits
             amgcl::static_matrix<TValue,TBlockSize,1>
         >;
 
-        using MatrixAdapter = std::conditional_t<
+        // Scalar type the preconditioner is stored and applied in.
+        using PrecondScalar = std::conditional_t<
+            IsMixedPrecision,
+            float,
+            Scalar
+        >;
+
+        using PrecondValue = std::conditional_t<
             IsScalar,
-            amgcl::backend::crs<Scalar>,
-            amgcl::adapter::block_matrix_adapter<
-                std::tuple<std::size_t,
-                           amgcl::iterator_range<const std::size_t*>,
-                           amgcl::iterator_range<const std::size_t*>,
-                           amgcl::iterator_range<const Scalar*>>,
-                Value
-            >
+            PrecondScalar,
+            amgcl::static_matrix<PrecondScalar,TBlockSize,TBlockSize>
         >;
 
         using Backend = std::conditional_t<
@@ -150,71 +203,1790 @@ struct AMGCLTraits
             TBackend<AMGCLBlock<TValue,TBlockSize>>
         >;
 
-        using Preconditioner = amgcl::runtime::preconditioner<Backend>;
-
-        using SolverWrapper = amgcl::runtime::solver::wrapper<Backend>;
-
-        using Solver = std::conditional_t<
+        using PrecondBackend = std::conditional_t<
             IsScalar,
-            amgcl::make_solver<Preconditioner,SolverWrapper>,
-            amgcl::make_block_solver<Preconditioner,SolverWrapper>
+            TBackend<PrecondScalar>,
+            TBackend<AMGCLBlock<PrecondScalar,TBlockSize>>
         >;
+
+        // Host side matrix type AMGCL builds its backend matrices from.
+        using BuildMatrix = typename amgcl::backend::builtin<Value>::matrix;
+
+        // Host side matrix type the hierarchy is constructed from (see MakeBuildMatrix).
+        using PrecondBuildMatrix = typename amgcl::backend::builtin<PrecondValue>::matrix;
+
+        using Preconditioner = RuntimePreconditioner<PrecondBackend>;
+
+        using SolverWrapper = UtilityApp::AMGCLSolverWrapper<Backend>;
+
+        // Block systems are fed to the solver as block valued PrecondBuildMatrix, and
+        // the system vectors are reinterpreted as arrays of RHS, so the solver itself
+        // operates on the block backend directly. amgcl::make_block_solver would wrap
+        // the already blocked matrix in a block_matrix_adapter.
+        using Solver = amgcl::make_solver<Preconditioner,SolverWrapper>;
     }; // struct Impl
 }; // struct AMGCLTraits
 
 
-// Wrapper class bundling a solver with an associated matrix adapter.
-template <class TAMGCLTraits>
-struct AMGCLBundle
-{
-    using Traits = TAMGCLTraits;
+template <template <class> class TCoarsening>
+struct CachedCoarsening;
+
+
+// Trait class of a compile-time configured solver: AMG with the provided coarsening
+// and relaxation, and CG. Everything else is inherited from the runtime traits.
+// Relaxation and coarsening calls are resolved statically instead of being dispatched
+// through amgcl::runtime wrappers. The coarsening is wrapped in a CachedCoarsening,
+// which forwards to it directly unless a hierarchy cache is requested.
+template <class TRuntimeTraits,
+          template <class> class TCoarsening,
+          template <class> class TRelaxation>
+struct AMGCLStaticTraits : public TRuntimeTraits
+{
+    using Preconditioner = amgcl::amg<typename TRuntimeTraits::PrecondBackend,
+                                      CachedCoarsening<TCoarsening>::template type,
+                                      TRelaxation>;
+
+    using SolverWrapper = amgcl::solver::cg<typename TRuntimeTraits::Backend>;
+
+    using Solver = amgcl::make_solver<Preconditioner,SolverWrapper>;
+}; // struct AMGCLStaticTraits
+
+
+// Settings of a runtime configuration that has a compile-time counterpart.
+struct AMGCLStaticConfiguration
+{
+    std::string mCoarsening;
+
+    std::string mRelaxation;
+
+    // Settings without the runtime type selectors, which the static components reject.
+    boost::property_tree::ptree mSettings;
+}; // struct AMGCLStaticConfiguration
+
+
+// Check whether the runtime settings describe AMG with aggregation or smoothed aggregation,
+// ILU0 or SPAI0 relaxation, and CG, i.e. one of the compile-time configured solvers.
+inline std::optional<AMGCLStaticConfiguration> MatchStaticConfiguration(const boost::property_tree::ptree& rSettings)
+{
+    // Defaults of amgcl::runtime components
+    const std::string precond_class = rSettings.get<std::string>("precond.class", "amg");
+    const std::string coarsening = rSettings.get<std::string>("precond.coarsening.type", "smoothed_aggregation");
+    const std::string relaxation = rSettings.get<std::string>("precond.relax.type", "spai0");
+    const std::string solver = rSettings.get<std::string>("solver.type", "bicgstab");
+
+    if (precond_class != "amg"
+        || (coarsening != "aggregation" && coarsening != "smoothed_aggregation")
+        || (relaxation != "ilu0" && relaxation != "spai0")
+        || solver != "cg") {
+        return {};
+    }
+
+    AMGCLStaticConfiguration output {coarsening, relaxation, rSettings};
+    const auto erase = [&output](const std::string& rParent, const std::string& rKey) {
+        if (auto p_child = output.mSettings.get_child_optional(rParent)) p_child->erase(rKey);
+    };
+    erase("precond", "class");
+    erase("precond.coarsening", "type");
+    erase("precond.relax", "type");
+    erase("solver", "type");
+    return output;
+}
+
+
+// Check whether a solver accepts the provided settings without constructing it.
+template <class TSolver>
+bool AcceptsSettings(const boost::property_tree::ptree& rSettings)
+{
+    try {
+        [[maybe_unused]] const typename TSolver::params parameters(rSettings);
+        return true;
+    } catch (Exception&) {
+        return false;
+    }
+}
+
+
+// Convert Parameters to the property tree AMGCL parses its settings from, without a round
+// trip through JSON text. Arrays become children with empty keys, as in boost::property_tree::read_json.
+inline boost::property_tree::ptree MakePropertyTree(Parameters Settings)
+{
+    boost::property_tree::ptree output;
+    if (Settings.IsSubParameter()) {
+        for (auto it_item=Settings.begin(); it_item!=Settings.end(); ++it_item) {
+            output.push_back({it_item.name(), MakePropertyTree(*it_item)});
+        }
+    } else if (Settings.IsArray()) {
+        for (std::size_t i_item=0; i_item<Settings.size(); ++i_item) {
+            output.push_back({"", MakePropertyTree(Settings[i_item])});
+        }
+    } else if (Settings.IsBool()) {
+        output.put_value(Settings.GetBool());
+    } else if (Settings.IsInt()) {
+        output.put_value(Settings.GetInt());
+    } else if (Settings.IsDouble()) {
+        output.put_value(Settings.GetDouble());
+    } else if (Settings.IsString()) {
+        output.put_value(Settings.GetString());
+    }
+    return output;
+}
+
+
+// Copy a host side CRS matrix into freshly allocated arrays that are first written
+// in parallel over contiguous ranges of rows, so that their pages get allocated on the
+// NUMA node of the thread that processes the same rows in AMGCL's statically scheduled
+// loops (SpMV, smoothers).
+template <class TMatrix>
+std::shared_ptr<TMatrix> MakeFirstTouchCopy(const TMatrix& rMatrix)
+{
+    using Value = typename TMatrix::value_type;
+    using Column = std::remove_cv_t<std::remove_pointer_t<decltype(TMatrix::col)>>;
+    using Row = std::remove_cv_t<std::remove_pointer_t<decltype(TMatrix::ptr)>>;
+
+    // new[] leaves trivial types uninitialized, so the pages are not touched yet.
+    auto p_copy = std::make_shared<TMatrix>();
+    p_copy->nrows = rMatrix.nrows;
+    p_copy->ncols = rMatrix.ncols;
+    p_copy->nnz = rMatrix.nnz;
+    p_copy->ptr = new Row[rMatrix.nrows + 1];
+    p_copy->col = new Column[rMatrix.nnz];
+    p_copy->val = new Value[rMatrix.nnz];
+
+    p_copy->ptr[0] = rMatrix.ptr[0];
+    IndexPartition<std::size_t>(rMatrix.nrows).for_each([&rMatrix, &p_copy](std::size_t i_row) {
+        p_copy->ptr[i_row + 1] = rMatrix.ptr[i_row + 1];
+        for (auto i_entry=rMatrix.ptr[i_row]; i_entry<rMatrix.ptr[i_row + 1]; ++i_entry) {
+            p_copy->col[i_entry] = rMatrix.col[i_entry];
+            p_copy->val[i_entry] = rMatrix.val[i_entry];
+        }
+    });
+
+    return p_copy;
+}
+
+
+// Construct the host side CRS matrix AMGCL builds its backend matrices from directly from
+// the arrays of a ublas compressed matrix, without going through amgcl::backend::map and
+// an adapter:
+// - scalar matrices of the same value type are wrapped without copying anything, so the
+//   ublas matrix must outlive the result and every hierarchy constructed from it. If
+//   FirstTouch is set, they are copied with MakeFirstTouchCopy instead.
+// - scalar matrices of other value types (mixed precision) are converted.
+// - block matrices are grouped into TValue blocks by merging the sorted columns of
+//   the scalar rows in each block row, in parallel over block rows.
+template <class TValue, class TMatrix>
+std::shared_ptr<typename amgcl::backend::builtin<TValue>::matrix> MakeBuildMatrix(const TMatrix& rMatrix, bool FirstTouch = false)
+{
+    using Output = typename amgcl::backend::builtin<TValue>::matrix;
+    constexpr std::size_t block_size = amgcl::math::static_rows<TValue>::value;
+
+    const std::size_t* p_row_extents = &*rMatrix.index1_data().begin();
+    const std::size_t* p_columns = &*rMatrix.index2_data().begin();
+    const auto* p_values = &*rMatrix.value_data().begin();
+
+    if constexpr (block_size == 1 && std::is_same_v<TValue,typename TMatrix::value_type>) {
+        auto p_output = amgcl::adapter::zero_copy(rMatrix.size1(), p_row_extents, p_columns, p_values);
+        if (FirstTouch) return MakeFirstTouchCopy(*p_output);
+        return p_output;
+    } else {
+        const std::size_t row_count = rMatrix.size1() / block_size;
+
+        // Visit the block columns of a block row in ascending order, along with the
+        // scalar entries they consist of.
+        const auto for_each_block = [=](std::size_t iBlockRow, auto&& rOnBlock, auto&& rOnEntry) {
+            std::array<std::size_t,block_size> cursors, ends;
+            for (std::size_t i_row=0; i_row<block_size; ++i_row) {
+                cursors[i_row] = p_row_extents[iBlockRow * block_size + i_row];
+                ends[i_row] = p_row_extents[iBlockRow * block_size + i_row + 1];
+            }
+
+            while (true) {
+                std::size_t block_column = std::numeric_limits<std::size_t>::max();
+                for (std::size_t i_row=0; i_row<block_size; ++i_row) {
+                    if (cursors[i_row] < ends[i_row]) {
+                        block_column = std::min(block_column, p_columns[cursors[i_row]] / block_size);
+                    }
+                }
+                if (block_column == std::numeric_limits<std::size_t>::max()) break;
+
+                rOnBlock(block_column);
+                for (std::size_t i_row=0; i_row<block_size; ++i_row) {
+                    for (; cursors[i_row] < ends[i_row] && p_columns[cursors[i_row]] / block_size == block_column; ++cursors[i_row]) {
+                        rOnEntry(i_row, p_columns[cursors[i_row]] % block_size, p_values[cursors[i_row]]);
+                    }
+                }
+            }
+        };
+
+        auto p_output = std::make_shared<Output>();
+        p_output->set_size(row_count, rMatrix.size2() / block_size, /*clean_ptr=*/true);
+
+        // Count the blocks in each block row ...
+        IndexPartition<std::size_t>(row_count).for_each([&p_output, &for_each_block](std::size_t i_block_row) {
+            std::size_t block_count = 0;
+            for_each_block(i_block_row, [&block_count](std::size_t) {++block_count;}, [](auto...) {});
+            p_output->ptr[i_block_row + 1] = block_count;
+        });
+        std::partial_sum(p_output->ptr, p_output->ptr + row_count + 1, p_output->ptr);
+
+        // ... then fill them.
+        p_output->set_nonzeros(p_output->ptr[row_count]);
+        IndexPartition<std::size_t>(row_count).for_each([&p_output, &for_each_block](std::size_t i_block_row) {
+            auto i_block = p_output->ptr[i_block_row];
+            for_each_block(
+                i_block_row,
+                [&p_output, &i_block](std::size_t BlockColumn) {
+                    p_output->col[i_block] = BlockColumn;
+                    p_output->val[i_block++] = amgcl::math::zero<TValue>();
+                },
+                [&p_output, &i_block](std::size_t iRow, std::size_t iColumn, auto Value) {
+                    if constexpr (block_size == 1) {
+                        p_output->val[i_block - 1] = static_cast<TValue>(Value);
+                    } else {
+                        p_output->val[i_block - 1](iRow, iColumn) = static_cast<typename amgcl::math::scalar_of<TValue>::type>(Value);
+                    }
+                });
+        });
+
+        return p_output;
+    }
+}
+
+
+// Hash of an array's bit patterns. Each entry is salted with its index, so permuting the
+// entries changes the hash, but the sum reduction lets the entries be hashed in parallel.
+template <class T>
+std::uint64_t HashArray(const T* pBegin, std::size_t Size)
+{
+    static_assert(sizeof(T) <= sizeof(std::uint64_t));
+    return IndexPartition<std::size_t>(Size).template for_each<SumReduction<std::uint64_t>>(
+        [pBegin](std::size_t Index) -> std::uint64_t {
+            std::uint64_t bits = 0;
+            std::memcpy(&bits, pBegin + Index, sizeof(T));
+
+            // splitmix64 on the bits salted with the index.
+            std::uint64_t hash = bits ^ (Index * 0x9e3779b97f4a7c15ull);
+            hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+            hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+            return hash ^ (hash >> 31);
+        });
+}
+
+
+// Hierarchy related part of AMGCLSolveStatistics.
+struct HierarchyStatistics
+{
+    double mOperatorComplexity = 0.0;
+
+    double mGridComplexity = 0.0;
+
+    std::vector<AMGCLLevelStatistics> mLevels;
+}; // struct HierarchyStatistics
+
+
+// Size of a builtin CRS matrix' arrays in bytes.
+template <class TMatrix>
+std::size_t GetMatrixBytes(const TMatrix& rMatrix) noexcept
+{
+    return (rMatrix.nrows + 1) * sizeof(*rMatrix.ptr) + rMatrix.nnz * (sizeof(*rMatrix.col) + sizeof(*rMatrix.val));
+}
+
+
+// Collects the levels of the AMG hierarchy being constructed on the current thread.
+// AMGCL keeps its levels to itself, but every level matrix passes through the coarsening
+// (see CachedCoarsening), which reports them to the active recorder. AMGCL invokes the
+// coarsening on the thread constructing the hierarchy, so recorders are thread local.
+class LevelStatisticsRecorder
+{
+public:
+    // Activate the recorder with the finest level matrix.
+    template <class TMatrix>
+    explicit LevelStatisticsRecorder(const TMatrix& rFineMatrix)
+        : mpPrevious(std::exchange(GetActiveReference(), this))
+    {
+        this->AddLevel(rFineMatrix);
+    }
+
+    ~LevelStatisticsRecorder()
+    {
+        GetActiveReference() = mpPrevious;
+    }
+
+    static LevelStatisticsRecorder* GetActive() noexcept
+    {
+        return GetActiveReference();
+    }
+
+    // Add the transfer operators of the last recorded level to its memory footprint.
+    template <class TMatrix>
+    void AddTransferOperators(const TMatrix& rP, const TMatrix& rR)
+    {
+        mLevels.back().mMemory += GetMatrixBytes(rP) + GetMatrixBytes(rR);
+    }
+
+    template <class TMatrix>
+    void AddLevel(const TMatrix& rMatrix)
+    {
+        AMGCLLevelStatistics level;
+        level.mRowCount = amgcl::backend::rows(rMatrix);
+        level.mNonZeroCount = amgcl::backend::nonzeros(rMatrix);
+        level.mMemory = GetMatrixBytes(rMatrix);
+        mLevels.push_back(level);
+    }
+
+    HierarchyStatistics Get() const
+    {
+        HierarchyStatistics output;
+        output.mLevels = mLevels;
+
+        std::size_t row_count = 0, nonzero_count = 0;
+        for (const auto& r_level : mLevels) {
+            row_count += r_level.mRowCount;
+            nonzero_count += r_level.mNonZeroCount;
+        }
+        const auto& r_finest = mLevels.front();
+        if (r_finest.mRowCount) output.mGridComplexity = static_cast<double>(row_count) / r_finest.mRowCount;
+        if (r_finest.mNonZeroCount) output.mOperatorComplexity = static_cast<double>(nonzero_count) / r_finest.mNonZeroCount;
+        return output;
+    }
+
+    LevelStatisticsRecorder(const LevelStatisticsRecorder&) = delete;
+
+private:
+    static LevelStatisticsRecorder*& GetActiveReference() noexcept
+    {
+        thread_local LevelStatisticsRecorder* p_active = nullptr;
+        return p_active;
+    }
+
+    LevelStatisticsRecorder* mpPrevious;
+
+    std::vector<AMGCLLevelStatistics> mLevels;
+}; // class LevelStatisticsRecorder
+
+
+// System vectors handed to the AMGCL solver.
+// Host backends operate on the caller's vectors directly, so transfers are no-ops
+// and the accessors return views on the provided arrays.
+template <class TAMGCLTraits, class = void>
+struct SystemVectors
+{
+    using RHS = typename TAMGCLTraits::RHS;
+
+    void Allocate(std::size_t) noexcept {}
+
+    void UploadRHS(const RHS*, bool) noexcept {}
+
+    void UploadSolution(const RHS*) noexcept {}
+
+    void DownloadSolution(RHS*) noexcept {}
+
+    auto GetRHS(RHS* pB, std::size_t Size) const noexcept {return boost::make_iterator_range(pB, pB + Size);}
+
+    auto GetSolution(RHS* pX, std::size_t Size) const noexcept {return boost::make_iterator_range(pX, pX + Size);}
+}; // struct SystemVectors
+
+
+#ifdef AMGCL_GPGPU
+// Device backends keep their buffers alive across solves. The right hand side is
+// uploaded once per solve (asynchronously while the hierarchy is constructed, if
+// possible, and again if its contents changed since), and the solution vector is
+// only uploaded if it holds a nonzero initial guess. Operations are enqueued on the
+// same in-order queues the solver uses.
+template <class TAMGCLTraits>
+struct SystemVectors<TAMGCLTraits,std::enable_if_t<TAMGCLTraits::IsGPUBound>>
+{
+    using RHS = typename TAMGCLTraits::RHS;
+
+    void Allocate(std::size_t Size)
+    {
+        if (!mpB || mpB->size() != Size) {
+            auto& r_context = GetVexCLContext();
+            KRATOS_ERROR_IF_NOT(r_context) << "invalid VexCL context state\n";
+            mpB = std::make_unique<vex::vector<RHS>>(r_context, Size);
+            mpX = std::make_unique<vex::vector<RHS>>(r_context, Size);
+        }
+        mpUploadedRHS = nullptr;
+    }
+
+    void UploadRHS(const RHS* pB, bool Blocking)
+    {
+        // The right hand side may already be uploaded (or in flight) since the
+        // hierarchy was constructed, but the caller may have modified it since.
+        const std::uint64_t hash = HashArray(reinterpret_cast<const typename TAMGCLTraits::Scalar*>(pB),
+                                             mpB->size() * TAMGCLTraits::BlockSize);
+        if (pB != mpUploadedRHS || hash != mUploadedRHSHash) {
+            mpB->write_data(0, mpB->size(), pB, Blocking);
+            mpUploadedRHS = pB;
+            mUploadedRHSHash = hash;
+        }
+    }
+
+    void UploadSolution(const RHS* pX)
+    {
+        const auto p_begin = reinterpret_cast<const typename TAMGCLTraits::Scalar*>(pX);
+        const auto p_end = p_begin + mpX->size() * TAMGCLTraits::BlockSize;
+        if (std::any_of(p_begin, p_end, [](auto Value) {return Value != 0;})) {
+            mpX->write_data(0, mpX->size(), pX, false);
+        } else {
+            amgcl::backend::clear(*mpX);
+        }
+    }
+
+    void DownloadSolution(RHS* pX)
+    {
+        vex::copy(mpX->begin(), mpX->end(), pX);
+        mpUploadedRHS = nullptr;
+    }
+
+    vex::vector<RHS>& GetRHS(RHS*, std::size_t) noexcept {return *mpB;}
+
+    vex::vector<RHS>& GetSolution(RHS*, std::size_t) noexcept {return *mpX;}
+
+    std::unique_ptr<vex::vector<RHS>> mpB;
+
+    std::unique_ptr<vex::vector<RHS>> mpX;
+
+    // Host array the current contents of mpB were uploaded from, and the hash of its values at that time.
+    const RHS* mpUploadedRHS = nullptr;
+
+    std::uint64_t mUploadedRHSHash = 0;
+}; // struct SystemVectors
+#endif
+
+
+// Wrapper class bundling a solver with the matrix its hierarchy was constructed from.
+template <class TAMGCLTraits>
+struct AMGCLBundle
+{
+    using Traits = TAMGCLTraits;
+
+    std::unique_ptr<typename Traits::Solver> mpSolver;
+
+    // Matrix the hierarchy was constructed from. Refers to the system matrix'
+    // arrays if no conversion is necessary (see MakeBuildMatrix).
+    std::shared_ptr<typename Traits::PrecondBuildMatrix> mpMatrix;
+
+    // System matrix on the backend that the iterative solver uses instead of
+    // the preconditioner's own copy. Only set if the system matrix changed
+    // since the hierarchy was constructed (see @ref UpdateSystemMatrix).
+    std::shared_ptr<typename Traits::Backend::matrix> mpSystemMatrix;
+
+    // Solution and right hand side vectors on the backend.
+    SystemVectors<Traits> mSystemVectors;
+
+    // Levels of the hierarchy recorded during its construction.
+    // Empty if the preconditioner is not AMG.
+    HierarchyStatistics mHierarchyStatistics;
+
+    // Copy the system matrix with parallel first touch instead of referencing it
+    // (see MakeFirstTouchCopy). Set by @a "precond.coarsening.first_touch".
+    bool mFirstTouch = false;
+
+    // Settings the solver was constructed with, for constructing copies of the bundle.
+    boost::property_tree::ptree mSettings;
+
+    /// @brief Construct an AMGCL solver and its supporting variables.
+    /// @details The constructor has 2 main jobs to take care of:
+    ///          - construct the matrix AMGCL builds its hierarchy from. Scalar systems
+    ///            are referenced in place if the preconditioner's and sparse space's
+    ///            scalar types match, and copied otherwise. Block backends get a copy
+    ///            grouped into @ref AMGCLBlock "blocks".
+    ///          - construct the AMGCL solver from that matrix, without AMGCL copying it again.
+    ///          Device backends additionally begin uploading the right hand side
+    ///          before constructing the solver, overlapping the transfer with the setup.
+    ///          The AMGCL backend type depends on the @ref AMGCLTraits::Impl
+    ///          type that this class is instantiated with (@a TAMGCLTraits).
+    ///          - CPU or GPU backend
+    ///          - single or double precision scalar type
+    ///          - single precision preconditioner (mixed precision)
+    ///          - block size
+    /// @note The system matrix must outlive the bundle, since the hierarchy may refer to its arrays.
+    AMGCLBundle(const typename TAMGCLTraits::SparseSpace::MatrixType& rSystemMatrix,
+                const typename TAMGCLTraits::SparseSpace::VectorType& rRHS,
+                const boost::property_tree::ptree& rSolverSettings)
+        : mpSolver(),
+          mpMatrix(),
+          mFirstTouch(!TAMGCLTraits::IsGPUBound && rSolverSettings.get<bool>("precond.coarsening.first_touch", false)),
+          mSettings(rSolverSettings)
+    {
+        KRATOS_TRY
+
+        KRATOS_ERROR_IF(rSystemMatrix.size1() % TAMGCLTraits::BlockSize)
+            << "system size " << rSystemMatrix.size1()
+            << " is not divisible by the block size " << TAMGCLTraits::BlockSize << "\n";
+
+        mSystemVectors.Allocate(rSystemMatrix.size1() / TAMGCLTraits::BlockSize);
+        mSystemVectors.UploadRHS(reinterpret_cast<const typename TAMGCLTraits::RHS*>(&*rRHS.begin()),
+                                 /*Blocking=*/false);
+
+        // Reference or copy the system matrix.
+        mpMatrix = MakeBuildMatrix<typename TAMGCLTraits::PrecondValue>(rSystemMatrix, mFirstTouch);
+
+        // Block values already group the DoFs of a node, so pointwise
+        // aggregation must not group them a second time.
+        const boost::property_tree::ptree* p_settings = &rSolverSettings;
+        boost::property_tree::ptree block_settings;
+        if constexpr (!TAMGCLTraits::IsScalar) {
+            if (rSolverSettings.get_child_optional("precond.coarsening.aggr.block_size")) {
+                block_settings = rSolverSettings;
+                block_settings.put("precond.coarsening.aggr.block_size", 1);
+                p_settings = &block_settings;
+            }
+        }
+
+        // Construct solver
+        {
+            LevelStatisticsRecorder recorder(*mpMatrix);
+            mpSolver = std::make_unique<typename TAMGCLTraits::Solver>(mpMatrix,
+                                                                       *p_settings,
+                                                                       MakeBackendParameters());
+            bool is_hierarchy = true;
+            if constexpr (requires {mpSolver->precond().IsHierarchy();}) {
+                is_hierarchy = mpSolver->precond().IsHierarchy();
+            }
+            if (is_hierarchy) mHierarchyStatistics = recorder.Get();
+        }
+
+        // The preconditioner's copy of the system matrix is in single precision
+        // in mixed precision mode => the iterative solver needs its own.
+        if constexpr (TAMGCLTraits::IsMixedPrecision) {
+            UpdateSystemMatrix(rSystemMatrix);
+        }
+
+        KRATOS_CATCH("")
+    }
+
+    /// @brief Update the matrix the iterative solver operates on, but keep the preconditioner.
+    /// @details The hierarchy remains the one constructed from the original matrix, so
+    ///          it's up to the caller to decide whether it is still a good enough
+    ///          preconditioner for the new system.
+    void UpdateSystemMatrix(const typename TAMGCLTraits::SparseSpace::MatrixType& rSystemMatrix)
+    {
+        KRATOS_TRY
+        mpSystemMatrix = TAMGCLTraits::Backend::copy_matrix(MakeBuildMatrix<typename TAMGCLTraits::Value>(rSystemMatrix, mFirstTouch),
+                                                            MakeBackendParameters());
+        KRATOS_CATCH("")
+    }
+
+    static typename TAMGCLTraits::Backend::params MakeBackendParameters()
+    {
+        typename TAMGCLTraits::Backend::params backend_parameters;
+        if constexpr (TAMGCLTraits::IsGPUBound) {
+            #ifdef AMGCL_GPGPU
+                backend_parameters.q = GetVexCLContext();
+            #else
+                KRATOS_ERROR << "internal solver error: requesting a GPU solver while Kratos is compiled without GPU support\n";
+            #endif
+        }
+        return backend_parameters;
+    }
+
+    AMGCLBundle(AMGCLBundle&&) = delete;
+
+    AMGCLBundle(const AMGCLBundle&) = delete;
+}; // struct AMGCLBundle
+
+
+// Solve a system with a bundle, transferring the vectors to and from its backend.
+// Returns the iteration count and the relative residual reported by AMGCL.
+template <class TBundle, class TVector>
+std::tuple<std::size_t,double> SolveWithBundle(TBundle& rBundle, TVector& rX, TVector& rB)
+{
+    using RHS = typename TBundle::Traits::RHS;
+    const std::size_t system_block_size = rX.size() / TBundle::Traits::BlockSize;
+    RHS* x_begin = reinterpret_cast<RHS*>(&*rX.begin());
+    RHS* b_begin = reinterpret_cast<RHS*>(&*rB.begin());
+
+    // Transfer system vectors to the backend (no-op on the host).
+    auto& r_vectors = rBundle.mSystemVectors;
+    r_vectors.UploadRHS(b_begin, /*Blocking=*/true);
+    r_vectors.UploadSolution(x_begin);
+    auto&& r_b = r_vectors.GetRHS(b_begin, system_block_size);
+    auto&& r_x = r_vectors.GetSolution(x_begin, system_block_size);
+
+    // Solve
+    const auto results = rBundle.mpSystemMatrix
+        ? rBundle.mpSolver->operator()(*rBundle.mpSystemMatrix, r_b, r_x)
+        : rBundle.mpSolver->operator()(r_b, r_x);
+
+    // Fetch the solution from the backend (no-op on the host) and return
+    r_vectors.DownloadSolution(x_begin);
+    return results;
+}
+
+
+#ifdef KRATOS_USING_MPI
+// Solver for systems distributed over MPI ranks.
+// Each rank provides the strip of rows it owns, in ascending global order
+// across ranks, with global column indices (see DistributedPartition).
+// Only the scalar CPU backend is supported.
+template <class TSparseSpace>
+struct AMGCLDistributedBundle
+{
+    using Scalar = typename TSparseSpace::DataType;
+
+    using Backend = amgcl::backend::builtin<Scalar>;
+
+    using Solver = amgcl::mpi::make_solver<
+        amgcl::mpi::amg<
+            Backend,
+            amgcl::runtime::mpi::coarsening::wrapper<Backend>,
+            amgcl::runtime::mpi::relaxation::wrapper<Backend>,
+            amgcl::runtime::mpi::direct::solver<Scalar>,
+            amgcl::runtime::mpi::partition::wrapper<Backend>
+        >,
+        amgcl::runtime::mpi::solver::wrapper<Backend>
+    >;
+
+    std::unique_ptr<Solver> mpSolver;
+
+    AMGCLDistributedBundle(const typename TSparseSpace::MatrixType& rLocalRows,
+                           MPI_Comm Communicator,
+                           const boost::property_tree::ptree& rSolverSettings)
+    {
+        KRATOS_TRY
+        // The distributed AMG has no preconditioner class selector.
+        boost::property_tree::ptree settings = rSolverSettings;
+        if (auto p_precond = settings.get_child_optional("precond")) p_precond->erase("class");
+
+        mpSolver = std::make_unique<Solver>(amgcl::mpi::communicator(Communicator),
+                                            amgcl::backend::map(rLocalRows),
+                                            settings);
+        KRATOS_CATCH("")
+    }
+
+    std::tuple<std::size_t,double> Solve(const typename TSparseSpace::VectorType& rB,
+                                         typename TSparseSpace::VectorType& rX)
+    {
+        const Scalar* p_b = &*rB.begin();
+        Scalar* p_x = &*rX.begin();
+        return (*mpSolver)(boost::make_iterator_range(p_b, p_b + rB.size()),
+                           boost::make_iterator_range(p_x, p_x + rX.size()));
+    }
+}; // struct AMGCLDistributedBundle
+
+// MPI datatype of the items exchanged by ExchangeWithAll.
+template <class T>
+MPI_Datatype GetMPIDatatype() noexcept
+{
+    if constexpr (std::is_same_v<T,double>) return MPI_DOUBLE;
+    else if constexpr (std::is_same_v<T,float>) return MPI_FLOAT;
+    else {
+        static_assert(std::is_same_v<T,std::uint64_t>);
+        return MPI_UINT64_T;
+    }
+}
+
+
+// Send rSend[i_rank] to each rank, and return what each rank sent to this one.
+template <class T>
+std::vector<std::vector<T>> ExchangeWithAll(const std::vector<std::vector<T>>& rSend, MPI_Comm Communicator)
+{
+    KRATOS_TRY
+    const std::size_t rank_count = rSend.size();
+    std::vector<int> send_counts(rank_count), send_offsets(rank_count), receive_counts(rank_count), receive_offsets(rank_count);
+    for (std::size_t i_rank=0; i_rank<rank_count; ++i_rank) send_counts[i_rank] = static_cast<int>(rSend[i_rank].size());
+
+    KRATOS_ERROR_IF(MPI_Alltoall(send_counts.data(), 1, MPI_INT, receive_counts.data(), 1, MPI_INT, Communicator) != MPI_SUCCESS)
+        << "failed to exchange message sizes\n";
+    std::exclusive_scan(send_counts.begin(), send_counts.end(), send_offsets.begin(), 0);
+    std::exclusive_scan(receive_counts.begin(), receive_counts.end(), receive_offsets.begin(), 0);
+
+    std::vector<T> send_buffer, receive_buffer(receive_offsets.back() + receive_counts.back());
+    send_buffer.reserve(send_offsets.back() + send_counts.back());
+    for (const auto& r_items : rSend) send_buffer.insert(send_buffer.end(), r_items.begin(), r_items.end());
+
+    KRATOS_ERROR_IF(MPI_Alltoallv(send_buffer.data(), send_counts.data(), send_offsets.data(), GetMPIDatatype<T>(),
+                                  receive_buffer.data(), receive_counts.data(), receive_offsets.data(), GetMPIDatatype<T>(),
+                                  Communicator) != MPI_SUCCESS)
+        << "failed to exchange messages\n";
+
+    std::vector<std::vector<T>> output(rank_count);
+    for (std::size_t i_rank=0; i_rank<rank_count; ++i_rank) {
+        const auto it_begin = receive_buffer.begin() + receive_offsets[i_rank];
+        output[i_rank].assign(it_begin, it_begin + receive_counts[i_rank]);
+    }
+    return output;
+    KRATOS_CATCH("")
+}
+
+
+// Maps the system a rank assembled over its own DoF set (owned and ghost DoFs, numbered by
+// their local equation IDs) onto the strip of rows it owns in the global system, which is
+// what AMGCLDistributedBundle expects:
+// - owned rows are numbered contiguously in the order of their local equation IDs, in
+//   ascending order across ranks.
+// - ghost DoFs get the global IDs their owners assigned them, matched by node ID and variable.
+// - the rows and right hand side entries of ghost DoFs are partial contributions, so they are
+//   added to the rows of their owners.
+// - owners send the solution of their rows back to the ranks that hold them as ghosts.
+template <class TSparseSpace>
+struct DistributedPartition
+{
+    using Scalar = typename TSparseSpace::DataType;
+
+    static constexpr std::uint64_t InvalidId = std::numeric_limits<std::uint64_t>::max();
+
+    MPI_Comm mCommunicator;
+
+    std::size_t mGlobalSize = 0;
+
+    // Global ID of this rank's first owned row.
+    std::size_t mFirstRow = 0;
+
+    // Global ID of each local equation ID.
+    std::vector<std::uint64_t> mGlobalIds;
+
+    // Local equation IDs of the owned rows, in the order of their global IDs.
+    std::vector<std::size_t> mOwnedRows;
+
+    // Local equation IDs of ghost DoFs, grouped by their owners.
+    std::vector<std::vector<std::size_t>> mGhostRows;
+
+    // Strip rows of the ghost DoFs each rank holds of this one, in the order of its mGhostRows.
+    std::vector<std::vector<std::size_t>> mReceivedRows;
+
+    // Owned rows with global column indices.
+    typename TSparseSpace::MatrixType mStrip;
+
+    typename TSparseSpace::VectorType mStripB, mStripX;
+
+    // DoFs with equation IDs beyond the system size are skipped (e.g.: fixed DoFs
+    // eliminated from the system by the builder).
+    DistributedPartition(const ModelPart::DofsArrayType& rDofs,
+                         std::size_t SystemSize,
+                         const DataCommunicator& rCommunicator)
+        : mCommunicator(MPIDataCommunicator::GetMPICommunicator(rCommunicator))
+    {
+        KRATOS_TRY
+        const int rank = rCommunicator.Rank();
+        const std::size_t rank_count = rCommunicator.Size();
+
+        // Collect owned DoFs as (node ID, variable key, local equation ID),
+        // and requests for the global IDs of ghost DoFs as (node ID, variable key).
+        std::vector<std::array<std::uint64_t,3>> owned_dofs;
+        std::vector<std::vector<std::uint64_t>> requests(rank_count);
+        mGhostRows.resize(rank_count);
+        for (const auto& r_dof : rDofs) {
+            const std::size_t equation_id = r_dof.EquationId();
+            if (SystemSize <= equation_id) continue;
+
+            const int owner = r_dof.GetSolutionStepValue(PARTITION_INDEX);
+            KRATOS_ERROR_IF(owner < 0 || rank_count <= static_cast<std::size_t>(owner))
+                << "DoF " << r_dof.GetVariable().Name() << " of node " << r_dof.Id()
+                << " has an invalid PARTITION_INDEX " << owner << "\n";
+
+            if (owner == rank) {
+                owned_dofs.push_back({r_dof.Id(), r_dof.GetVariable().Key(), equation_id});
+            } else {
+                requests[owner].push_back(r_dof.Id());
+                requests[owner].push_back(r_dof.GetVariable().Key());
+                mGhostRows[owner].push_back(equation_id);
+            }
+        }
+
+        // Number the owned rows.
+        std::sort(owned_dofs.begin(), owned_dofs.end(), [](const auto& rLeft, const auto& rRight) {return rLeft[2] < rRight[2];});
+        mGlobalSize = rCommunicator.SumAll(owned_dofs.size());
+        mFirstRow = rCommunicator.ScanSum(owned_dofs.size()) - owned_dofs.size();
+        mGlobalIds.assign(SystemSize, InvalidId);
+        mOwnedRows.resize(owned_dofs.size());
+        for (std::size_t i_row=0; i_row<owned_dofs.size(); ++i_row) {
+            mOwnedRows[i_row] = owned_dofs[i_row][2];
+            mGlobalIds[owned_dofs[i_row][2]] = mFirstRow + i_row;
+        }
+
+        // Resolve the requests for the global IDs of owned DoFs.
+        std::sort(owned_dofs.begin(), owned_dofs.end());
+        const auto received_requests = ExchangeWithAll(requests, mCommunicator);
+        std::vector<std::vector<std::uint64_t>> replies(rank_count);
+        mReceivedRows.resize(rank_count);
+        for (std::size_t i_rank=0; i_rank<rank_count; ++i_rank) {
+            const auto& r_requests = received_requests[i_rank];
+            for (std::size_t i_request=0; i_request<r_requests.size(); i_request+=2) {
+                const std::array<std::uint64_t,3> key {r_requests[i_request], r_requests[i_request + 1], 0};
+                const auto it_dof = std::lower_bound(owned_dofs.begin(), owned_dofs.end(), key);
+                KRATOS_ERROR_IF(it_dof == owned_dofs.end() || (*it_dof)[0] != key[0] || (*it_dof)[1] != key[1])
+                    << "rank " << i_rank << " holds a DoF of node " << key[0] << " owned by rank " << rank
+                    << ", but rank " << rank << " has no such DoF in its system\n";
+                replies[i_rank].push_back(mGlobalIds[(*it_dof)[2]]);
+                mReceivedRows[i_rank].push_back(mGlobalIds[(*it_dof)[2]] - mFirstRow);
+            }
+        }
+
+        const auto ghost_ids = ExchangeWithAll(replies, mCommunicator);
+        for (std::size_t i_rank=0; i_rank<rank_count; ++i_rank) {
+            for (std::size_t i_ghost=0; i_ghost<mGhostRows[i_rank].size(); ++i_ghost) {
+                mGlobalIds[mGhostRows[i_rank][i_ghost]] = ghost_ids[i_rank][i_ghost];
+            }
+        }
+
+        const auto it_missing = std::find(mGlobalIds.begin(), mGlobalIds.end(), InvalidId);
+        KRATOS_ERROR_IF(it_missing != mGlobalIds.end())
+            << "equation " << std::distance(mGlobalIds.begin(), it_missing) << " belongs to no DoF\n";
+        KRATOS_CATCH("")
+    }
+
+    // Construct the strip from the owned rows of the local system and the ghost rows other ranks assembled.
+    void AssembleStrip(const typename TSparseSpace::MatrixType& rA)
+    {
+        KRATOS_TRY
+        KRATOS_ERROR_IF(rA.size1() != mGlobalIds.size() || rA.size2() != mGlobalIds.size())
+            << "the system matrix is " << rA.size1() << "x" << rA.size2() << ", but the DoF set passed to"
+            << " ProvideAdditionalData spans " << mGlobalIds.size() << " equations\n";
+
+        const std::size_t* p_row_extents = &*rA.index1_data().begin();
+        const std::size_t* p_columns = &*rA.index2_data().begin();
+        const Scalar* p_values = &*rA.value_data().begin();
+
+        // Send the ghost rows to their owners, prefixed by their entry counts.
+        const std::size_t rank_count = mGhostRows.size();
+        std::vector<std::vector<std::uint64_t>> sent_columns(rank_count);
+        std::vector<std::vector<Scalar>> sent_values(rank_count);
+        for (std::size_t i_rank=0; i_rank<rank_count; ++i_rank) {
+            for (const std::size_t i_row : mGhostRows[i_rank]) {
+                sent_columns[i_rank].push_back(p_row_extents[i_row + 1] - p_row_extents[i_row]);
+                for (std::size_t i_entry=p_row_extents[i_row]; i_entry<p_row_extents[i_row + 1]; ++i_entry) {
+                    sent_columns[i_rank].push_back(mGlobalIds[p_columns[i_entry]]);
+                    sent_values[i_rank].push_back(p_values[i_entry]);
+                }
+            }
+        }
+
+        const auto received_columns = ExchangeWithAll(sent_columns, mCommunicator);
+        const auto received_values = ExchangeWithAll(sent_values, mCommunicator);
+        const std::size_t row_count = mOwnedRows.size();
+        std::vector<std::vector<std::pair<std::uint64_t,Scalar>>> received_entries(row_count);
+        for (std::size_t i_rank=0; i_rank<rank_count; ++i_rank) {
+            auto it_column = received_columns[i_rank].begin();
+            auto it_value = received_values[i_rank].begin();
+            for (const std::size_t i_row : mReceivedRows[i_rank]) {
+                for (std::size_t i_entry=*it_column++; i_entry; --i_entry) {
+                    received_entries[i_row].emplace_back(*it_column++, *it_value++);
+                }
+            }
+        }
+
+        // Merge the owned rows with the received ones, summing entries in the same column.
+        const auto merge_row = [&](std::size_t i_row, auto& rEntries) {
+            const std::size_t i_local = mOwnedRows[i_row];
+            rEntries = received_entries[i_row];
+            for (std::size_t i_entry=p_row_extents[i_local]; i_entry<p_row_extents[i_local + 1]; ++i_entry) {
+                rEntries.emplace_back(mGlobalIds[p_columns[i_entry]], p_values[i_entry]);
+            }
+            std::sort(rEntries.begin(), rEntries.end(), [](const auto& rLeft, const auto& rRight) {return rLeft.first < rRight.first;});
+
+            std::size_t i_merged = 0;
+            for (std::size_t i_entry=1; i_entry<rEntries.size(); ++i_entry) {
+                if (rEntries[i_entry].first == rEntries[i_merged].first) rEntries[i_merged].second += rEntries[i_entry].second;
+                else rEntries[++i_merged] = rEntries[i_entry];
+            }
+            rEntries.resize(rEntries.empty() ? 0 : i_merged + 1);
+        };
+
+        // Count the entries of each row ...
+        std::vector<std::size_t> row_extents(row_count + 1, 0);
+        IndexPartition<std::size_t>(row_count).for_each(std::vector<std::pair<std::uint64_t,Scalar>>(), [&](std::size_t i_row, auto& rEntries) {
+            merge_row(i_row, rEntries);
+            row_extents[i_row + 1] = rEntries.size();
+        });
+        std::partial_sum(row_extents.begin(), row_extents.end(), row_extents.begin());
+
+        // ... then fill them.
+        const std::size_t nonzero_count = row_extents.back();
+        mStrip = typename TSparseSpace::MatrixType(row_count, mGlobalSize, nonzero_count);
+        std::copy(row_extents.begin(), row_extents.end(), mStrip.index1_data().begin());
+        auto& r_strip_columns = mStrip.index2_data();
+        auto& r_strip_values = mStrip.value_data();
+        IndexPartition<std::size_t>(row_count).for_each(std::vector<std::pair<std::uint64_t,Scalar>>(), [&](std::size_t i_row, auto& rEntries) {
+            merge_row(i_row, rEntries);
+            std::size_t i_strip_entry = row_extents[i_row];
+            for (const auto& [i_column, value] : rEntries) {
+                r_strip_columns[i_strip_entry] = i_column;
+                r_strip_values[i_strip_entry++] = value;
+            }
+        });
+        mStrip.set_filled(row_count + 1, nonzero_count);
+        KRATOS_CATCH("")
+    }
+
+    // Collect the right hand side and the starting iterate of the owned rows.
+    void GatherVectors(const typename TSparseSpace::VectorType& rB,
+                       const typename TSparseSpace::VectorType& rX)
+    {
+        KRATOS_TRY
+        KRATOS_ERROR_IF(rB.size() != mGlobalIds.size() || rX.size() != mGlobalIds.size())
+            << "the right hand side has " << rB.size() << " and the solution " << rX.size()
+            << " components, but the system has " << mGlobalIds.size() << " equations\n";
+
+        std::vector<std::vector<Scalar>> sent(mGhostRows.size());
+        for (std::size_t i_rank=0; i_rank<mGhostRows.size(); ++i_rank) {
+            for (const std::size_t i_row : mGhostRows[i_rank]) sent[i_rank].push_back(rB[i_row]);
+        }
+        const auto received = ExchangeWithAll(sent, mCommunicator);
+
+        const std::size_t row_count = mOwnedRows.size();
+        if (mStripB.size() != row_count) mStripB.resize(row_count, false);
+        if (mStripX.size() != row_count) mStripX.resize(row_count, false);
+        IndexPartition<std::size_t>(row_count).for_each([&rB, &rX, this](std::size_t i_row) {
+            mStripB[i_row] = rB[mOwnedRows[i_row]];
+            mStripX[i_row] = rX[mOwnedRows[i_row]];
+        });
+
+        for (std::size_t i_rank=0; i_rank<received.size(); ++i_rank) {
+            for (std::size_t i_ghost=0; i_ghost<received[i_rank].size(); ++i_ghost) {
+                mStripB[mReceivedRows[i_rank][i_ghost]] += received[i_rank][i_ghost];
+            }
+        }
+        KRATOS_CATCH("")
+    }
+
+    // Write the solution of the strip to the owned DoFs, and fetch the solution of ghost DoFs from their owners.
+    void ScatterSolution(typename TSparseSpace::VectorType& rX)
+    {
+        KRATOS_TRY
+        IndexPartition<std::size_t>(mOwnedRows.size()).for_each([&rX, this](std::size_t i_row) {
+            rX[mOwnedRows[i_row]] = mStripX[i_row];
+        });
+
+        std::vector<std::vector<Scalar>> sent(mReceivedRows.size());
+        for (std::size_t i_rank=0; i_rank<mReceivedRows.size(); ++i_rank) {
+            for (const std::size_t i_row : mReceivedRows[i_rank]) sent[i_rank].push_back(mStripX[i_row]);
+        }
+        const auto received = ExchangeWithAll(sent, mCommunicator);
+
+        for (std::size_t i_rank=0; i_rank<received.size(); ++i_rank) {
+            for (std::size_t i_ghost=0; i_ghost<received[i_rank].size(); ++i_ghost) {
+                rX[mGhostRows[i_rank][i_ghost]] = received[i_rank][i_ghost];
+            }
+        }
+        KRATOS_CATCH("")
+    }
+}; // struct DistributedPartition
+
+#endif
+
+
+// Summary of a system matrix that the hierarchy reuse decisions are based on.
+// The hierarchy may refer to the matrix' arrays (see MakeBuildMatrix), so their
+// addresses are part of the pattern: reallocated arrays require a new hierarchy
+// even if the pattern itself did not change.
+struct MatrixFingerprint
+{
+    const void* mpAddress = nullptr;
+
+    const void* mpRowData = nullptr;
+
+    const void* mpColumnData = nullptr;
+
+    const void* mpValueData = nullptr;
+
+    std::size_t mSize = 0;
+
+    std::size_t mNonZeroCount = 0;
+
+    std::size_t mBlockSize = 0;
+
+    std::uint64_t mPatternHash = 0;
+
+    std::uint64_t mValueHash = 0;
+
+    template <class TMatrix>
+    static MatrixFingerprint Make(const TMatrix& rMatrix, std::size_t BlockSize)
+    {
+        MatrixFingerprint output;
+        output.mpAddress = &rMatrix;
+        output.mpRowData = &*rMatrix.index1_data().begin();
+        output.mpColumnData = &*rMatrix.index2_data().begin();
+        output.mpValueData = &*rMatrix.value_data().begin();
+        output.mSize = rMatrix.size1();
+        output.mNonZeroCount = rMatrix.nnz();
+        output.mBlockSize = BlockSize;
+        output.mPatternHash = HashArray(&*rMatrix.index1_data().begin(), rMatrix.size1() + 1)
+                            ^ HashArray(&*rMatrix.index2_data().begin(), rMatrix.nnz());
+        output.mValueHash = HashArray(&*rMatrix.value_data().begin(), rMatrix.nnz());
+        return output;
+    }
+
+    bool HasSamePattern(const MatrixFingerprint& rOther) const noexcept
+    {
+        return mpAddress == rOther.mpAddress
+            && mpRowData == rOther.mpRowData
+            && mpColumnData == rOther.mpColumnData
+            && mpValueData == rOther.mpValueData
+            && mSize == rOther.mSize
+            && mNonZeroCount == rOther.mNonZeroCount
+            && mBlockSize == rOther.mBlockSize
+            && mPatternHash == rOther.mPatternHash;
+    }
+
+    bool HasSameValues(const MatrixFingerprint& rOther) const noexcept
+    {
+        return HasSamePattern(rOther) && mValueHash == rOther.mValueHash;
+    }
+}; // struct MatrixFingerprint
+
+
+// AMGCL sorts the rows of transfer operators in place, which the private
+// mapping of a MappedFile allows without affecting the file.
+using UtilityApp::MappedFile;
+
+
+// On-disk layout of a cached level (native byte order):
+// @code
+// HierarchyCacheHeader
+// for P, R and the coarse operator:
+//     HierarchyCacheMatrixHeader
+//     ptr[row count + 1]
+//     col[nonzero count]
+//     val[nonzero count]
+// @endcode
+// Each entry is padded to HierarchyCacheAlignment bytes so that the arrays can be
+// used in place from a memory mapping. Bump HierarchyCacheVersion whenever the layout
+// or the hashing of level matrices changes.
+constexpr std::uint32_t HierarchyCacheVersion = 2;
+
+constexpr std::size_t HierarchyCacheAlignment = 64;
+
+struct HierarchyCacheHeader
+{
+    std::array<char,8> mMagic {'K', 'A', 'M', 'G', 'C', 'L', 'H', '\0'};
+
+    std::uint32_t mVersion = HierarchyCacheVersion;
+
+    // Size of a matrix value in bytes (distinguishes scalar types and block sizes).
+    std::uint32_t mValueSize = 0;
+
+    // Hash of the fine level matrix and the coarsening settings.
+    std::uint64_t mKey = 0;
+
+    std::uint64_t mFileSize = 0;
+}; // struct HierarchyCacheHeader
+
+
+struct HierarchyCacheMatrixHeader
+{
+    std::uint64_t mRowCount = 0;
+
+    std::uint64_t mColumnCount = 0;
+
+    std::uint64_t mNonZeroCount = 0;
+}; // struct HierarchyCacheMatrixHeader
+
+
+constexpr std::size_t PadToCacheAlignment(std::size_t Size) noexcept
+{
+    return (Size + HierarchyCacheAlignment - 1) / HierarchyCacheAlignment * HierarchyCacheAlignment;
+}
+
+
+inline std::uint64_t MixHash(std::uint64_t Seed, std::uint64_t Value) noexcept
+{
+    std::uint64_t hash = Seed ^ (Value + 0x9e3779b97f4a7c15ull + (Seed << 6) + (Seed >> 2));
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+    return hash ^ (hash >> 31);
+}
+
+
+// Hash of an AMGCL CRS matrix' dimensions, sparsity pattern and values.
+template <class TMatrix>
+std::uint64_t HashLevelMatrix(const TMatrix& rMatrix, std::uint64_t Seed)
+{
+    using Value = typename TMatrix::value_type;
+    using Scalar = typename amgcl::math::scalar_of<Value>::type;
+    constexpr std::size_t scalars_per_value = sizeof(Value) / sizeof(Scalar);
+
+    std::uint64_t hash = MixHash(Seed, rMatrix.nrows);
+    hash = MixHash(hash, rMatrix.ncols);
+    hash = MixHash(hash, rMatrix.nnz);
+    hash = MixHash(hash, sizeof(Value));
+    hash = MixHash(hash, HashArray(rMatrix.ptr, rMatrix.nrows + 1));
+    hash = MixHash(hash, HashArray(rMatrix.col, rMatrix.nnz));
+    return MixHash(hash, HashArray(reinterpret_cast<const Scalar*>(rMatrix.val), rMatrix.nnz * scalars_per_value));
+}
+
+
+// Coarsening that stores the transfer operators and coarse operator of each level
+// on disk, and loads them instead of invoking the wrapped coarsening if a level
+// matrix was already coarsened with the same settings.
+// Entries are keyed by a hash of the level matrix, the level index, and the settings of
+// the coarsening and the enclosing preconditioner, so a changed system or changed settings
+// result in a fresh setup of the affected level (and of all coarser ones, since their level
+// matrices change as well). The wrapped coarsening's per-level state (the strong coupling
+// threshold of aggregation) is derived from the level index when a level is computed
+// after others were loaded. Entries with
+// mismatching headers (other version, value type, or a hash collision) are ignored
+// and overwritten. Smoothers are always constructed from the (loaded) level matrices.
+// Caching is disabled if no directory is set, in which case the wrapped coarsening
+// is used as is. Independently of caching, "first_touch" replaces the level matrices
+// by copies made with MakeFirstTouchCopy. Every level is reported to the active
+// LevelStatisticsRecorder, if there is one.
+// @warning The key only captures the level matrix, so coarsenings with state carried
+//          between levels (near-nullspace vectors) must not be cached.
+template <template <class> class TCoarsening>
+struct CachedCoarsening
+{
+    template <class TBackend>
+    class type
+    {
+    public:
+        using Inner = TCoarsening<TBackend>;
+
+        using Matrix = typename amgcl::backend::builtin<typename TBackend::value_type>::matrix;
+
+        using Value = typename Matrix::value_type;
+
+        using Column = std::remove_cv_t<std::remove_pointer_t<decltype(Matrix::col)>>;
+
+        using Row = std::remove_cv_t<std::remove_pointer_t<decltype(Matrix::ptr)>>;
+
+        // Settings of the wrapped coarsening, with an additional "cache" subtree:
+        // - "directory": directory the levels are stored in (empty => no caching)
+        // - "verbose": log cache hits and writes
+        // - "precond_hash": hash of the enclosing preconditioner's settings
+        struct params : public Inner::params
+        {
+            std::filesystem::path directory;
+
+            bool verbose = false;
+
+            // Copy level matrices with parallel first touch.
+            bool first_touch = false;
+
+            // Hash of the wrapped coarsening's and the enclosing preconditioner's settings.
+            std::uint64_t settings_hash = 0;
+
+            // Settings of the wrapped coarsening on the finest level.
+            boost::property_tree::ptree settings;
+
+            params() = default;
+
+            params(const boost::property_tree::ptree& rSettings)
+                : Inner::params(WithoutCacheSettings(rSettings)),
+                  directory(rSettings.get<std::string>("cache.directory", "")),
+                  verbose(rSettings.get<bool>("cache.verbose", false)),
+                  first_touch(rSettings.get<bool>("first_touch", false)),
+                  settings(WithoutCacheSettings(rSettings))
+            {
+                std::stringstream stream;
+                boost::property_tree::write_json(stream, settings, false);
+                settings_hash = MixHash(MixHash(HierarchyCacheVersion, std::hash<std::string>()(stream.str())),
+                                        rSettings.get<std::uint64_t>("cache.precond_hash", 0));
+            }
+
+            static boost::property_tree::ptree WithoutCacheSettings(boost::property_tree::ptree Settings)
+            {
+                Settings.erase("cache");
+                Settings.erase("first_touch");
+                return Settings;
+            }
+        }; // struct params
+
+        type(const params& rParameters)
+            : mParameters(rParameters),
+              mpInner(std::make_unique<Inner>(rParameters))
+        {
+        }
+
+        std::tuple<std::shared_ptr<Matrix>,std::shared_ptr<Matrix>> transfer_operators(const Matrix& rA)
+        {
+            auto operators = this->MakeTransferOperators(rA);
+            if (auto p_recorder = LevelStatisticsRecorder::GetActive()) {
+                p_recorder->AddTransferOperators(*std::get<0>(operators), *std::get<1>(operators));
+            }
+            return operators;
+        }
+
+        std::shared_ptr<Matrix> coarse_operator(const Matrix& rA, const Matrix& rP, const Matrix& rR)
+        {
+            auto p_coarse = this->MakeCoarseOperator(rA, rP, rR);
+            if (auto p_recorder = LevelStatisticsRecorder::GetActive()) {
+                p_recorder->AddLevel(*p_coarse);
+            }
+            return p_coarse;
+        }
+
+    private:
+        std::tuple<std::shared_ptr<Matrix>,std::shared_ptr<Matrix>> MakeTransferOperators(const Matrix& rA)
+        {
+            mpCoarse.reset();
+            mpPendingP.reset();
+            mpPendingR.reset();
+            if (mParameters.directory.empty()) {
+                auto [p_p, p_r] = mpInner->transfer_operators(rA);
+                return {Touch(p_p), Touch(p_r)};
+            }
+
+            const std::size_t i_level = mLevelCount++;
+            const std::uint64_t key = HashLevelMatrix(rA, MixHash(mParameters.settings_hash, i_level));
+            const std::filesystem::path path = MakePath(key);
+
+            if (auto p_file = MappedFile::Open(path)) {
+                if (Load(p_file, key)) {
+                    KRATOS_INFO_IF("AMGCLWrapper", mParameters.verbose)
+                        << "loaded level " << i_level << " from " << path << "\n";
+                    mpLoadedP = Touch(mpLoadedP);
+                    mpLoadedR = Touch(mpLoadedR);
+                    mpCoarse = Touch(mpCoarse);
+                    return {mpLoadedP, mpLoadedR};
+                }
+            }
+
+            // Levels loaded from the cache did not advance the wrapped coarsening's
+            // per-level state, so it is reconstructed with the settings of this level.
+            if (mInnerLevel != i_level) {
+                mpInner = std::make_unique<Inner>(MakeLevelParameters(i_level));
+                mInnerLevel = i_level;
+            }
+            std::tie(mpPendingP, mpPendingR) = mpInner->transfer_operators(rA);
+            ++mInnerLevel;
+            mpPendingP = Touch(mpPendingP);
+            mpPendingR = Touch(mpPendingR);
+            mPendingKey = key;
+            return {mpPendingP, mpPendingR};
+        }
+
+        std::shared_ptr<Matrix> MakeCoarseOperator(const Matrix& rA, const Matrix& rP, const Matrix& rR)
+        {
+            // Loaded levels come with their coarse operator.
+            if (mpCoarse && &rP == mpLoadedP.get() && &rR == mpLoadedR.get()) {
+                return std::exchange(mpCoarse, nullptr);
+            }
+
+            auto p_coarse = Touch(mpInner->coarse_operator(rA, rP, rR));
+
+            // AMGCL sorts the transfer operators' rows in place before requesting the
+            // coarse operator, so the sorted operators are the ones getting stored.
+            if (mpPendingP && &rP == mpPendingP.get() && &rR == mpPendingR.get()) {
+                Store(mPendingKey, rP, rR, *p_coarse);
+                mpPendingP.reset();
+                mpPendingR.reset();
+            }
+            return p_coarse;
+        }
+
+        // Settings the wrapped coarsening has after coarsening @a LevelIndex levels.
+        // AMGCL's aggregation based coarsenings halve the strong coupling threshold
+        // after each level; the static coarsenings are all aggregation based.
+        typename Inner::params MakeLevelParameters(std::size_t LevelIndex) const
+        {
+            boost::property_tree::ptree settings = mParameters.settings;
+            const std::string coarsening_type = settings.get<std::string>("type", "smoothed_aggregation");
+            if (coarsening_type == "aggregation" || coarsening_type == "smoothed_aggregation" || coarsening_type == "smoothed_aggr_emin") {
+                const double eps_strong = settings.get<double>("aggr.eps_strong", typename amgcl::coarsening::aggregation<TBackend>::params().aggr.eps_strong);
+                settings.put("aggr.eps_strong", std::ldexp(eps_strong, -static_cast<int>(LevelIndex)));
+            }
+            return typename Inner::params(settings);
+        }
+
+        std::shared_ptr<Matrix> Touch(const std::shared_ptr<Matrix>& rpMatrix) const
+        {
+            return mParameters.first_touch ? MakeFirstTouchCopy(*rpMatrix) : rpMatrix;
+        }
+
+        std::filesystem::path MakePath(std::uint64_t Key) const
+        {
+            std::stringstream name;
+            name << std::hex << std::setw(16) << std::setfill('0') << Key << ".amgcl_level";
+            return mParameters.directory / name.str();
+        }
+
+        bool Load(const std::shared_ptr<MappedFile>& rpFile, std::uint64_t Key)
+        {
+            std::size_t offset = 0;
+            const auto p_header = Read<HierarchyCacheHeader>(*rpFile, offset, 1);
+            if (!p_header
+                || p_header->mMagic != HierarchyCacheHeader().mMagic
+                || p_header->mVersion != HierarchyCacheVersion
+                || p_header->mValueSize != sizeof(Value)
+                || p_header->mKey != Key
+                || p_header->mFileSize != rpFile->Size()) {
+                return false;
+            }
+
+            mpLoadedP = MapMatrix(rpFile, offset);
+            mpLoadedR = mpLoadedP ? MapMatrix(rpFile, offset) : nullptr;
+            mpCoarse = mpLoadedR ? MapMatrix(rpFile, offset) : nullptr;
+            return static_cast<bool>(mpCoarse);
+        }
+
+        // Pointer to Count objects of type T at Offset, or nullptr if they don't fit in the file.
+        template <class T>
+        static T* Read(MappedFile& rFile, std::size_t& rOffset, std::size_t Count)
+        {
+            const std::size_t size = PadToCacheAlignment(Count * sizeof(T));
+            if (rFile.Size() < rOffset || rFile.Size() - rOffset < size) return nullptr;
+            T* p_begin = reinterpret_cast<T*>(rFile.Data() + rOffset);
+            rOffset += size;
+            return p_begin;
+        }
+
+        // Construct a matrix referring to the mapped arrays.
+        // The matrix keeps the mapping alive, and does not own its arrays.
+        static std::shared_ptr<Matrix> MapMatrix(const std::shared_ptr<MappedFile>& rpFile, std::size_t& rOffset)
+        {
+            const auto p_header = Read<HierarchyCacheMatrixHeader>(*rpFile, rOffset, 1);
+            if (!p_header) return nullptr;
+            const auto p_ptr = Read<Row>(*rpFile, rOffset, p_header->mRowCount + 1);
+            const auto p_col = p_ptr ? Read<Column>(*rpFile, rOffset, p_header->mNonZeroCount) : nullptr;
+            const auto p_val = p_col ? Read<Value>(*rpFile, rOffset, p_header->mNonZeroCount) : nullptr;
+            if (!p_val || p_ptr[p_header->mRowCount] != static_cast<Row>(p_header->mNonZeroCount)) return nullptr;
+
+            std::shared_ptr<Matrix> p_matrix(new Matrix, [rpFile](Matrix* pMatrix) {delete pMatrix;});
+            p_matrix->own_data = false;
+            p_matrix->nrows = p_header->mRowCount;
+            p_matrix->ncols = p_header->mColumnCount;
+            p_matrix->nnz = p_header->mNonZeroCount;
+            p_matrix->ptr = p_ptr;
+            p_matrix->col = p_col;
+            p_matrix->val = p_val;
+            return p_matrix;
+        }
+
+        template <class T>
+        static void Write(std::ostream& rStream, const T* pBegin, std::size_t Count)
+        {
+            constexpr std::array<char,HierarchyCacheAlignment> padding {};
+            const std::size_t size = Count * sizeof(T);
+            rStream.write(reinterpret_cast<const char*>(pBegin), size);
+            rStream.write(padding.data(), PadToCacheAlignment(size) - size);
+        }
+
+        static void WriteMatrix(std::ostream& rStream, const Matrix& rMatrix)
+        {
+            const HierarchyCacheMatrixHeader header {rMatrix.nrows, rMatrix.ncols, rMatrix.nnz};
+            Write(rStream, &header, 1);
+            Write(rStream, rMatrix.ptr, rMatrix.nrows + 1);
+            Write(rStream, rMatrix.col, rMatrix.nnz);
+            Write(rStream, rMatrix.val, rMatrix.nnz);
+        }
+
+        static std::size_t GetStoredSize(const Matrix& rMatrix) noexcept
+        {
+            return PadToCacheAlignment(sizeof(HierarchyCacheMatrixHeader))
+                 + PadToCacheAlignment((rMatrix.nrows + 1) * sizeof(Row))
+                 + PadToCacheAlignment(rMatrix.nnz * sizeof(Column))
+                 + PadToCacheAlignment(rMatrix.nnz * sizeof(Value));
+        }
+
+        // Write the level to a temporary file and move it in place, so that concurrent
+        // analyses sharing the directory never see partially written levels.
+        // Failing to write is not an error: the level just won't be cached.
+        void Store(std::uint64_t Key, const Matrix& rP, const Matrix& rR, const Matrix& rCoarse) const
+        {
+            const std::filesystem::path path = MakePath(Key);
+            std::filesystem::path temporary_path = path;
+            temporary_path += "." + std::to_string(std::random_device()()) + ".tmp";
+
+            HierarchyCacheHeader header;
+            header.mValueSize = sizeof(Value);
+            header.mKey = Key;
+            header.mFileSize = PadToCacheAlignment(sizeof(HierarchyCacheHeader))
+                             + GetStoredSize(rP) + GetStoredSize(rR) + GetStoredSize(rCoarse);
+
+            bool success = false;
+            {
+                std::ofstream file(temporary_path, std::ios::binary);
+                if (file) {
+                    Write(file, &header, 1);
+                    WriteMatrix(file, rP);
+                    WriteMatrix(file, rR);
+                    WriteMatrix(file, rCoarse);
+                    success = static_cast<bool>(file.flush());
+                }
+            }
+
+            std::error_code error;
+            if (success) std::filesystem::rename(temporary_path, path, error);
+            if (!success || error) {
+                std::filesystem::remove(temporary_path, error);
+                KRATOS_WARNING("AMGCLWrapper") << "failed to write hierarchy cache entry " << path << "\n";
+            } else {
+                KRATOS_INFO_IF("AMGCLWrapper", mParameters.verbose)
+                    << "stored level " << mLevelCount - 1 << " in " << path << "\n";
+            }
+        }
+
+        params mParameters;
+
+        std::unique_ptr<Inner> mpInner;
+
+        // Number of levels the wrapped coarsening has processed, i.e. the level its state corresponds to.
+        std::size_t mInnerLevel = 0;
+
+        // Number of levels processed so far.
+        std::size_t mLevelCount = 0;
+
+        // Transfer and coarse operators of the last level loaded from the cache.
+        std::shared_ptr<Matrix> mpLoadedP, mpLoadedR, mpCoarse;
+
+        // Transfer operators of the last level computed by the wrapped coarsening,
+        // waiting for their coarse operator to be stored.
+        std::shared_ptr<Matrix> mpPendingP, mpPendingR;
+
+        std::uint64_t mPendingKey = 0;
+    }; // class type
+}; // struct CachedCoarsening
+
+
+// Trait class of a runtime configured AMG solver whose levels are cached on disk
+// (see CachedCoarsening). Unlike amgcl::runtime::preconditioner, the preconditioner
+// is always AMG.
+template <class TRuntimeTraits>
+struct AMGCLCachedTraits : public TRuntimeTraits
+{
+    using Preconditioner = amgcl::amg<typename TRuntimeTraits::PrecondBackend,
+                                      CachedCoarsening<amgcl::runtime::coarsening::wrapper>::type,
+                                      amgcl::runtime::relaxation::wrapper>;
+
+    using Solver = amgcl::make_solver<Preconditioner,typename TRuntimeTraits::SolverWrapper>;
+}; // struct AMGCLCachedTraits
+
+
+// Drop-in replacement of amgcl::runtime::preconditioner that constructs AMG with a
+// CachedCoarsening, so that its levels reach the active LevelStatisticsRecorder.
+// Without cache settings, the coarsening is forwarded to as is. Other preconditioner
+// classes are delegated to amgcl::runtime::preconditioner.
+template <class TBackend>
+class RuntimePreconditioner
+{
+public:
+    using backend_type = TBackend;
+
+    using value_type = typename TBackend::value_type;
+
+    using matrix = typename TBackend::matrix;
+
+    using vector = typename TBackend::vector;
+
+    using backend_params = typename TBackend::params;
+
+    using build_matrix = typename amgcl::backend::builtin<value_type>::matrix;
+
+    using params = boost::property_tree::ptree;
+
+    template <class TMatrix>
+    RuntimePreconditioner(const TMatrix& rMatrix,
+                          params Parameters = params(),
+                          const backend_params& rBackendParameters = backend_params())
+        : mPreconditioner(MakePreconditioner(rMatrix, std::move(Parameters), rBackendParameters))
+    {
+    }
+
+    template <class TRHS, class TSolution>
+    void apply(const TRHS& rRHS, TSolution&& rSolution) const
+    {
+        std::visit([&rRHS, &rSolution](const auto& rpPreconditioner) {
+                       rpPreconditioner->apply(rRHS, std::forward<TSolution>(rSolution));
+                   },
+                   mPreconditioner);
+    }
+
+    std::shared_ptr<matrix> system_matrix_ptr() const
+    {
+        return std::visit([](const auto& rpPreconditioner) {return rpPreconditioner->system_matrix_ptr();},
+                          mPreconditioner);
+    }
+
+    const matrix& system_matrix() const
+    {
+        return *this->system_matrix_ptr();
+    }
+
+    std::size_t bytes() const
+    {
+        return std::visit([](const auto& rpPreconditioner) {return amgcl::backend::bytes(*rpPreconditioner);},
+                          mPreconditioner);
+    }
+
+    // Check whether the preconditioner is AMG.
+    bool IsHierarchy() const noexcept
+    {
+        return mPreconditioner.index() == 0;
+    }
+
+    friend std::ostream& operator<<(std::ostream& rStream, const RuntimePreconditioner& rPreconditioner)
+    {
+        std::visit([&rStream](const auto& rpPreconditioner) {rStream << *rpPreconditioner;},
+                   rPreconditioner.mPreconditioner);
+        return rStream;
+    }
+
+private:
+    using AMG = amgcl::amg<TBackend,
+                           CachedCoarsening<amgcl::runtime::coarsening::wrapper>::type,
+                           amgcl::runtime::relaxation::wrapper>;
+
+    using Other = amgcl::runtime::preconditioner<TBackend>;
+
+    using Variant = std::variant<std::unique_ptr<AMG>,std::unique_ptr<Other>>;
+
+    template <class TMatrix>
+    static Variant MakePreconditioner(const TMatrix& rMatrix,
+                                      params Parameters,
+                                      const backend_params& rBackendParameters)
+    {
+        if (Parameters.get<std::string>("class", "amg") == "amg") {
+            // AMG's own settings have no class selector.
+            Parameters.erase("class");
+            return std::make_unique<AMG>(rMatrix, Parameters, rBackendParameters);
+        }
+        return std::make_unique<Other>(rMatrix, Parameters, rBackendParameters);
+    }
+
+    Variant mPreconditioner;
+}; // class RuntimePreconditioner
+
+
+// Node-block preserving permutation of a system's equations.
+// The permutation is computed on the graph of nodes (groups of BlockSize consecutive
+// equations) with the reverse Cuthill-McKee algorithm, so block backends and pointwise
+// aggregation see the same blocks after reordering. The permuted matrix' sparsity pattern
+// and the map of its values to the original matrix' values are computed once per
+// sparsity pattern; subsequent systems only gather their values.
+template <class TSparseSpace>
+struct SystemPermutation
+{
+    using SparseMatrix = typename TSparseSpace::MatrixType;
+
+    using Vector = typename TSparseSpace::VectorType;
+
+    // Check whether the permutation was computed for a matrix with the same sparsity pattern.
+    bool Matches(const SparseMatrix& rMatrix, std::size_t BlockSize) const
+    {
+        return !mPermutation.empty()
+            && mPermutation.size() == rMatrix.size1()
+            && mValueMap.size() == rMatrix.nnz()
+            && mBlockSize == BlockSize
+            && mPatternHash == HashPattern(rMatrix);
+    }
+
+    // Compute the permutation and the permuted sparsity pattern, and gather the matrix' values.
+    void Compute(const SparseMatrix& rMatrix, std::size_t BlockSize)
+    {
+        KRATOS_TRY
+        const std::size_t system_size = rMatrix.size1();
+        KRATOS_ERROR_IF(system_size % BlockSize)
+            << "system size " << system_size << " is not divisible by the block size " << BlockSize << "\n";
+        const std::size_t node_count = system_size / BlockSize;
+        const auto& r_row_extents = rMatrix.index1_data();
+        const auto& r_column_indices = rMatrix.index2_data();
+
+        // Assemble the node graph (without self loops).
+        std::vector<std::size_t> node_extents(node_count + 1, 0);
+        std::vector<std::size_t> node_neighbors;
+        node_neighbors.reserve(rMatrix.nnz() / (BlockSize * BlockSize));
+        {
+            std::vector<std::size_t> markers(node_count, node_count);
+            for (std::size_t i_node=0; i_node<node_count; ++i_node) {
+                markers[i_node] = i_node;
+                for (std::size_t i_row=i_node*BlockSize; i_row<(i_node+1)*BlockSize; ++i_row) {
+                    for (std::size_t i_entry=r_row_extents[i_row]; i_entry<r_row_extents[i_row+1]; ++i_entry) {
+                        const std::size_t i_neighbor = r_column_indices[i_entry] / BlockSize;
+                        if (markers[i_neighbor] != i_node) {
+                            markers[i_neighbor] = i_node;
+                            node_neighbors.push_back(i_neighbor);
+                        }
+                    }
+                }
+                node_extents[i_node + 1] = node_neighbors.size();
+            }
+        }
+
+        const auto degree = [&node_extents](std::size_t i_node) {
+            return node_extents[i_node + 1] - node_extents[i_node];
+        };
+
+        // Breadth first traversal from a root node, visiting neighbors in order of increasing degree.
+        // Appends visited nodes to rOrder and returns the number of levels as well as the position
+        // of the last level's first node in rOrder.
+        std::vector<bool> is_ordered(node_count, false);
+        std::vector<std::size_t> stamps(node_count, 0);
+        std::size_t stamp = 0;
+        std::vector<std::size_t> neighbors;
+        const auto traverse = [&](std::size_t i_root, std::vector<std::size_t>& rOrder, std::size_t& rLastLevelBegin) -> std::size_t {
+            ++stamp;
+            const std::size_t i_begin = rOrder.size();
+            rOrder.push_back(i_root);
+            stamps[i_root] = stamp;
+            std::size_t level_count = 0;
+            for (std::size_t i_level_begin=i_begin, i_level_end=rOrder.size(); i_level_begin!=i_level_end; i_level_begin=i_level_end, i_level_end=rOrder.size()) {
+                ++level_count;
+                rLastLevelBegin = i_level_begin;
+                for (std::size_t i=i_level_begin; i<i_level_end; ++i) {
+                    neighbors.clear();
+                    for (std::size_t i_entry=node_extents[rOrder[i]]; i_entry<node_extents[rOrder[i]+1]; ++i_entry) {
+                        const std::size_t i_neighbor = node_neighbors[i_entry];
+                        if (stamps[i_neighbor] != stamp && !is_ordered[i_neighbor]) {
+                            stamps[i_neighbor] = stamp;
+                            neighbors.push_back(i_neighbor);
+                        }
+                    }
+                    std::sort(neighbors.begin(), neighbors.end(), [&degree](std::size_t Left, std::size_t Right){
+                        return degree(Left) < degree(Right);
+                    });
+                    rOrder.insert(rOrder.end(), neighbors.begin(), neighbors.end());
+                }
+            }
+            return level_count;
+        };
+
+        // Visit connected components in order of their lowest degree node, starting
+        // each from a pseudo-peripheral node (George-Liu).
+        std::vector<std::size_t> nodes_by_degree(node_count);
+        std::iota(nodes_by_degree.begin(), nodes_by_degree.end(), 0);
+        std::stable_sort(nodes_by_degree.begin(), nodes_by_degree.end(), [&degree](std::size_t Left, std::size_t Right){
+            return degree(Left) < degree(Right);
+        });
+
+        std::vector<std::size_t> order, scratch;
+        order.reserve(node_count);
+        for (const std::size_t i_start : nodes_by_degree) {
+            if (is_ordered[i_start]) continue;
+
+            // Move the root to the lowest degree node of the last level as long as that increases the depth.
+            std::size_t i_root = i_start, i_last_level_begin = 0;
+            scratch.clear();
+            std::size_t level_count = traverse(i_root, scratch, i_last_level_begin);
+            while (true) {
+                const std::size_t i_candidate = *std::min_element(
+                    scratch.begin() + i_last_level_begin,
+                    scratch.end(),
+                    [&degree](std::size_t Left, std::size_t Right){return degree(Left) < degree(Right);});
+                scratch.clear();
+                const std::size_t candidate_level_count = traverse(i_candidate, scratch, i_last_level_begin);
+                if (candidate_level_count <= level_count) break;
+                i_root = i_candidate;
+                level_count = candidate_level_count;
+            }
+
+            const std::size_t i_component_begin = order.size();
+            traverse(i_root, order, i_last_level_begin);
+            for (std::size_t i=i_component_begin; i<order.size(); ++i) is_ordered[order[i]] = true;
+        }
+        std::reverse(order.begin(), order.end());
+
+        // Expand the node permutation to equations.
+        mBlockSize = BlockSize;
+        mPermutation.resize(system_size);
+        mInversePermutation.resize(system_size);
+        IndexPartition<std::size_t>(node_count).for_each([&](std::size_t i_new_node){
+            for (std::size_t i_component=0; i_component<BlockSize; ++i_component) {
+                const std::size_t i_new = i_new_node * BlockSize + i_component;
+                const std::size_t i_old = order[i_new_node] * BlockSize + i_component;
+                mPermutation[i_new] = i_old;
+                mInversePermutation[i_old] = i_new;
+            }
+        });
+
+        // Construct the permuted sparsity pattern and the map of its values.
+        const std::size_t nonzero_count = rMatrix.nnz();
+        mMatrix = SparseMatrix(system_size, system_size, nonzero_count);
+        auto& r_permuted_row_extents = mMatrix.index1_data();
+        auto& r_permuted_column_indices = mMatrix.index2_data();
+        mValueMap.resize(nonzero_count);
+
+        r_permuted_row_extents[0] = 0;
+        for (std::size_t i_row=0; i_row<system_size; ++i_row) {
+            const std::size_t i_old = mPermutation[i_row];
+            r_permuted_row_extents[i_row + 1] = r_permuted_row_extents[i_row] + r_row_extents[i_old + 1] - r_row_extents[i_old];
+        }
+
+        IndexPartition<std::size_t>(system_size).for_each(std::vector<std::pair<std::size_t,std::size_t>>(), [&](std::size_t i_row, auto& rEntries){
+            const std::size_t i_old = mPermutation[i_row];
+            rEntries.clear();
+            for (std::size_t i_entry=r_row_extents[i_old]; i_entry<r_row_extents[i_old+1]; ++i_entry) {
+                rEntries.emplace_back(mInversePermutation[r_column_indices[i_entry]], i_entry);
+            }
+            std::sort(rEntries.begin(), rEntries.end());
+            std::size_t i_permuted_entry = r_permuted_row_extents[i_row];
+            for (const auto [i_column, i_entry] : rEntries) {
+                r_permuted_column_indices[i_permuted_entry] = i_column;
+                mValueMap[i_permuted_entry++] = i_entry;
+            }
+        });
+
+        mMatrix.set_filled(system_size + 1, nonzero_count);
+        mPatternHash = HashPattern(rMatrix);
+        UpdateValues(rMatrix);
+        KRATOS_CATCH("")
+    }
+
+    // Gather the values of a matrix with the same sparsity pattern into the permuted matrix.
+    void UpdateValues(const SparseMatrix& rMatrix)
+    {
+        const auto p_values = &*rMatrix.value_data().begin();
+        const auto p_permuted_values = &*mMatrix.value_data().begin();
+        IndexPartition<std::size_t>(mValueMap.size()).for_each([&](std::size_t i_entry){
+            p_permuted_values[i_entry] = p_values[mValueMap[i_entry]];
+        });
+    }
+
+    // rOutput[i] <= rInput[permutation[i]]
+    void Permute(const Vector& rInput, Vector& rOutput) const
+    {
+        if (rOutput.size() != rInput.size()) rOutput.resize(rInput.size(), false);
+        IndexPartition<std::size_t>(mPermutation.size()).for_each([&](std::size_t i){
+            rOutput[i] = rInput[mPermutation[i]];
+        });
+    }
+
+    // rOutput[permutation[i]] <= rInput[i]
+    void InversePermute(const Vector& rInput, Vector& rOutput) const
+    {
+        IndexPartition<std::size_t>(mPermutation.size()).for_each([&](std::size_t i){
+            rOutput[mPermutation[i]] = rInput[i];
+        });
+    }
+
+    // Permute the rows of a row-major array with the specified number of columns.
+    void PermuteRows(const std::vector<double>& rInput, std::size_t ColumnCount, std::vector<double>& rOutput) const
+    {
+        rOutput.resize(rInput.size());
+        IndexPartition<std::size_t>(mPermutation.size()).for_each([&](std::size_t i){
+            std::copy_n(rInput.data() + mPermutation[i] * ColumnCount, ColumnCount, rOutput.data() + i * ColumnCount);
+        });
+    }
+
+    // Largest distance of a nonzero entry from the diagonal.
+    static std::size_t ComputeBandwidth(const SparseMatrix& rMatrix)
+    {
+        const auto& r_row_extents = rMatrix.index1_data();
+        const auto& r_column_indices = rMatrix.index2_data();
+        return IndexPartition<std::size_t>(rMatrix.size1()).template for_each<MaxReduction<std::size_t>>([&](std::size_t i_row){
+            std::size_t bandwidth = 0;
+            for (std::size_t i_entry=r_row_extents[i_row]; i_entry<r_row_extents[i_row+1]; ++i_entry) {
+                const std::size_t i_column = r_column_indices[i_entry];
+                bandwidth = std::max(bandwidth, i_row < i_column ? i_column - i_row : i_row - i_column);
+            }
+            return bandwidth;
+        });
+    }
+
+    static std::uint64_t HashPattern(const SparseMatrix& rMatrix)
+    {
+        return HashArray(&*rMatrix.index1_data().begin(), rMatrix.size1() + 1)
+             ^ HashArray(&*rMatrix.index2_data().begin(), rMatrix.nnz());
+    }
 
-    std::unique_ptr<typename Traits::Solver> mpSolver;
+    // Permuted system matrix.
+    SparseMatrix mMatrix;
 
-    std::shared_ptr<typename Traits::MatrixAdapter> mpMatrixAdapter;
+    // New equation index => original equation index.
+    std::vector<std::size_t> mPermutation;
 
-    /// @brief Construct an AMGCL solver and its supporting variables.
-    /// @details The constructor has 3 main jobs to take care of:
-    ///          - copy the system matrix if the backend's and sparse space's
-    ///            scalar types differ.
-    ///          - construct a matrix adapter for AMGCL that provides a view on
-    ///            the system matrix or (its copy).
-    ///          - construct the AMGCL solver using the matrix adapter.
-    ///          The AMGCL backend type depends on the @ref AMGCLTraits::Impl
-    ///          type that this class is instantiated with (@a TAMGCLTraits).
-    ///          - CPU or GPU backend
-    ///          - single or double precision scalar type
-    ///          - block size
-    AMGCLBundle(const typename TAMGCLTraits::SparseSpace::MatrixType& rSystemMatrix,
-                const boost::property_tree::ptree& rSolverSettings)
-        : mpSolver(),
-          mpMatrixAdapter()
-    {
-        KRATOS_TRY
+    // Original equation index => new equation index.
+    std::vector<std::size_t> mInversePermutation;
 
-        // Copy the system matrix if necessary and construct the adapter.
-        mpMatrixAdapter = std::make_shared<typename TAMGCLTraits::MatrixAdapter>(
-            amgcl::backend::map(rSystemMatrix));
+    // Index of each nonzero of the permuted matrix in the original matrix' values.
+    std::vector<std::size_t> mValueMap;
 
-        // Construct solver
-        if constexpr (TAMGCLTraits::IsGPUBound) {
-            #ifdef AMGCL_GPGPU
-                typename TAMGCLTraits::Backend::params backend_parameters;
-                backend_parameters.q = GetVexCLContext();
-                mpSolver = std::make_unique<typename TAMGCLTraits::Solver>(*mpMatrixAdapter,
-                                                                           rSolverSettings,
-                                                                           backend_parameters);
-            #else
-                KRATOS_ERROR << "internal solver error: requesting a GPU solver while Kratos is compiled without GPU support\n";
-            #endif
-        } else {
-            mpSolver = std::make_unique<typename TAMGCLTraits::Solver>(*mpMatrixAdapter,
-                                                                       rSolverSettings);
-        }
+    std::size_t mBlockSize = 0;
 
-        KRATOS_CATCH("")
-    }
-}; // struct AMGCLBundle
+    std::uint64_t mPatternHash = 0;
+}; // struct SystemPermutation
 
 
 } // namespace Detail
@@ -234,6 +2006,37 @@ enum class AMGCLBackendType
 }; // enum class VexCLBackendType
 
 
+enum class AMGCLReusePolicy
+{
+    Rebuild,    // construct a new hierarchy at every call to InitializeSolutionStep
+    Unchanged,  // reuse the hierarchy if the system matrix did not change at all
+    Adaptive    // reuse the hierarchy for matrices with the same sparsity pattern until it degrades
+}; // enum class AMGCLReusePolicy
+
+
+/// @brief Print the reuse policy as its argument of 'hierarchy_reuse.policy'.
+std::ostream& operator<<(std::ostream& rStream, AMGCLReusePolicy Policy)
+{
+    return rStream << std::array<const char*,3> {"rebuild", "unchanged", "adaptive"}[static_cast<int>(Policy)];
+}
+
+
+enum class AMGCLReordering
+{
+    None,   // pass the system on to AMGCL as is
+    RCM     // reverse Cuthill-McKee on the graph of nodes
+}; // enum class AMGCLReordering
+
+
+enum class AMGCLInitialGuess
+{
+    Provided,       // start from the solution vector passed by the caller
+    Zero,           // start from 0
+    Previous,       // start from the solution of the previous solve
+    Extrapolated    // start from a linear extrapolation of the previous 2 solutions
+}; // enum class AMGCLInitialGuess
+
+
 template <class TSparseSpace,
           class TDenseSpace,
           class TReorderer>
@@ -248,6 +2051,170 @@ struct AMGCLWrapper<TSparseSpace,TDenseSpace,TReorderer>::Impl
     // AMGCL backend selected by the user.
     AMGCLBackendType mBackendType = AMGCLBackendType::CPU;
 
+    // Store and apply the preconditioner in single precision.
+    bool mMixedPrecision = false;
+
+    // Policy deciding whether the hierarchy is reconstructed in InitializeSolutionStep.
+    AMGCLReusePolicy mReusePolicy = AMGCLReusePolicy::Rebuild;
+
+    // Max number of consecutive steps an adaptively reused hierarchy may be used in (0 => no limit).
+    std::size_t mRebuildInterval = 0;
+
+    // Relative iteration count increase (compared to the first solve after the setup)
+    // that triggers reconstructing an adaptively reused hierarchy.
+    double mMaxIterationGrowth = 0.5;
+
+    // Fingerprint of the system matrix the current hierarchy was constructed from.
+    Detail::MatrixFingerprint mHierarchyFingerprint;
+
+    // Number of steps the current hierarchy was reused in.
+    std::size_t mReuseCount = 0;
+
+    // Iteration count of the first solve after the current hierarchy was constructed.
+    std::optional<std::size_t> mMaybeReferenceIterationCount;
+
+    // Iteration count of the most recent solve.
+    std::size_t mLastIterationCount = 0;
+
+    // Relative residual reported by AMGCL after the most recent solve.
+    double mLastResidual = 0.0;
+
+    // Wall time it took to construct the current hierarchy [s].
+    double mSetupTime = 0.0;
+
+    // Max number of solves to keep statistics of (0 => statistics are not collected).
+    std::size_t mStatisticsHistory = 16;
+
+    // Statistics of the most recent solves, from oldest to newest.
+    std::deque<AMGCLSolveStatistics> mStatistics;
+
+    // Levels and complexities of the current hierarchy.
+    Detail::HierarchyStatistics mHierarchyStatistics;
+
+    // Number of solves performed with the current hierarchy.
+    std::size_t mSolveCountSinceSetup = 0;
+
+    // Max number of right hand sides solved concurrently, each on its own copy of the solver.
+    std::size_t mRHSLanes = 1;
+
+    // Communicator the system is distributed over (nullptr or serial => shared memory).
+    const DataCommunicator* mpDataCommunicator = nullptr;
+
+    #ifdef KRATOS_USING_MPI
+    // Map from the local system onto the rows owned by this rank, constructed in
+    // ProvideAdditionalData if the system is distributed (nullptr => the local system
+    // already consists of the owned rows).
+    std::unique_ptr<Detail::DistributedPartition<TSparseSpace>> mpPartition;
+
+    // Solver for distributed systems, constructed instead of mSolverBundle.
+    std::unique_ptr<Detail::AMGCLDistributedBundle<TSparseSpace>> mpDistributedBundle;
+    #endif
+
+    bool IsDistributed() const noexcept
+    {
+        return mpDataCommunicator && mpDataCommunicator->IsDistributed();
+    }
+
+    // Update the results of the most recent solve and its statistics.
+    void RecordSolve(std::size_t IterationCount,
+                     double Residual,
+                     double SolveTime,
+                     std::size_t FallbackCount,
+                     double FallbackTime)
+    {
+        mLastIterationCount = IterationCount;
+        mLastResidual = Residual;
+        if (!mMaybeReferenceIterationCount.has_value())
+            mMaybeReferenceIterationCount = IterationCount;
+
+        if (mStatisticsHistory) {
+            AMGCLSolveStatistics statistics;
+            statistics.mReusedHierarchy = mSolveCountSinceSetup != 0;
+            statistics.mSetupTime = statistics.mReusedHierarchy ? 0.0 : mSetupTime;
+            statistics.mSolveTime = SolveTime;
+            statistics.mIterationCount = IterationCount;
+            statistics.mResidual = Residual;
+            statistics.mFallbackCount = FallbackCount;
+            statistics.mFallbackTime = FallbackTime;
+            statistics.mOperatorComplexity = mHierarchyStatistics.mOperatorComplexity;
+            statistics.mGridComplexity = mHierarchyStatistics.mGridComplexity;
+            statistics.mLevels = mHierarchyStatistics.mLevels;
+
+            mStatistics.push_back(std::move(statistics));
+            while (mStatisticsHistory < mStatistics.size())
+                mStatistics.pop_front();
+        }
+        ++mSolveCountSinceSetup;
+    }
+
+    // Use compile-time configured solvers if the settings match one.
+    bool mStaticDispatch = true;
+
+    // Directory AMG levels are cached in across runs (empty => no caching).
+    std::filesystem::path mHierarchyCacheDirectory;
+
+    // Copy the system matrix and AMG levels with parallel first touch (see Detail::MakeFirstTouchCopy).
+    bool mFirstTouch = false;
+
+    // Compile-time configured solver matching mAMGCLSettings, matched once in the constructor.
+    std::optional<Detail::AMGCLStaticConfiguration> mMaybeStaticConfiguration;
+
+    // Whether the compile-time configured solver accepts its settings, indexed by
+    // whether near-nullspace vectors are provided. Set at the first setup.
+    std::array<std::optional<bool>,2> mStaticSettingsAccepted;
+
+    // Settings of the runtime configured AMG with cached levels
+    // (unset if the hierarchy cannot be cached).
+    std::optional<boost::property_tree::ptree> mMaybeCachedAMGSettings;
+
+    // Source of the iterative solver's starting iterate.
+    AMGCLInitialGuess mInitialGuess = AMGCLInitialGuess::Provided;
+
+    // Solutions of the most recent solves (latest first) for warm starts.
+    std::array<typename TSparseSpace::VectorType,2> mSolutionHistory;
+
+    // Number of valid entries in mSolutionHistory.
+    std::size_t mSolutionHistorySize = 0;
+
+    // Settings of the solvers tried in order if AMGCL fails to converge.
+    std::vector<Parameters> mFallbackSettings;
+
+    // Fallback solvers, constructed when first needed (nullptr until then).
+    std::vector<typename LinearSolverFactory<TSparseSpace,TDenseSpace>::LinearSolverType::Pointer> mFallbacks;
+
+    // Starting iterate and right hand side of the current solve, restored before each fallback.
+    typename TSparseSpace::VectorType mFallbackX, mFallbackB;
+
+    // DoFs and model part from AMGCLWrapper::ProvideAdditionalData, forwarded to fallbacks.
+    ModelPart::DofsArrayType* mpDofs = nullptr;
+
+    ModelPart* mpModelPart = nullptr;
+
+    // Permutation applied to the system before passing it on to AMGCL.
+    AMGCLReordering mReordering = AMGCLReordering::None;
+
+    // Permutation and permuted system matrix, cached for the last sparsity pattern.
+    Detail::SystemPermutation<TSparseSpace> mPermutation;
+
+    // Permuted right hand side.
+    typename TSparseSpace::VectorType mPermutedB;
+
+    // Permuted solution.
+    typename TSparseSpace::VectorType mPermutedX;
+
+    // Permuted near-nullspace vectors.
+    std::vector<double> mPermutedNullSpace;
+
+    // Construct rigid body modes in AMGCLWrapper::ProvideAdditionalData and pass them
+    // on to AMGCL as near-nullspace vectors.
+    bool mUseRigidBodyModes = false;
+
+    // Row-major near-nullspace vectors (empty if unused).
+    std::vector<double> mNullSpace;
+
+    // Number of near-nullspace vectors in mNullSpace.
+    std::size_t mNullSpaceColumnCount = 0;
+
     // Block size computed in AMGCLWrapper::ProvideAdditionalData and
     // set in the settings passed to AMGCL.
     std::optional<std::size_t> mMaybeDoFCount;
@@ -261,14 +2228,29 @@ struct AMGCLWrapper<TSparseSpace,TDenseSpace,TReorderer>::Impl
     // AMGCLWrapper::Solve.
     const typename TSparseSpace::MatrixType* mpA = nullptr;
 
+    template <unsigned BlockSize, bool MixedPrecision = false>
+    using AMGCLTraits = Detail::AMGCLTraits<TSparseSpace,BlockSize,MixedPrecision>;
+
+    template <unsigned BlockSize, template <class> class TCoarsening, template <class> class TRelaxation>
+    using StaticBundle = Detail::AMGCLBundle<Detail::AMGCLStaticTraits<
+        typename AMGCLTraits<BlockSize>::template Impl<amgcl::backend::builtin,ValueType>,
+        TCoarsening,
+        TRelaxation
+    >>;
+
     template <unsigned BlockSize>
-    using AMGCLTraits = Detail::AMGCLTraits<TSparseSpace,BlockSize>;
+    using CachedBundle = Detail::AMGCLBundle<Detail::AMGCLCachedTraits<
+        typename AMGCLTraits<BlockSize>::template Impl<amgcl::backend::builtin,ValueType>
+    >>;
 
     // A variant for grouping members related to the wrapped AMGCL solver. It's meant
     // to bundle solvers using different backends as well as its associated matrix wrapper.
     // The wrapped types are composed of the permutations of the following attributes:
     // - block size [1, 2, 3, 4, 5, 6]
     // - backend type [bultin, vexcl]
+    // - preconditioner precision [full, single (builtin only)]
+    // - runtime or compile-time configured solver (builtin, full precision, block sizes 1 and 3 only)
+    // - runtime configured AMG with cached levels (builtin, full precision only)
     std::variant<
         // Dummy type to enable the default constructor.
         std::monostate,
@@ -289,7 +2271,43 @@ struct AMGCLWrapper<TSparseSpace,TDenseSpace,TReorderer>::Impl
         Detail::AMGCLBundle<typename AMGCLTraits<5>::template Impl<amgcl::backend::builtin,ValueType>>,
 
         // Double precision CPU backend with a block size of 6.
-        Detail::AMGCLBundle<typename AMGCLTraits<6>::template Impl<amgcl::backend::builtin,ValueType>>
+        Detail::AMGCLBundle<typename AMGCLTraits<6>::template Impl<amgcl::backend::builtin,ValueType>>,
+
+        // Mixed precision CPU backend with a block size of 1.
+        Detail::AMGCLBundle<typename AMGCLTraits<1,true>::template Impl<amgcl::backend::builtin,ValueType>>,
+
+        // Mixed precision CPU backend with a block size of 2.
+        Detail::AMGCLBundle<typename AMGCLTraits<2,true>::template Impl<amgcl::backend::builtin,ValueType>>,
+
+        // Mixed precision CPU backend with a block size of 3.
+        Detail::AMGCLBundle<typename AMGCLTraits<3,true>::template Impl<amgcl::backend::builtin,ValueType>>,
+
+        // Mixed precision CPU backend with a block size of 4.
+        Detail::AMGCLBundle<typename AMGCLTraits<4,true>::template Impl<amgcl::backend::builtin,ValueType>>,
+
+        // Mixed precision CPU backend with a block size of 5.
+        Detail::AMGCLBundle<typename AMGCLTraits<5,true>::template Impl<amgcl::backend::builtin,ValueType>>,
+
+        // Mixed precision CPU backend with a block size of 6.
+        Detail::AMGCLBundle<typename AMGCLTraits<6,true>::template Impl<amgcl::backend::builtin,ValueType>>,
+
+        // Compile-time configured CPU solvers with block sizes of 1 and 3.
+        StaticBundle<1, amgcl::coarsening::aggregation, amgcl::relaxation::ilu0>,
+        StaticBundle<1, amgcl::coarsening::aggregation, amgcl::relaxation::spai0>,
+        StaticBundle<1, amgcl::coarsening::smoothed_aggregation, amgcl::relaxation::ilu0>,
+        StaticBundle<1, amgcl::coarsening::smoothed_aggregation, amgcl::relaxation::spai0>,
+        StaticBundle<3, amgcl::coarsening::aggregation, amgcl::relaxation::ilu0>,
+        StaticBundle<3, amgcl::coarsening::aggregation, amgcl::relaxation::spai0>,
+        StaticBundle<3, amgcl::coarsening::smoothed_aggregation, amgcl::relaxation::ilu0>,
+        StaticBundle<3, amgcl::coarsening::smoothed_aggregation, amgcl::relaxation::spai0>,
+
+        // Runtime configured CPU AMG with cached levels and block sizes of 1-6.
+        CachedBundle<1>,
+        CachedBundle<2>,
+        CachedBundle<3>,
+        CachedBundle<4>,
+        CachedBundle<5>,
+        CachedBundle<6>
 
         #ifdef AMGCL_GPGPU
 
@@ -375,13 +2393,169 @@ AMGCLWrapper<TSparseSpace,TDenseSpace,TReorderer>::AMGCLWrapper(Parameters param
                      << ".\n";
     }
 
+    // Get the precision of the preconditioner. Supported arguments:
+    // - "full"  : preconditioner and iterative solver use the sparse space's scalar type
+    // - "mixed" : preconditioner in single precision, iterative solver and residual in
+    //             the sparse space's scalar type
+    const std::string requested_precision = parameters["precision"].GetString();
+    if (requested_precision == "full") {
+        mpImpl->mMixedPrecision = false;
+    } else if (requested_precision == "mixed") {
+        KRATOS_ERROR_IF_NOT(mpImpl->mBackendType == AMGCLBackendType::CPU)
+            << "mixed precision is only supported on the 'cpu' backend\n";
+        if constexpr (std::is_same_v<typename Impl::ValueType,float>) {
+            KRATOS_WARNING_IF("AMGCLWrapper", 1 <= mpImpl->mVerbosity)
+                << "ignoring mixed precision because the system is already in single precision\n";
+        } else {
+            mpImpl->mMixedPrecision = true;
+        }
+    } else {
+        KRATOS_ERROR << "unsupported argument for 'precision': "
+                     << requested_precision
+                     << ". Available options are \"full\" or \"mixed\".\n";
+    }
+
+    // Get the hierarchy reuse policy. Supported arguments:
+    // - "rebuild"   : construct a new hierarchy at every step
+    // - "unchanged" : reuse the hierarchy if the matrix' address, pattern and values are the same
+    // - "adaptive"  : reuse the hierarchy if the matrix' address and pattern are the same,
+    //                 until the rebuild interval is reached or the iteration count grows too much
+    Parameters reuse_parameters = parameters["hierarchy_reuse"];
+    reuse_parameters.ValidateAndAssignDefaults(default_parameters["hierarchy_reuse"]);
+    const std::string requested_reuse_policy = reuse_parameters["policy"].GetString();
+    if (requested_reuse_policy == "rebuild") {
+        mpImpl->mReusePolicy = AMGCLReusePolicy::Rebuild;
+    } else if (requested_reuse_policy == "unchanged") {
+        mpImpl->mReusePolicy = AMGCLReusePolicy::Unchanged;
+    } else if (requested_reuse_policy == "adaptive") {
+        mpImpl->mReusePolicy = AMGCLReusePolicy::Adaptive;
+    } else {
+        KRATOS_ERROR << "unsupported argument for 'hierarchy_reuse.policy': "
+                     << requested_reuse_policy
+                     << ". Available options are \"rebuild\", \"unchanged\" or \"adaptive\".\n";
+    }
+
+    const int rebuild_interval = reuse_parameters["rebuild_interval"].Get<int>();
+    KRATOS_ERROR_IF(rebuild_interval < 0)
+        << "'hierarchy_reuse.rebuild_interval' must be non-negative, got " << rebuild_interval << "\n";
+    mpImpl->mRebuildInterval = rebuild_interval;
+
+    mpImpl->mMaxIterationGrowth = reuse_parameters["max_iteration_growth"].Get<double>();
+    KRATOS_ERROR_IF(mpImpl->mMaxIterationGrowth < 0.0)
+        << "'hierarchy_reuse.max_iteration_growth' must be non-negative, got " << mpImpl->mMaxIterationGrowth << "\n";
+
+    mpImpl->mUseRigidBodyModes = parameters["use_rigid_body_modes"].Get<bool>();
+    mpImpl->mStaticDispatch = parameters["static_dispatch"].Get<bool>();
+    mpImpl->mFirstTouch = parameters["first_touch"].Get<bool>();
+
+    // Levels are only cached if a directory is provided, which gets created if necessary.
+    Parameters cache_parameters = parameters["hierarchy_cache"];
+    cache_parameters.ValidateAndAssignDefaults(default_parameters["hierarchy_cache"]);
+    mpImpl->mHierarchyCacheDirectory = cache_parameters["directory"].GetString();
+    if (!mpImpl->mHierarchyCacheDirectory.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(mpImpl->mHierarchyCacheDirectory, error);
+        KRATOS_ERROR_IF(error)
+            << "failed to create the hierarchy cache directory "
+            << mpImpl->mHierarchyCacheDirectory << ": " << error.message() << "\n";
+    }
+
+    // Distributed systems are either solved over the requested communicator,
+    // or over the model part's communicator if none is requested.
+    const std::string data_communicator_name = parameters["data_communicator"].GetString();
+    if (!data_communicator_name.empty()) {
+        mpImpl->mpDataCommunicator = &ParallelEnvironment::GetDataCommunicator(data_communicator_name);
+    }
+
+    // Get the initial guess. Supported arguments:
+    // - "provided"     : use the solution vector's content
+    // - "zero"         : start from 0
+    // - "previous"     : start from the previous solution
+    // - "extrapolated" : linear extrapolation from the previous 2 solutions
+    const std::string requested_initial_guess = parameters["initial_guess"].GetString();
+    if (requested_initial_guess == "provided") {
+        mpImpl->mInitialGuess = AMGCLInitialGuess::Provided;
+    } else if (requested_initial_guess == "zero") {
+        mpImpl->mInitialGuess = AMGCLInitialGuess::Zero;
+    } else if (requested_initial_guess == "previous") {
+        mpImpl->mInitialGuess = AMGCLInitialGuess::Previous;
+    } else if (requested_initial_guess == "extrapolated") {
+        mpImpl->mInitialGuess = AMGCLInitialGuess::Extrapolated;
+    } else {
+        KRATOS_ERROR << "unsupported argument for 'initial_guess': "
+                     << requested_initial_guess
+                     << ". Available options are \"provided\", \"zero\", \"previous\" or \"extrapolated\".\n";
+    }
+
+    // Get the reordering. Supported arguments:
+    // - "none" : solve the system as is
+    // - "rcm"  : reverse Cuthill-McKee on the graph of nodes (preserves DoF blocks)
+    const std::string requested_reordering = parameters["reordering"].GetString();
+    if (requested_reordering == "none") {
+        mpImpl->mReordering = AMGCLReordering::None;
+    } else if (requested_reordering == "rcm") {
+        mpImpl->mReordering = AMGCLReordering::RCM;
+    } else {
+        KRATOS_ERROR << "unsupported argument for 'reordering': "
+                     << requested_reordering
+                     << ". Available options are \"none\" or \"rcm\".\n";
+    }
+
+    const int statistics_history = parameters["statistics_history"].Get<int>();
+    KRATOS_ERROR_IF(statistics_history < 0)
+        << "'statistics_history' must be non-negative, got " << statistics_history << "\n";
+    mpImpl->mStatisticsHistory = statistics_history;
+
+    const int rhs_lanes = parameters["rhs_lanes"].Get<int>();
+    KRATOS_ERROR_IF(rhs_lanes < 1)
+        << "'rhs_lanes' must be positive, got " << rhs_lanes << "\n";
+    mpImpl->mRHSLanes = rhs_lanes;
+
+    for (std::size_t i_fallback=0; i_fallback<parameters["fallbacks"].size(); ++i_fallback) {
+        Parameters fallback = parameters["fallbacks"][i_fallback];
+        KRATOS_ERROR_IF_NOT(fallback.IsSubParameter() && fallback.Has("solver_type"))
+            << "entry " << i_fallback << " of 'fallbacks' must be a linear solver's settings with a 'solver_type', got "
+            << fallback << "\n";
+        mpImpl->mFallbackSettings.push_back(fallback.Clone());
+    }
+    mpImpl->mFallbacks.resize(mpImpl->mFallbackSettings.size());
+
     // Convert parameters to AMGCL settings
-    std::stringstream json_stream;
-    json_stream << parameters["amgcl_settings"].PrettyPrintJsonString();
-    boost::property_tree::read_json(
-        json_stream,
-        mpImpl->mAMGCLSettings
-    );
+    mpImpl->mAMGCLSettings = Detail::MakePropertyTree(parameters["amgcl_settings"]);
+
+    // Derive the settings of the solvers constructed in InitializeSolutionStep here,
+    // so that they are matched and converted once instead of at every setup.
+    const bool is_cpu = mpImpl->mBackendType == AMGCLBackendType::CPU && !mpImpl->mMixedPrecision;
+    if (!mpImpl->mHierarchyCacheDirectory.empty() || mpImpl->mFirstTouch) {
+        if (is_cpu && mpImpl->mAMGCLSettings.get<std::string>("precond.class", "amg") == "amg") {
+            auto& r_settings = mpImpl->mMaybeCachedAMGSettings.emplace(mpImpl->mAMGCLSettings);
+            if (!mpImpl->mHierarchyCacheDirectory.empty()) {
+                // Cached levels must not be reused if any AMG setting changed, not only the coarsening's.
+                std::stringstream precond_settings;
+                if (auto p_precond = r_settings.get_child_optional("precond")) {
+                    boost::property_tree::write_json(precond_settings, p_precond.get(), false);
+                }
+                r_settings.put("precond.coarsening.cache.precond_hash", std::hash<std::string>()(precond_settings.str()));
+                r_settings.put("precond.coarsening.cache.directory", mpImpl->mHierarchyCacheDirectory.string());
+                r_settings.put("precond.coarsening.cache.verbose", 2 <= mpImpl->mVerbosity);
+            }
+            if (mpImpl->mFirstTouch) r_settings.put("precond.coarsening.first_touch", true);
+        } else {
+            KRATOS_WARNING_IF("AMGCLWrapper", 1 <= mpImpl->mVerbosity)
+                << "the hierarchy cache and first touch allocation are ignored because they require"
+                << " an AMG preconditioner on the 'cpu' backend in full precision\n";
+        }
+    }
+
+    if (mpImpl->mStaticDispatch && is_cpu) {
+        mpImpl->mMaybeStaticConfiguration = Detail::MatchStaticConfiguration(
+            mpImpl->mMaybeCachedAMGSettings.has_value() ? mpImpl->mMaybeCachedAMGSettings.value() : mpImpl->mAMGCLSettings);
+    }
+
+    // AMG's own settings have no class selector.
+    if (mpImpl->mMaybeCachedAMGSettings.has_value()) {
+        if (auto p_precond = mpImpl->mMaybeCachedAMGSettings->get_child_optional("precond")) p_precond->erase("class");
+    }
     KRATOS_CATCH("")
 }
 
@@ -413,57 +2587,127 @@ bool AMGCLWrapper<TSparseSpace,TDenseSpace,TReorderer>::PerformSolutionStep(Spar
         << "solver got a different matrix than it was initialized with "
         << &rA << " != " << mpImpl->mpA << "\n";
 
-    const auto [iteration_count, residual] = std::visit(
-        [&rB, &rX] (auto& rBundle) -> std::tuple<std::size_t,double> {
-            using BundleType = std::remove_reference_t<decltype(rBundle)>;
-
-            if constexpr (!std::is_same_v<BundleType,std::monostate>) {
-                const std::size_t system_block_size = rX.size() / BundleType::Traits::BlockSize;
-
-                #ifdef AMGCL_GPGPU
-                if constexpr (BundleType::Traits::IsGPUBound) {
-                    auto& vexcl_context = GetVexCLContext();
-                    KRATOS_ERROR_IF_NOT(vexcl_context) << "invalid VexCL context state\n";
-
-                    typename BundleType::Traits::RHS* x_begin = reinterpret_cast<typename BundleType::Traits::RHS*>(&*rX.begin());
-                    typename BundleType::Traits::RHS* b_begin = reinterpret_cast<typename BundleType::Traits::RHS*>(&*rB.begin());
-
-                    // Transfer system vectors to the GPU
-                    vex::vector<typename BundleType::Traits::RHS> x_gpu(vexcl_context, system_block_size, x_begin);
-                    vex::vector<typename BundleType::Traits::RHS> b_gpu(vexcl_context, system_block_size, b_begin);
-
-                    // Solve
-                    const auto results = rBundle.mpSolver->operator()(b_gpu, x_gpu);
-
-                    // Fetch solution from the GPU and return
-                    vex::copy(x_gpu.begin(), x_gpu.end(), x_begin);
-                    return results;
-                } /*if BundleType::Traits::IsGPUBound*/ else
-                #endif
-                {
-                    // Solve and return
-                    auto x_begin = reinterpret_cast<typename BundleType::Traits::RHS*>(&*rX.begin());
-                    auto b_begin = reinterpret_cast<typename BundleType::Traits::RHS*>(&*rB.begin());
-                    return rBundle.mpSolver->operator()(boost::make_iterator_range(b_begin, b_begin + system_block_size),
-                                                        boost::make_iterator_range(x_begin, x_begin + system_block_size));
-                }
-            } else /*BundleType != std::monostate*/ {
-                KRATOS_ERROR << "AMGCL solver type is unset. Did you forget to call AMGCLWrapper::ProvideAdditionalData?\n";
+    // Overwrite the starting iterate if requested. Warm starts fall back
+    // to the provided vector until enough solutions are recorded.
+    auto& r_history = mpImpl->mSolutionHistory;
+    if (mpImpl->mSolutionHistorySize && r_history[0].size() != rX.size())
+        mpImpl->mSolutionHistorySize = 0;
+
+    switch (mpImpl->mInitialGuess) {
+        case AMGCLInitialGuess::Provided: break;
+        case AMGCLInitialGuess::Zero: {
+            TSparseSpace::SetToZero(rX);
+            break;
+        }
+        case AMGCLInitialGuess::Previous: {
+            if (mpImpl->mSolutionHistorySize) TSparseSpace::Copy(r_history[0], rX);
+            break;
+        }
+        case AMGCLInitialGuess::Extrapolated: {
+            if (mpImpl->mSolutionHistorySize == 2) {
+                IndexPartition<std::size_t>(rX.size()).for_each([&rX, &r_history](std::size_t i){
+                    rX[i] = 2 * r_history[0][i] - r_history[1][i];
+                });
+            } else if (mpImpl->mSolutionHistorySize) {
+                TSparseSpace::Copy(r_history[0], rX);
             }
-        },
-        mpImpl->mSolverBundle
-    );
+            break;
+        }
+    } // switch mpImpl->mInitialGuess
+
+    // Keep the starting iterate for the fallbacks.
+    const bool has_fallbacks = !mpImpl->mFallbackSettings.empty() && !mpImpl->IsDistributed();
+    if (has_fallbacks) {
+        if (mpImpl->mFallbackX.size() != rX.size()) mpImpl->mFallbackX.resize(rX.size(), false);
+        TSparseSpace::Copy(rX, mpImpl->mFallbackX);
+    }
+
+    BuiltinTimer solve_timer;
+
+    // Solve the permuted system if reordering is enabled.
+    const bool is_reordered = mpImpl->mReordering != AMGCLReordering::None;
+    if (is_reordered) {
+        mpImpl->mPermutation.Permute(rB, mpImpl->mPermutedB);
+        mpImpl->mPermutation.Permute(rX, mpImpl->mPermutedX);
+    }
+    Vector& r_system_b = is_reordered ? mpImpl->mPermutedB : rB;
+    Vector& r_system_x = is_reordered ? mpImpl->mPermutedX : rX;
+
+    const auto [iteration_count, residual] = [&]() -> std::tuple<std::size_t,double> {
+        #ifdef KRATOS_USING_MPI
+        if (mpImpl->mpDistributedBundle) {
+            auto& rp_partition = mpImpl->mpPartition;
+            if (!rp_partition) return mpImpl->mpDistributedBundle->Solve(r_system_b, r_system_x);
+
+            rp_partition->GatherVectors(r_system_b, r_system_x);
+            const auto results = mpImpl->mpDistributedBundle->Solve(rp_partition->mStripB, rp_partition->mStripX);
+            rp_partition->ScatterSolution(r_system_x);
+            return results;
+        }
+        #endif
+        return std::visit(
+            [&rB = r_system_b, &rX = r_system_x] (auto& rBundle) -> std::tuple<std::size_t,double> {
+                using BundleType = std::remove_reference_t<decltype(rBundle)>;
+
+                if constexpr (!std::is_same_v<BundleType,std::monostate>) {
+                    return Detail::SolveWithBundle(rBundle, rX, rB);
+                } else /*BundleType != std::monostate*/ {
+                    KRATOS_ERROR << "AMGCL solver type is unset. Did you forget to call AMGCLWrapper::ProvideAdditionalData?\n";
+                }
+            },
+            mpImpl->mSolverBundle
+        );
+    }();
+
+    if (is_reordered) {
+        mpImpl->mPermutation.InversePermute(mpImpl->mPermutedX, rX);
+    }
 
     KRATOS_WARNING_IF("AMGCLWrapper", 1 <= mpImpl->mVerbosity && mpImpl->mTolerance <= residual)
         << "Failed to converge. Residual: " << residual << "\n";
 
-    if(2 <= mpImpl->mVerbosity) {
-        std::cout << "Iterations: " << iteration_count << "\n"
-                  << "Error: " << residual << "\n"
-                  << "\n";
+    const double solve_time = solve_timer.ElapsedSeconds();
+
+    // Try the fallbacks in order until one of them converges.
+    bool converged = residual < mpImpl->mTolerance;
+    std::size_t fallback_count = 0;
+    BuiltinTimer fallback_timer;
+    if (!converged && has_fallbacks) {
+        if (mpImpl->mFallbackB.size() != rB.size()) mpImpl->mFallbackB.resize(rB.size(), false);
+        TSparseSpace::Copy(rB, mpImpl->mFallbackB);
+
+        for (; fallback_count<mpImpl->mFallbacks.size() && !converged; ++fallback_count) {
+            auto& rp_fallback = mpImpl->mFallbacks[fallback_count];
+            if (!rp_fallback)
+                rp_fallback = LinearSolverFactory<TSparseSpace,TDenseSpace>().Create(mpImpl->mFallbackSettings[fallback_count]);
+
+            if (fallback_count) TSparseSpace::Copy(mpImpl->mFallbackB, rB);
+            TSparseSpace::Copy(mpImpl->mFallbackX, rX);
+            if (rp_fallback->AdditionalPhysicalDataIsNeeded() && mpImpl->mpDofs && mpImpl->mpModelPart)
+                rp_fallback->ProvideAdditionalData(rA, rX, rB, *mpImpl->mpDofs, *mpImpl->mpModelPart);
+            converged = rp_fallback->Solve(rA, rX, rB);
+
+            KRATOS_INFO_IF("AMGCLWrapper", 1 <= mpImpl->mVerbosity)
+                << "fallback " << fallback_count << " (" << mpImpl->mFallbackSettings[fallback_count]["solver_type"].GetString() << ") "
+                << (converged ? "converged" : "failed to converge") << "\n";
+        }
+    }
+    const double fallback_time = fallback_count ? fallback_timer.ElapsedSeconds() : 0.0;
+
+    mpImpl->RecordSolve(iteration_count, residual, solve_time, fallback_count, fallback_time);
+
+    // Record the solution for warm starts.
+    if (mpImpl->mInitialGuess == AMGCLInitialGuess::Previous || mpImpl->mInitialGuess == AMGCLInitialGuess::Extrapolated) {
+        std::swap(r_history[0], r_history[1]);
+        if (r_history[0].size() != rX.size()) r_history[0].resize(rX.size(), false);
+        TSparseSpace::Copy(rX, r_history[0]);
+        mpImpl->mSolutionHistorySize = std::min<std::size_t>(mpImpl->mSolutionHistorySize + 1, r_history.size());
     }
 
-    return residual < mpImpl->mTolerance;
+    KRATOS_INFO_IF("AMGCLWrapper", 2 <= mpImpl->mVerbosity)
+        << "iterations: " << iteration_count << " residual: " << residual << "\n";
+
+    return converged;
     KRATOS_CATCH("")
 }
 
@@ -568,6 +2812,112 @@ std::size_t FindBlockSize(const ModelPart& rModelPart,
 
 
 
+// Construct the rigid body modes of the system from nodal coordinates.
+// Modes are stored row-major (the modes of an equation are contiguous) as AMGCL expects them.
+// - 3D (any node has a DISPLACEMENT_Z DoF): 3 translations followed by 3 rotations about the x, y and z axes.
+// - 2D: 2 translations followed by a rotation about the z axis.
+// Rotations are about the centroid of the nodes to improve the conditioning of the modes.
+// DISPLACEMENT_* DoFs get the displacement field of each mode, while ROTATION_* DoFs get
+// the rotation field (1 for the mode rotating about the same axis). Rows of other DoFs are left
+// empty, and DoFs whose equation ids fall outside the system (eliminated by the builder) are skipped.
+// Returns the number of modes, or 0 if the system has no displacement DoFs.
+inline std::size_t MakeRigidBodyModes(ModelPart& rModelPart,
+                                      const ModelPart::DofsArrayType& rDofs,
+                                      std::size_t SystemSize,
+                                      std::vector<double>& rModes)
+{
+    KRATOS_TRY
+
+    struct Entry
+    {
+        std::size_t mEquationId;
+        unsigned mComponent;
+        bool mIsRotation;
+        const Node* mpNode;
+    }; // struct Entry
+
+    const std::array<VariableData::KeyType,3> displacement_keys {DISPLACEMENT_X.Key(), DISPLACEMENT_Y.Key(), DISPLACEMENT_Z.Key()};
+    const std::array<VariableData::KeyType,3> rotation_keys {ROTATION_X.Key(), ROTATION_Y.Key(), ROTATION_Z.Key()};
+
+    // Collect mechanical DoFs and their nodes. DoFs are sorted by node,
+    // so the node lookup is only necessary when the node changes.
+    std::vector<Entry> entries;
+    entries.reserve(rDofs.size());
+    bool is_3d = false;
+    bool has_displacement = false;
+    const Node* p_node = nullptr;
+    array_1d<double,3> centroid = ZeroVector(3);
+    std::size_t node_count = 0;
+
+    for (const auto& r_dof : rDofs) {
+        const std::size_t equation_id = r_dof.EquationId();
+        if (SystemSize <= equation_id) continue;
+
+        const auto key = r_dof.GetVariable().Key();
+        const auto it_displacement = std::find(displacement_keys.begin(), displacement_keys.end(), key);
+        const auto it_rotation = std::find(rotation_keys.begin(), rotation_keys.end(), key);
+        if (it_displacement == displacement_keys.end() && it_rotation == rotation_keys.end()) continue;
+
+        if (!p_node || p_node->Id() != r_dof.Id()) {
+            const auto it_node = rModelPart.Nodes().find(r_dof.Id());
+            KRATOS_ERROR_IF(it_node == rModelPart.Nodes().end())
+                << "node " << r_dof.Id() << " of DoF " << r_dof.GetVariable().Name()
+                << " is not in model part '" << rModelPart.Name() << "'\n";
+            p_node = &*it_node;
+            centroid += p_node->Coordinates();
+            ++node_count;
+        }
+
+        if (it_displacement != displacement_keys.end()) {
+            const unsigned component = std::distance(displacement_keys.begin(), it_displacement);
+            entries.push_back(Entry {equation_id, component, false, p_node});
+            has_displacement = true;
+            is_3d |= component == 2;
+        } else {
+            const unsigned component = std::distance(rotation_keys.begin(), it_rotation);
+            entries.push_back(Entry {equation_id, component, true, p_node});
+        }
+    } // for r_dof in rDofs
+
+    rModes.clear();
+    if (!has_displacement) return 0;
+    centroid /= static_cast<double>(node_count);
+
+    const std::size_t mode_count = is_3d ? 6 : 3;
+    rModes.resize(SystemSize * mode_count, 0.0);
+
+    IndexPartition<std::size_t>(entries.size()).for_each([&](std::size_t i_entry){
+        const Entry& r_entry = entries[i_entry];
+        const array_1d<double,3> r = r_entry.mpNode->Coordinates() - centroid;
+        double* p_row = rModes.data() + r_entry.mEquationId * mode_count;
+
+        if (is_3d) {
+            if (r_entry.mIsRotation) {
+                p_row[3 + r_entry.mComponent] = 1.0;
+            } else {
+                p_row[r_entry.mComponent] = 1.0;
+                switch (r_entry.mComponent) {
+                    case 0: p_row[4] =  r[2]; p_row[5] = -r[1]; break;
+                    case 1: p_row[3] = -r[2]; p_row[5] =  r[0]; break;
+                    case 2: p_row[3] =  r[1]; p_row[4] = -r[0]; break;
+                }
+            }
+        } else {
+            if (r_entry.mIsRotation) {
+                if (r_entry.mComponent == 2) p_row[2] = 1.0;
+            } else {
+                p_row[r_entry.mComponent] = 1.0;
+                p_row[2] = r_entry.mComponent ? r[0] : -r[1];
+            }
+        }
+    });
+
+    return mode_count;
+    KRATOS_CATCH("")
+}
+
+
+
 template<class TSparseSpace,
          class TDenseSpace,
          class TReorderer>
@@ -586,51 +2936,289 @@ void AMGCLWrapper<TSparseSpace,TDenseSpace,TReorderer>::InitializeSolutionStep(S
     // Construct solver and matrix adapter
     mpImpl->mpA = &rA;
 
-    #define KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE_WITH_BLOCK_SIZE(BACKEND_TEMPLATE, BACKEND_SCALAR, BLOCK_SIZE)  \
-        using Bundle = Detail::AMGCLBundle<typename Detail::AMGCLTraits<TSparseSpace,1>::template               \
-                    Impl<BACKEND_TEMPLATE,BACKEND_SCALAR>>;                                                     \
-        mpImpl->mSolverBundle = Bundle(rA, mpImpl->mAMGCLSettings)
-
-    #define KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE(BACKEND_TEMPLATE, BACKEND_SCALAR)                          \
-        switch (mpImpl->mMaybeDoFCount.value()) {                                                           \
-            case 1: {                                                                                       \
-                KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE_WITH_BLOCK_SIZE(BACKEND_TEMPLATE, BACKEND_SCALAR, 1);  \
-                break;                                                                                      \
-            }                                                                                               \
-            case 2: {                                                                                       \
-                KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE_WITH_BLOCK_SIZE(BACKEND_TEMPLATE, BACKEND_SCALAR, 2);  \
-                break;                                                                                      \
-            }                                                                                               \
-            case 3: {                                                                                       \
-                KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE_WITH_BLOCK_SIZE(BACKEND_TEMPLATE, BACKEND_SCALAR, 3);  \
-                break;                                                                                      \
-            }                                                                                               \
-            case 4: {                                                                                       \
-                KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE_WITH_BLOCK_SIZE(BACKEND_TEMPLATE, BACKEND_SCALAR, 4);  \
-                break;                                                                                      \
-            }                                                                                               \
-            case 5: {                                                                                       \
-                KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE_WITH_BLOCK_SIZE(BACKEND_TEMPLATE, BACKEND_SCALAR, 5);  \
-                break;                                                                                      \
-            }                                                                                               \
-            case 6: {                                                                                       \
-                KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE_WITH_BLOCK_SIZE(BACKEND_TEMPLATE, BACKEND_SCALAR, 6);  \
-                break;                                                                                      \
-            }                                                                                               \
-            default: KRATOS_ERROR << "unsupported block size: " << mpImpl->mMaybeDoFCount.value() << "\n";  \
-        } // switch mpImpl->mMaybeDoFCount.value()
+    // Distributed systems are solved with AMGCL's MPI components.
+    if (mpImpl->IsDistributed()) {
+        #ifdef KRATOS_USING_MPI
+            KRATOS_ERROR_IF_NOT(mpImpl->mBackendType == AMGCLBackendType::CPU)
+                << "distributed systems are only supported on the 'cpu' backend\n";
+            KRATOS_ERROR_IF(mpImpl->mMixedPrecision)
+                << "mixed precision is not supported for distributed systems\n";
+            KRATOS_ERROR_IF(mpImpl->mReusePolicy != AMGCLReusePolicy::Rebuild)
+                << "hierarchy reuse is not supported for distributed systems\n";
+            KRATOS_ERROR_IF(mpImpl->mReordering != AMGCLReordering::None)
+                << "reordering is not supported for distributed systems\n";
+            KRATOS_ERROR_IF(mpImpl->mUseRigidBodyModes)
+                << "rigid body modes are not supported for distributed systems\n";
+
+            // AMGCL expects the rows owned by this rank with global column indices (see the class docs).
+            BuiltinTimer setup_timer;
+            if (mpImpl->mpPartition) {
+                mpImpl->mpPartition->AssembleStrip(rA);
+                KRATOS_INFO_IF("AMGCLWrapper", 2 <= mpImpl->mVerbosity)
+                    << "assembled " << mpImpl->mpPartition->mStrip.size1() << " owned rows of "
+                    << mpImpl->mpPartition->mGlobalSize << " in " << setup_timer.ElapsedSeconds() << " [s]\n";
+            } else {
+                KRATOS_ERROR_IF(rB.size() != rA.size1() || rX.size() != rA.size1())
+                    << "the local system matrix has " << rA.size1() << " rows, but the right hand side has "
+                    << rB.size() << " and the solution " << rX.size() << " components\n";
+                const std::size_t global_size = mpImpl->mpDataCommunicator->SumAll(static_cast<std::size_t>(rA.size1()));
+                KRATOS_ERROR_IF(rA.size2() != global_size)
+                    << "the local system matrix has " << rA.size2() << " columns, but the global system has "
+                    << global_size << " rows. Systems distributed without a DoF set must consist of the rows"
+                    << " owned by each rank with global column indices\n";
+            }
+
+            mpImpl->mpDistributedBundle.reset();
+            mpImpl->mpDistributedBundle = std::make_unique<Detail::AMGCLDistributedBundle<TSparseSpace>>(
+                mpImpl->mpPartition ? mpImpl->mpPartition->mStrip : rA,
+                MPIDataCommunicator::GetMPICommunicator(*mpImpl->mpDataCommunicator),
+                mpImpl->mAMGCLSettings);
+
+            mpImpl->mSetupTime = setup_timer.ElapsedSeconds();
+            mpImpl->mSolveCountSinceSetup = 0;
+            KRATOS_INFO_IF("AMGCLWrapper", 2 <= mpImpl->mVerbosity)
+                << "distributed hierarchy setup took " << mpImpl->mSetupTime << " [s]\n";
+
+            // The levels of distributed hierarchies are not recorded.
+            mpImpl->mHierarchyStatistics = {};
+            return;
+        #else
+            KRATOS_ERROR << "the system is distributed but the UtilityApplication was compiled without MPI support\n";
+        #endif
+    } // if mpImpl->IsDistributed()
+
+    // Permute the system if requested. The permutation is only recomputed
+    // if the sparsity pattern changed, otherwise the values are gathered.
+    const bool is_reordered = mpImpl->mReordering != AMGCLReordering::None;
+    if (is_reordered) {
+        auto& r_permutation = mpImpl->mPermutation;
+        if (r_permutation.Matches(rA, mpImpl->mMaybeDoFCount.value())) {
+            r_permutation.UpdateValues(rA);
+        } else {
+            BuiltinTimer reordering_timer;
+            r_permutation.Compute(rA, mpImpl->mMaybeDoFCount.value());
+            KRATOS_INFO_IF("AMGCLWrapper", 2 <= mpImpl->mVerbosity)
+                << "reordering took " << reordering_timer.ElapsedSeconds() << " [s], "
+                << "bandwidth " << Detail::SystemPermutation<TSparseSpace>::ComputeBandwidth(rA)
+                << " => " << Detail::SystemPermutation<TSparseSpace>::ComputeBandwidth(r_permutation.mMatrix) << "\n";
+        }
+        r_permutation.Permute(rB, mpImpl->mPermutedB);
+    }
+    const SparseMatrix& r_system_a = is_reordered ? mpImpl->mPermutation.mMatrix : rA;
+    const Vector& r_system_b = is_reordered ? mpImpl->mPermutedB : rB;
+
+    // Decide whether the existing hierarchy can be reused.
+    if (mpImpl->mReusePolicy != AMGCLReusePolicy::Rebuild) {
+        const auto fingerprint = Detail::MatrixFingerprint::Make(rA, mpImpl->mMaybeDoFCount.value());
+        const bool has_hierarchy = !std::holds_alternative<std::monostate>(mpImpl->mSolverBundle);
+        std::string rebuild_reason;
+
+        if (!has_hierarchy) {
+            rebuild_reason = "no hierarchy yet";
+        } else if (!fingerprint.HasSamePattern(mpImpl->mHierarchyFingerprint)) {
+            rebuild_reason = "system matrix address, storage or sparsity pattern changed";
+        } else if (mpImpl->mReusePolicy == AMGCLReusePolicy::Unchanged && !fingerprint.HasSameValues(mpImpl->mHierarchyFingerprint)) {
+            rebuild_reason = "system matrix values changed";
+        } else if (mpImpl->mReusePolicy == AMGCLReusePolicy::Adaptive && mpImpl->mRebuildInterval && mpImpl->mRebuildInterval <= mpImpl->mReuseCount) {
+            rebuild_reason = "reached the rebuild interval (" + std::to_string(mpImpl->mRebuildInterval) + ")";
+        } else if (mpImpl->mReusePolicy == AMGCLReusePolicy::Adaptive
+                   && mpImpl->mMaybeReferenceIterationCount.has_value()
+                   && (1.0 + mpImpl->mMaxIterationGrowth) * mpImpl->mMaybeReferenceIterationCount.value() < mpImpl->mLastIterationCount) {
+            rebuild_reason = "iteration count grew from " + std::to_string(mpImpl->mMaybeReferenceIterationCount.value())
+                           + " to " + std::to_string(mpImpl->mLastIterationCount);
+        }
+
+        if (rebuild_reason.empty()) {
+            ++mpImpl->mReuseCount;
+
+            // The preconditioner is kept, but the iterative solver must work on the current system.
+            if (!fingerprint.HasSameValues(mpImpl->mHierarchyFingerprint)) {
+                std::visit(
+                    [&r_system_a](auto& rBundle) {
+                        using BundleType = std::remove_reference_t<decltype(rBundle)>;
+                        if constexpr (!std::is_same_v<BundleType,std::monostate>) {
+                            rBundle.UpdateSystemMatrix(r_system_a);
+                        }
+                    },
+                    mpImpl->mSolverBundle);
+                mpImpl->mHierarchyFingerprint.mValueHash = fingerprint.mValueHash;
+            }
+
+            KRATOS_INFO_IF("AMGCLWrapper", 2 <= mpImpl->mVerbosity)
+                << "reusing hierarchy (step " << mpImpl->mReuseCount << " since setup), "
+                << "skipped " << mpImpl->mSetupTime << " [s] of setup\n";
+            return;
+        }
+
+        KRATOS_INFO_IF("AMGCLWrapper", 2 <= mpImpl->mVerbosity)
+            << "rebuilding hierarchy: " << rebuild_reason << "\n";
+        mpImpl->mHierarchyFingerprint = fingerprint;
+    } // if mReusePolicy != Rebuild
+
+    mpImpl->mReuseCount = 0;
+    mpImpl->mMaybeReferenceIterationCount.reset();
+    BuiltinTimer setup_timer;
+
+    // AMGCL only supports near-nullspace vectors for scalar systems, so
+    // rigid body modes replace block backends with pointwise aggregation.
+    std::size_t block_size = mpImpl->mMaybeDoFCount.value();
+    const boost::property_tree::ptree* p_settings = &mpImpl->mAMGCLSettings;
+    boost::property_tree::ptree nullspace_settings;
+    if (mpImpl->mNullSpaceColumnCount) {
+        KRATOS_ERROR_IF_NOT(mpImpl->mNullSpace.size() == rA.size1() * mpImpl->mNullSpaceColumnCount)
+            << "rigid body modes were constructed for a system of size "
+            << mpImpl->mNullSpace.size() / mpImpl->mNullSpaceColumnCount
+            << " but the system matrix is of size " << rA.size1() << "\n";
+        nullspace_settings = mpImpl->mAMGCLSettings;
+        nullspace_settings.put("precond.coarsening.nullspace.cols", mpImpl->mNullSpaceColumnCount);
+        nullspace_settings.put("precond.coarsening.nullspace.rows", rA.size1());
+        if (is_reordered) {
+            mpImpl->mPermutation.PermuteRows(mpImpl->mNullSpace, mpImpl->mNullSpaceColumnCount, mpImpl->mPermutedNullSpace);
+        }
+        nullspace_settings.put("precond.coarsening.nullspace.B", (is_reordered ? mpImpl->mPermutedNullSpace : mpImpl->mNullSpace).data());
+        nullspace_settings.put("precond.coarsening.aggr.block_size", block_size);
+        p_settings = &nullspace_settings;
+        block_size = 1;
+    }
+
+    #define KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE_WITH_BLOCK_SIZE(BACKEND_TEMPLATE, BACKEND_SCALAR, BLOCK_SIZE, MIXED_PRECISION) \
+        using Bundle = Detail::AMGCLBundle<typename Detail::AMGCLTraits<TSparseSpace,BLOCK_SIZE,MIXED_PRECISION>::template      \
+                    Impl<BACKEND_TEMPLATE,BACKEND_SCALAR>>;                                                                     \
+        mpImpl->mSolverBundle.template emplace<Bundle>(r_system_a, r_system_b, *p_settings)
+
+    #define KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE(BACKEND_TEMPLATE, BACKEND_SCALAR, MIXED_PRECISION)                             \
+        switch (block_size) {                                                                                                   \
+            case 1: {                                                                                                           \
+                KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE_WITH_BLOCK_SIZE(BACKEND_TEMPLATE, BACKEND_SCALAR, 1, MIXED_PRECISION);     \
+                break;                                                                                                          \
+            }                                                                                                                   \
+            case 2: {                                                                                                           \
+                KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE_WITH_BLOCK_SIZE(BACKEND_TEMPLATE, BACKEND_SCALAR, 2, MIXED_PRECISION);     \
+                break;                                                                                                          \
+            }                                                                                                                   \
+            case 3: {                                                                                                           \
+                KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE_WITH_BLOCK_SIZE(BACKEND_TEMPLATE, BACKEND_SCALAR, 3, MIXED_PRECISION);     \
+                break;                                                                                                          \
+            }                                                                                                                   \
+            case 4: {                                                                                                           \
+                KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE_WITH_BLOCK_SIZE(BACKEND_TEMPLATE, BACKEND_SCALAR, 4, MIXED_PRECISION);     \
+                break;                                                                                                          \
+            }                                                                                                                   \
+            case 5: {                                                                                                           \
+                KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE_WITH_BLOCK_SIZE(BACKEND_TEMPLATE, BACKEND_SCALAR, 5, MIXED_PRECISION);     \
+                break;                                                                                                          \
+            }                                                                                                                   \
+            case 6: {                                                                                                           \
+                KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE_WITH_BLOCK_SIZE(BACKEND_TEMPLATE, BACKEND_SCALAR, 6, MIXED_PRECISION);     \
+                break;                                                                                                          \
+            }                                                                                                                   \
+            default: KRATOS_ERROR << "unsupported block size: " << block_size << "\n";                                          \
+        } // switch block_size
+
+    // Cached levels are keyed by their matrices only, which does not capture
+    // near-nullspace vectors coarsened along with the hierarchy. First touch
+    // allocation on its own goes through the same coarsening and has no such restriction.
+    const bool use_cache = mpImpl->mMaybeCachedAMGSettings.has_value()
+                           && (!mpImpl->mNullSpaceColumnCount || mpImpl->mHierarchyCacheDirectory.empty());
+    KRATOS_WARNING_IF("AMGCLWrapper", mpImpl->mMaybeCachedAMGSettings.has_value() && !use_cache && 1 <= mpImpl->mVerbosity)
+        << "the hierarchy cache is ignored because rigid body modes are used\n";
+
+    // Prefer compile-time configured solvers if one matches the settings,
+    // and fall back to the runtime configured ones otherwise.
+    bool is_static = false;
+    if (mpImpl->mMaybeStaticConfiguration.has_value() && (block_size == 1 || block_size == 3)) {
+        const auto& r_configuration = mpImpl->mMaybeStaticConfiguration.value();
+
+        // Near-nullspace vectors are only known at this point, and their levels are not cached.
+        const boost::property_tree::ptree* p_static_settings = &r_configuration.mSettings;
+        boost::property_tree::ptree static_nullspace_settings;
+        if (mpImpl->mNullSpaceColumnCount) {
+            static_nullspace_settings = r_configuration.mSettings;
+            static_nullspace_settings.put_child("precond.coarsening.nullspace", p_settings->get_child("precond.coarsening.nullspace"));
+            static_nullspace_settings.put("precond.coarsening.aggr.block_size", mpImpl->mMaybeDoFCount.value());
+            static_nullspace_settings.get_child("precond.coarsening").erase("cache");
+            p_static_settings = &static_nullspace_settings;
+        }
+
+        auto& r_maybe_accepted = mpImpl->mStaticSettingsAccepted[mpImpl->mNullSpaceColumnCount ? 1 : 0];
+        const auto try_construct = [&](auto TypeTag) -> bool {
+            using Bundle = typename decltype(TypeTag)::type;
+            if (!r_maybe_accepted.has_value()) {
+                r_maybe_accepted = Detail::AcceptsSettings<typename Bundle::Traits::Solver>(*p_static_settings);
+            }
+            if (!r_maybe_accepted.value()) return false;
+            mpImpl->mSolverBundle.template emplace<Bundle>(r_system_a, r_system_b, *p_static_settings);
+            return true;
+        };
+
+        #define KRATOS_TRY_CONSTRUCT_STATIC_AMGCL_SOLVER_BUNDLE(BLOCK_SIZE, COARSENING, RELAXATION)                             \
+            if (block_size == BLOCK_SIZE                                                                                        \
+                && r_configuration.mCoarsening == #COARSENING                                                                   \
+                && r_configuration.mRelaxation == #RELAXATION)                                                                  \
+                is_static = try_construct(std::type_identity<typename Impl::template StaticBundle<                              \
+                    BLOCK_SIZE, amgcl::coarsening::COARSENING, amgcl::relaxation::RELAXATION>>())
+
+        KRATOS_TRY_CONSTRUCT_STATIC_AMGCL_SOLVER_BUNDLE(1, aggregation, ilu0);
+        KRATOS_TRY_CONSTRUCT_STATIC_AMGCL_SOLVER_BUNDLE(1, aggregation, spai0);
+        KRATOS_TRY_CONSTRUCT_STATIC_AMGCL_SOLVER_BUNDLE(1, smoothed_aggregation, ilu0);
+        KRATOS_TRY_CONSTRUCT_STATIC_AMGCL_SOLVER_BUNDLE(1, smoothed_aggregation, spai0);
+        KRATOS_TRY_CONSTRUCT_STATIC_AMGCL_SOLVER_BUNDLE(3, aggregation, ilu0);
+        KRATOS_TRY_CONSTRUCT_STATIC_AMGCL_SOLVER_BUNDLE(3, aggregation, spai0);
+        KRATOS_TRY_CONSTRUCT_STATIC_AMGCL_SOLVER_BUNDLE(3, smoothed_aggregation, ilu0);
+        KRATOS_TRY_CONSTRUCT_STATIC_AMGCL_SOLVER_BUNDLE(3, smoothed_aggregation, spai0);
+
+        #undef KRATOS_TRY_CONSTRUCT_STATIC_AMGCL_SOLVER_BUNDLE
+
+        KRATOS_INFO_IF("AMGCLWrapper", 2 <= mpImpl->mVerbosity)
+            << (is_static ? "using" : "settings are incompatible with")
+            << " the compile-time configured solver (" << r_configuration.mCoarsening
+            << ", " << r_configuration.mRelaxation << ", cg)\n";
+    }
+
+    // Runtime configured AMG with cached levels. Other preconditioners are not cached.
+    bool is_cached = use_cache && is_static;
+    if (use_cache && !is_static) {
+        const boost::property_tree::ptree* p_cached_settings = &mpImpl->mMaybeCachedAMGSettings.value();
+        boost::property_tree::ptree cached_nullspace_settings;
+        if (mpImpl->mNullSpaceColumnCount) {
+            cached_nullspace_settings = *p_cached_settings;
+            cached_nullspace_settings.put_child("precond.coarsening.nullspace", p_settings->get_child("precond.coarsening.nullspace"));
+            cached_nullspace_settings.put("precond.coarsening.aggr.block_size", mpImpl->mMaybeDoFCount.value());
+            p_cached_settings = &cached_nullspace_settings;
+        }
+
+        const auto construct_cached = [&](auto BlockSize) {
+            using Bundle = typename Impl::template CachedBundle<decltype(BlockSize)::value>;
+            mpImpl->mSolverBundle.template emplace<Bundle>(r_system_a, r_system_b, *p_cached_settings);
+        };
+
+        switch (block_size) {
+            case 1: construct_cached(std::integral_constant<unsigned,1>()); break;
+            case 2: construct_cached(std::integral_constant<unsigned,2>()); break;
+            case 3: construct_cached(std::integral_constant<unsigned,3>()); break;
+            case 4: construct_cached(std::integral_constant<unsigned,4>()); break;
+            case 5: construct_cached(std::integral_constant<unsigned,5>()); break;
+            case 6: construct_cached(std::integral_constant<unsigned,6>()); break;
+            default: KRATOS_ERROR << "unsupported block size: " << block_size << "\n";
+        } // switch block_size
+        is_cached = true;
+    }
 
     // Construct the solver
-    switch (mpImpl->mBackendType) {
+    if (!is_static && !is_cached) switch (mpImpl->mBackendType) {
         #ifdef AMGCL_GPGPU
             case AMGCLBackendType::GPU: {
-                KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE(amgcl::backend::vexcl, typename Impl::ValueType);
+                KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE(amgcl::backend::vexcl, typename Impl::ValueType, false);
                 KRATOS_INFO_IF("AMGCLWrapper", 2 <= mpImpl->mVerbosity) << GetVexCLContext();
                 break;
             }
         #endif
         case AMGCLBackendType::CPU: {
-            KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE(amgcl::backend::builtin, typename Impl::ValueType);
+            if (mpImpl->mMixedPrecision) {
+                KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE(amgcl::backend::builtin, typename Impl::ValueType, true);
+            } else {
+                KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE(amgcl::backend::builtin, typename Impl::ValueType, false);
+            }
             break;
         } // case AMGCLBackendType::CPU
         default: KRATOS_ERROR << "unhandled AMGCL backend enum: " << (int)mpImpl->mBackendType << "\n";
@@ -638,6 +3226,24 @@ void AMGCLWrapper<TSparseSpace,TDenseSpace,TReorderer>::InitializeSolutionStep(S
 
     #undef KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE
     #undef KRATOS_CONSTRUCT_AMGCL_SOLVER_BUNDLE_WITH_BLOCK_SIZE
+
+    mpImpl->mSetupTime = setup_timer.ElapsedSeconds();
+    mpImpl->mSolveCountSinceSetup = 0;
+    KRATOS_INFO_IF("AMGCLWrapper", 2 <= mpImpl->mVerbosity)
+        << "hierarchy setup took " << mpImpl->mSetupTime << " [s]\n";
+
+    if (mpImpl->mStatisticsHistory) {
+        mpImpl->mHierarchyStatistics = std::visit(
+            [](const auto& rBundle) -> Detail::HierarchyStatistics {
+                using BundleType = std::remove_cv_t<std::remove_reference_t<decltype(rBundle)>>;
+                if constexpr (!std::is_same_v<BundleType,std::monostate>) {
+                    return rBundle.mHierarchyStatistics;
+                } else {
+                    return {};
+                }
+            },
+            mpImpl->mSolverBundle);
+    }
     KRATOS_CATCH("")
 }
 
@@ -654,24 +3260,75 @@ void AMGCLWrapper<TSparseSpace,TDenseSpace,TReorderer>::ProvideAdditionalData(Sp
     KRATOS_TRY
     if (!mpImpl->mMaybeDoFCount.has_value())
         mpImpl->mMaybeDoFCount = FindBlockSize<TSparseSpace>(rModelPart, rDofs);
+
+    mpImpl->mpDofs = &rDofs;
+    mpImpl->mpModelPart = &rModelPart;
+
+    if (!mpImpl->mpDataCommunicator && rModelPart.IsDistributed())
+        mpImpl->mpDataCommunicator = &rModelPart.GetCommunicator().GetDataCommunicator();
+
+    // The local system spans owned and ghost DoFs, but AMGCL expects the owned rows of the global system.
+    #ifdef KRATOS_USING_MPI
+    if (mpImpl->IsDistributed()) {
+        mpImpl->mpPartition = std::make_unique<Detail::DistributedPartition<TSparseSpace>>(rDofs, rA.size1(), *mpImpl->mpDataCommunicator);
+    }
+    #endif
+
+    if (mpImpl->mUseRigidBodyModes && !mpImpl->IsDistributed()) {
+        mpImpl->mNullSpaceColumnCount = MakeRigidBodyModes(rModelPart, rDofs, rA.size1(), mpImpl->mNullSpace);
+        KRATOS_WARNING_IF("AMGCLWrapper", !mpImpl->mNullSpaceColumnCount && 1 <= mpImpl->mVerbosity)
+            << "no rigid body modes are constructed because the system has no displacement DoFs\n";
+        KRATOS_INFO_IF("AMGCLWrapper", mpImpl->mNullSpaceColumnCount && 2 <= mpImpl->mVerbosity)
+            << "constructed " << mpImpl->mNullSpaceColumnCount << " rigid body modes\n";
+    }
     KRATOS_CATCH("")
 }
 
 
 
+template<class TSparseSpace,
+         class TDenseSpace,
+         class TReorderer>
+std::vector<AMGCLSolveStatistics>
+AMGCLWrapper<TSparseSpace,TDenseSpace,TReorderer>::GetStatistics() const
+{
+    return std::vector<AMGCLSolveStatistics>(mpImpl->mStatistics.begin(), mpImpl->mStatistics.end());
+}
+
+
+
 template<class TSparseSpace,
          class TDenseSpace,
          class TReorderer>
 Parameters
 AMGCLWrapper<TSparseSpace,TDenseSpace,TReorderer>::GetDefaultParameters()
 {
-    return Parameters(R"(
+    // Parsed once, since solvers may be constructed on hot paths (e.g. for each level of a p-multigrid).
+    static const Parameters default_parameters(R"(
 {
     "solver_type" : "amgcl_wrapper",
     "verbosity" : 0,
     "tolerance" : 1e-6,
     "backend" : "cpu",
+    "precision" : "full",
     "block_size" : "auto",
+    "use_rigid_body_modes" : false,
+    "static_dispatch" : true,
+    "first_touch" : false,
+    "reordering" : "none",
+    "data_communicator" : "",
+    "initial_guess" : "provided",
+    "statistics_history" : 16,
+    "rhs_lanes" : 1,
+    "fallbacks" : [],
+    "hierarchy_reuse" : {
+        "policy" : "rebuild",
+        "rebuild_interval" : 0,
+        "max_iteration_growth" : 0.5
+    },
+    "hierarchy_cache" : {
+        "directory" : ""
+    },
     "amgcl_settings" : {
         "precond" : {
             "class" : "amg",
@@ -697,6 +3354,7 @@ AMGCLWrapper<TSparseSpace,TDenseSpace,TReorderer>::GetDefaultParameters()
     }
 }
     )");
+    return default_parameters.Clone();
 }
 
 
@@ -707,7 +3365,163 @@ bool AMGCLWrapper<TSparseSpace,TDenseSpace,TReorderer>::Solve(SparseMatrix& rA,
                                                               DenseMatrix& rX,
                                                               DenseMatrix& rB)
 {
-    return false;
+    std::vector<std::size_t> iteration_counts;
+    std::vector<double> residuals;
+    return this->Solve(rA, rX, rB, iteration_counts, residuals);
+}
+
+
+template<class TSparseSpace,
+         class TDenseSpace,
+         class TReorderer>
+bool AMGCLWrapper<TSparseSpace,TDenseSpace,TReorderer>::Solve(SparseMatrix& rA,
+                                                              DenseMatrix& rX,
+                                                              DenseMatrix& rB,
+                                                              std::vector<std::size_t>& rIterationCounts,
+                                                              std::vector<double>& rResiduals)
+{
+    KRATOS_TRY
+    KRATOS_PROFILE_SCOPE(KRATOS_CODE_LOCATION);
+
+    const std::size_t system_size = rA.size1();
+    const std::size_t column_count = rB.size2();
+
+    KRATOS_ERROR_IF_NOT(rB.size1() == system_size)
+        << "right hand side has " << rB.size1() << " rows but the system matrix has " << system_size << "\n";
+
+    // Columns of the solution matrix are used as initial guesses if it has
+    // the right shape, otherwise the solver starts from zero.
+    if (rX.size1() != system_size || rX.size2() != column_count) {
+        rX.resize(system_size, column_count, false);
+        TDenseSpace::SetToZero(rX);
+    }
+
+    rIterationCounts.assign(column_count, 0);
+    rResiduals.assign(column_count, 0.0);
+    if (!column_count) return true;
+
+    Vector x(system_size), b(system_size);
+    const auto load_column = [&x, &b, &rX, &rB](std::size_t i_column) {
+        IndexPartition<std::size_t>(x.size()).for_each([&, i_column](std::size_t i_row) {
+            x[i_row] = rX(i_row, i_column);
+            b[i_row] = rB(i_row, i_column);
+        });
+    };
+
+    load_column(0);
+    this->InitializeSolutionStep(rA, x, b);
+
+    // Columns are independent systems, so warm starts from previous solutions are disabled
+    // until all columns are solved (or one of them throws). Zero initial guesses are kept.
+    struct InitialGuessRestorer
+    {
+        ~InitialGuessRestorer() {mrInitialGuess = mInitialGuess;}
+
+        AMGCLInitialGuess& mrInitialGuess;
+
+        AMGCLInitialGuess mInitialGuess;
+    } initial_guess_restorer {
+        mpImpl->mInitialGuess,
+        std::exchange(mpImpl->mInitialGuess,
+                      mpImpl->mInitialGuess == AMGCLInitialGuess::Zero ? AMGCLInitialGuess::Zero : AMGCLInitialGuess::Provided)
+    };
+
+    bool converged = true;
+    std::vector<char> is_done(column_count, false);
+
+    // AMGCL's solvers keep their work vectors in the solver instance, so columns are solved
+    // concurrently on separate lanes, each with its own copy of the solver constructed from
+    // the same system and settings. The first lane uses the shared hierarchy itself. AMGCL's
+    // parallel loops nested in a lane run on the lane's thread. Columns that fail to converge
+    // are solved again below if there are fallbacks to try.
+    const std::size_t lane_count = std::min(mpImpl->mRHSLanes, column_count);
+    if (1 < lane_count && !mpImpl->IsDistributed() && mpImpl->mBackendType == AMGCLBackendType::CPU) {
+        const bool is_reordered = mpImpl->mReordering != AMGCLReordering::None;
+        const bool is_zero_initial_guess = mpImpl->mInitialGuess == AMGCLInitialGuess::Zero;
+        const SparseMatrix& r_system_a = is_reordered ? mpImpl->mPermutation.mMatrix : rA;
+        const Vector& r_system_b = is_reordered ? mpImpl->mPermutedB : b;
+        std::vector<double> solve_times(column_count, 0.0);
+        std::vector<char> is_converged(column_count, false);
+
+        std::visit(
+            [&](auto& rBundle) {
+                using BundleType = std::remove_reference_t<decltype(rBundle)>;
+                if constexpr (!std::is_same_v<BundleType,std::monostate>) {
+                    BuiltinTimer copy_timer;
+                    std::vector<std::unique_ptr<BundleType>> copies;
+                    for (std::size_t i_lane=1; i_lane<lane_count; ++i_lane) {
+                        copies.push_back(std::make_unique<BundleType>(r_system_a, r_system_b, rBundle.mSettings));
+                    }
+                    KRATOS_INFO_IF("AMGCLWrapper", 2 <= mpImpl->mVerbosity)
+                        << "constructing " << copies.size() << " solver copies took " << copy_timer.ElapsedSeconds() << " [s]\n";
+
+                    IndexPartition<std::size_t>(lane_count).for_each([&](std::size_t i_lane) {
+                        BundleType& r_bundle = i_lane ? *copies[i_lane - 1] : rBundle;
+                        Vector lane_x(system_size), lane_b(system_size), permuted_x, permuted_b;
+                        Vector& r_lane_x = is_reordered ? permuted_x : lane_x;
+                        Vector& r_lane_b = is_reordered ? permuted_b : lane_b;
+
+                        for (std::size_t i_column=i_lane; i_column<column_count; i_column+=lane_count) {
+                            for (std::size_t i_row=0; i_row<system_size; ++i_row) {
+                                lane_x[i_row] = is_zero_initial_guess ? 0 : rX(i_row, i_column);
+                                lane_b[i_row] = rB(i_row, i_column);
+                            }
+                            if (is_reordered) {
+                                mpImpl->mPermutation.Permute(lane_x, permuted_x);
+                                mpImpl->mPermutation.Permute(lane_b, permuted_b);
+                            }
+
+                            BuiltinTimer solve_timer;
+                            const auto [iteration_count, residual] = Detail::SolveWithBundle(r_bundle, r_lane_x, r_lane_b);
+                            solve_times[i_column] = solve_timer.ElapsedSeconds();
+
+                            if (is_reordered) mpImpl->mPermutation.InversePermute(permuted_x, lane_x);
+                            for (std::size_t i_row=0; i_row<system_size; ++i_row) rX(i_row, i_column) = lane_x[i_row];
+                            rIterationCounts[i_column] = iteration_count;
+                            rResiduals[i_column] = residual;
+                            is_converged[i_column] = residual < mpImpl->mTolerance;
+                        }
+                    });
+                }
+            },
+            mpImpl->mSolverBundle);
+
+        const bool has_fallbacks = !mpImpl->mFallbackSettings.empty();
+        for (std::size_t i_column=0; i_column<column_count; ++i_column) {
+            if (!is_converged[i_column] && has_fallbacks) continue;
+            KRATOS_WARNING_IF("AMGCLWrapper", 1 <= mpImpl->mVerbosity && !is_converged[i_column])
+                << "Failed to converge. Residual: " << rResiduals[i_column] << "\n";
+            mpImpl->RecordSolve(rIterationCounts[i_column], rResiduals[i_column], solve_times[i_column], 0, 0.0);
+            converged = is_converged[i_column] && converged;
+            is_done[i_column] = true;
+        }
+    }
+
+    // Remaining columns are solved one after the other on the shared hierarchy,
+    // each solve being parallel internally.
+    for (std::size_t i_column=0; i_column<column_count; ++i_column) {
+        if (is_done[i_column]) continue;
+        load_column(i_column);
+        converged = this->PerformSolutionStep(rA, x, b) && converged;
+        rIterationCounts[i_column] = mpImpl->mLastIterationCount;
+        rResiduals[i_column] = mpImpl->mLastResidual;
+        IndexPartition<std::size_t>(x.size()).for_each([&x, &rX, i_column](std::size_t i_row) {
+            rX(i_row, i_column) = x[i_row];
+        });
+    }
+
+    if (2 <= mpImpl->mVerbosity) {
+        std::stringstream report;
+        report << "solved " << column_count << " right hand sides\n"
+               << "column\titerations\tresidual\n";
+        for (std::size_t i_column=0; i_column<column_count; ++i_column) {
+            report << i_column << "\t" << rIterationCounts[i_column] << "\t" << rResiduals[i_column] << "\n";
+        }
+        KRATOS_INFO("AMGCLWrapper") << report.str();
+    }
+
+    return converged;
+    KRATOS_CATCH("")
 }
 
 
@@ -729,6 +3543,14 @@ void AMGCLWrapper<TSparseSpace,TDenseSpace,TReorderer>::PrintData(std::ostream&
         << "tolerance     : " << mpImpl->mTolerance << "\n"
         << "DoF size      : " << (mpImpl->mMaybeDoFCount.has_value() ? std::to_string(mpImpl->mMaybeDoFCount.value()) : "auto") << "\n"
         << "verbosity     : " << mpImpl->mVerbosity << "\n"
+        << "precision     : " << (mpImpl->mMixedPrecision ? "mixed" : "full") << "\n"
+        << "initial guess : " << std::array<const char*,4> {"provided", "zero", "previous", "extrapolated"}[static_cast<int>(mpImpl->mInitialGuess)] << "\n"
+        << "static solver : " << (mpImpl->mStaticDispatch ? "if available" : "off") << "\n"
+        << "distributed   : " << (mpImpl->IsDistributed() ? "yes" : "no") << "\n"
+        << "reordering    : " << (mpImpl->mReordering == AMGCLReordering::RCM ? "rcm" : "none") << "\n"
+        << "rigid modes   : " << (mpImpl->mUseRigidBodyModes ? std::to_string(mpImpl->mNullSpaceColumnCount) : "off") << "\n"
+        << "reuse policy  : " << mpImpl->mReusePolicy << "\n"
+        << "rhs lanes     : " << mpImpl->mRHSLanes << "\n"
         << "AMGCL settings: "
         ;
     boost::property_tree::json_parser::write_json(rStream, mpImpl->mAMGCLSettings);
@@ -0,0 +1,452 @@
+/// @author Máté Kelemen
+
+// --- Core Includes ---
+#include "containers/model.h"
+#include "includes/model_part.h"
+#include "includes/kratos_components.h"
+#include "input_output/logger.h"
+#include "utilities/parallel_utilities.h"
+
+// --- Utility Includes ---
+#include "UtilityApp/ModelPartIO.hpp"
+#include "EntityConstruction.hpp"
+
+// --- STL Includes ---
+#include <array> // array
+#include <vector> // vector
+#include <deque> // deque
+#include <string> // string
+#include <algorithm> // sort, is_sorted
+#include <cstddef> // ptrdiff_t
+#include <type_traits> // is_same_v
+#include <thread> // thread
+#include <mutex> // mutex, unique_lock
+#include <condition_variable> // condition_variable
+#include <exception> // exception_ptr, current_exception, rethrow_exception
+
+
+namespace Kratos::UtilityApp {
+
+
+namespace {
+
+
+// Geometries, elements or conditions of the same registered type.
+template <class TEntity>
+struct EntityGroup
+{
+    const TEntity* mpPrototype = nullptr;
+
+    std::size_t mNodesPerEntity = 0;
+
+    std::vector<ModelPart::IndexType> mIds;
+
+    std::vector<ModelPart::IndexType> mPropertyIds;
+
+    // Node indices in the snapshot, mNodesPerEntity per entity.
+    std::vector<std::size_t> mConnectivity;
+}; // struct EntityGroup
+
+
+struct SubModelPartSnapshot
+{
+    std::string mName;
+
+    // Index of the parent sub model part (-1 => the root).
+    std::ptrdiff_t mParentIndex = -1;
+
+    std::vector<ModelPart::IndexType> mNodeIds;
+
+    std::vector<ModelPart::IndexType> mPropertyIds;
+
+    std::vector<ModelPart::IndexType> mGeometryIds;
+
+    std::vector<ModelPart::IndexType> mElementIds;
+
+    std::vector<ModelPart::IndexType> mConditionIds;
+}; // struct SubModelPartSnapshot
+
+
+// Everything the worker needs to rebuild a model part, without referring to the source.
+struct Snapshot
+{
+    std::string mName;
+
+    std::size_t mBufferSize = 1;
+
+    ProcessInfo::Pointer mpProcessInfo;
+
+    // Sorted by ID.
+    std::vector<ModelPart::IndexType> mNodeIds;
+
+    std::vector<std::array<double,3>> mInitialCoordinates;
+
+    std::vector<std::array<double,3>> mCoordinates;
+
+    std::vector<Properties::Pointer> mProperties;
+
+    std::vector<EntityGroup<ModelPart::GeometryType>> mGeometries;
+
+    std::vector<EntityGroup<Element>> mElements;
+
+    std::vector<EntityGroup<Condition>> mConditions;
+
+    // Parents before their children.
+    std::vector<SubModelPartSnapshot> mSubModelParts;
+}; // struct Snapshot
+
+
+template <class TEntity, class TRange>
+std::vector<EntityGroup<TEntity>> MakeEntityGroups(TRange&& rEntities, const std::vector<ModelPart::IndexType>& rNodeIds)
+{
+    constexpr bool has_properties = !std::is_same_v<TEntity,ModelPart::GeometryType>;
+
+    std::vector<const TEntity*> entities;
+    for (const auto& r_entity : rEntities) entities.push_back(&r_entity);
+
+    // Group entities by their registered prototypes.
+    const Detail::EntityGrouping grouping = Detail::GroupByRegisteredName(rEntities);
+    std::vector<EntityGroup<TEntity>> groups(grouping.mGroups.size());
+    for (std::size_t i_group=0; i_group<groups.size(); ++i_group) {
+        const auto& r_grouped = grouping.mGroups[i_group];
+        auto& r_group = groups[i_group];
+        r_group.mpPrototype = &KratosComponents<TEntity>::Get(r_grouped.mName);
+        r_group.mNodesPerEntity = r_grouped.mNodesPerEntity;
+        r_group.mIds.resize(r_grouped.mSize);
+        if (has_properties) r_group.mPropertyIds.resize(r_grouped.mSize);
+        r_group.mConnectivity.resize(r_grouped.mSize * r_grouped.mNodesPerEntity);
+    }
+
+    IndexPartition<std::size_t>(entities.size()).for_each([&](std::size_t i_entity) {
+        const TEntity& r_entity = *entities[i_entity];
+        const auto [i_group, i_position] = grouping.mPositions[i_entity];
+        auto& r_group = groups[i_group];
+
+        r_group.mIds[i_position] = r_entity.Id();
+        if constexpr (has_properties) {
+            r_group.mPropertyIds[i_position] = r_entity.pGetProperties() ? r_entity.GetProperties().Id() : Detail::NoProperties;
+        }
+
+        const auto& r_geometry = Detail::GetGeometryOf(r_entity);
+        KRATOS_ERROR_IF_NOT(r_geometry.size() == r_group.mNodesPerEntity)
+            << "entity " << r_entity.Id() << " has " << r_geometry.size()
+            << " nodes instead of " << r_group.mNodesPerEntity << "\n";
+        for (std::size_t i_node=0; i_node<r_geometry.size(); ++i_node) {
+            r_group.mConnectivity[i_position * r_group.mNodesPerEntity + i_node] = Detail::FindNodeIndex(rNodeIds, r_geometry[i_node].Id());
+        }
+    });
+
+    return groups;
+}
+
+
+std::unique_ptr<Snapshot> MakeSnapshot(const ModelPart& rSource)
+{
+    auto p_snapshot = std::make_unique<Snapshot>();
+    Snapshot& r_snapshot = *p_snapshot;
+    r_snapshot.mName = rSource.Name();
+    r_snapshot.mBufferSize = rSource.GetBufferSize();
+    r_snapshot.mpProcessInfo = Kratos::make_shared<ProcessInfo>(rSource.GetProcessInfo());
+
+    // Nodes, sorted by ID
+    std::vector<const ModelPart::NodeType*> nodes;
+    nodes.reserve(rSource.NumberOfNodes());
+    for (const auto& r_node : rSource.Nodes()) nodes.push_back(&r_node);
+    const auto compare_ids = [](const auto* pLeft, const auto* pRight) {return pLeft->Id() < pRight->Id();};
+    if (!std::is_sorted(nodes.begin(), nodes.end(), compare_ids)) std::sort(nodes.begin(), nodes.end(), compare_ids);
+
+    r_snapshot.mNodeIds.resize(nodes.size());
+    r_snapshot.mInitialCoordinates.resize(nodes.size());
+    r_snapshot.mCoordinates.resize(nodes.size());
+    IndexPartition<std::size_t>(nodes.size()).for_each([&](std::size_t i_node) {
+        const ModelPart::NodeType& r_node = *nodes[i_node];
+        r_snapshot.mNodeIds[i_node] = r_node.Id();
+        r_snapshot.mInitialCoordinates[i_node] = {r_node.X0(), r_node.Y0(), r_node.Z0()};
+        r_snapshot.mCoordinates[i_node] = {r_node.X(), r_node.Y(), r_node.Z()};
+    });
+
+    // Properties are copied, since the source may change them while the worker is writing.
+    for (auto it_properties=rSource.PropertiesBegin(); it_properties!=rSource.PropertiesEnd(); ++it_properties) {
+        r_snapshot.mProperties.push_back(Kratos::make_shared<Properties>(*it_properties));
+    }
+
+    r_snapshot.mGeometries = MakeEntityGroups<ModelPart::GeometryType>(rSource.Geometries(), r_snapshot.mNodeIds);
+    r_snapshot.mElements = MakeEntityGroups<Element>(rSource.Elements(), r_snapshot.mNodeIds);
+    r_snapshot.mConditions = MakeEntityGroups<Condition>(rSource.Conditions(), r_snapshot.mNodeIds);
+
+    // Sub model parts, parents before their children.
+    std::vector<const ModelPart*> sub_model_parts;
+    for (const auto& r_sub_model_part : rSource.SubModelParts()) {
+        sub_model_parts.push_back(&r_sub_model_part);
+        r_snapshot.mSubModelParts.emplace_back().mParentIndex = -1;
+    }
+    for (std::size_t i_sub_model_part=0; i_sub_model_part<sub_model_parts.size(); ++i_sub_model_part) {
+        const ModelPart& r_sub_model_part = *sub_model_parts[i_sub_model_part];
+        for (const auto& r_child : r_sub_model_part.SubModelParts()) {
+            sub_model_parts.push_back(&r_child);
+            r_snapshot.mSubModelParts.emplace_back().mParentIndex = static_cast<std::ptrdiff_t>(i_sub_model_part);
+        }
+
+        SubModelPartSnapshot& r_sub_snapshot = r_snapshot.mSubModelParts[i_sub_model_part];
+        r_sub_snapshot.mName = r_sub_model_part.Name();
+        for (const auto& r_node : r_sub_model_part.Nodes()) r_sub_snapshot.mNodeIds.push_back(r_node.Id());
+        for (auto it_properties=r_sub_model_part.PropertiesBegin(); it_properties!=r_sub_model_part.PropertiesEnd(); ++it_properties) {
+            r_sub_snapshot.mPropertyIds.push_back(it_properties->Id());
+        }
+        for (const auto& r_geometry : r_sub_model_part.Geometries()) r_sub_snapshot.mGeometryIds.push_back(r_geometry.Id());
+        for (const auto& r_element : r_sub_model_part.Elements()) r_sub_snapshot.mElementIds.push_back(r_element.Id());
+        for (const auto& r_condition : r_sub_model_part.Conditions()) r_sub_snapshot.mConditionIds.push_back(r_condition.Id());
+    }
+
+    return p_snapshot;
+}
+
+
+template <class TEntity>
+std::vector<typename TEntity::Pointer> RestoreEntities(const std::vector<EntityGroup<TEntity>>& rGroups,
+                                                       const std::vector<ModelPart::NodeType::Pointer>& rNodes,
+                                                       ModelPart& rTarget)
+{
+    std::vector<typename TEntity::Pointer> output;
+
+    for (const auto& r_group : rGroups) {
+        const std::size_t offset = output.size();
+        output.resize(offset + r_group.mIds.size());
+        Detail::MakeEntities(*r_group.mpPrototype,
+                             r_group.mIds.size(),
+                             r_group.mNodesPerEntity,
+                             [&r_group](std::size_t i_entity) {return r_group.mIds[i_entity];},
+                             [&r_group](std::size_t i_entity) {return r_group.mPropertyIds[i_entity];},
+                             [&r_group, &rNodes](std::size_t i_entity, std::size_t i_node) {
+                                 return rNodes[r_group.mConnectivity[i_entity * r_group.mNodesPerEntity + i_node]];
+                             },
+                             rTarget,
+                             output.data() + offset);
+    }
+
+    return output;
+}
+
+
+void RestoreSnapshot(const Snapshot& rSnapshot, ModelPart& rTarget)
+{
+    rTarget.SetBufferSize(rSnapshot.mBufferSize);
+    rTarget.SetProcessInfo(rSnapshot.mpProcessInfo);
+
+    // Nodes
+    std::vector<ModelPart::NodeType::Pointer> nodes(rSnapshot.mNodeIds.size());
+    const auto p_variables = rTarget.pGetNodalSolutionStepVariablesList();
+    const auto buffer_size = rTarget.GetBufferSize();
+    IndexPartition<std::size_t>(nodes.size()).for_each([&](std::size_t i_node) {
+        nodes[i_node] = Detail::MakeNode(rSnapshot.mNodeIds[i_node],
+                                         rSnapshot.mInitialCoordinates[i_node],
+                                         rSnapshot.mCoordinates[i_node],
+                                         p_variables,
+                                         buffer_size);
+    });
+
+    {
+        ModelPart::NodesContainerType container;
+        container.reserve(nodes.size());
+        for (const auto& rp_node : nodes) container.push_back(rp_node);
+        rTarget.AddNodes(container.begin(), container.end());
+    }
+
+    // Properties
+    for (const auto& rp_properties : rSnapshot.mProperties) rTarget.AddProperties(rp_properties);
+
+    // Geometries, elements and conditions
+    for (const auto& rp_geometry : RestoreEntities(rSnapshot.mGeometries, nodes, rTarget)) rTarget.AddGeometry(rp_geometry);
+
+    {
+        const auto elements = RestoreEntities(rSnapshot.mElements, nodes, rTarget);
+        ModelPart::ElementsContainerType container;
+        container.reserve(elements.size());
+        for (const auto& rp_element : elements) container.push_back(rp_element);
+        rTarget.AddElements(container.begin(), container.end());
+    }
+
+    {
+        const auto conditions = RestoreEntities(rSnapshot.mConditions, nodes, rTarget);
+        ModelPart::ConditionsContainerType container;
+        container.reserve(conditions.size());
+        for (const auto& rp_condition : conditions) container.push_back(rp_condition);
+        rTarget.AddConditions(container.begin(), container.end());
+    }
+
+    // Sub model parts
+    std::vector<ModelPart*> sub_model_parts;
+    for (const auto& r_sub_snapshot : rSnapshot.mSubModelParts) {
+        ModelPart& r_parent = r_sub_snapshot.mParentIndex < 0 ? rTarget : *sub_model_parts[r_sub_snapshot.mParentIndex];
+        ModelPart& r_sub_model_part = r_parent.CreateSubModelPart(r_sub_snapshot.mName);
+        sub_model_parts.push_back(&r_sub_model_part);
+
+        r_sub_model_part.AddNodes(r_sub_snapshot.mNodeIds);
+        for (const auto property_id : r_sub_snapshot.mPropertyIds) {
+            r_sub_model_part.AddProperties(rTarget.pGetProperties(property_id));
+        }
+        r_sub_model_part.AddGeometries(r_sub_snapshot.mGeometryIds);
+        r_sub_model_part.AddElements(r_sub_snapshot.mElementIds);
+        r_sub_model_part.AddConditions(r_sub_snapshot.mConditionIds);
+    }
+}
+
+
+} // unnamed namespace
+
+
+struct AsyncModelPartIO::Impl {
+    Impl(std::unique_ptr<ModelPartIO>&& pWrapped, std::size_t QueueSize)
+        : mpWrapped(std::move(pWrapped)),
+          mQueueSize(QueueSize)
+    {
+        KRATOS_ERROR_IF_NOT(mpWrapped) << "AsyncModelPartIO requires an IO to write with\n";
+        KRATOS_ERROR_IF_NOT(mQueueSize) << "the queue of AsyncModelPartIO must hold at least one snapshot\n";
+        mWorker = std::thread([this]() {this->Work();});
+    }
+
+    ~Impl()
+    {
+        {
+            std::scoped_lock lock(mMutex);
+            mStop = true;
+        }
+        mCondition.notify_all();
+        mWorker.join(); // the worker drains the queue before it stops
+
+        if (mpError) {
+            try {
+                std::rethrow_exception(mpError);
+            } catch (std::exception& rException) {
+                KRATOS_WARNING("AsyncModelPartIO") << "writing failed: " << rException.what() << "\n";
+            } catch (...) {
+                KRATOS_WARNING("AsyncModelPartIO") << "writing failed\n";
+            }
+        }
+    }
+
+    void Push(std::unique_ptr<Snapshot>&& pSnapshot)
+    {
+        {
+            std::unique_lock lock(mMutex);
+            mCondition.wait(lock, [this]() {return mQueue.size() < mQueueSize;});
+            mQueue.push_back(std::move(pSnapshot));
+        }
+        mCondition.notify_all();
+    }
+
+    void Flush()
+    {
+        std::unique_lock lock(mMutex);
+        mCondition.wait(lock, [this]() {return mQueue.empty() && !mBusy;});
+        this->RethrowError(lock);
+    }
+
+    // Rethrow and forget the first error of the worker, if there was one.
+    void RethrowError(std::unique_lock<std::mutex>&)
+    {
+        if (mpError) {
+            std::exception_ptr p_error;
+            std::swap(p_error, mpError);
+            std::rethrow_exception(p_error);
+        }
+    }
+
+    void Work()
+    {
+        while (true) {
+            std::unique_ptr<Snapshot> p_snapshot;
+            {
+                std::unique_lock lock(mMutex);
+                mCondition.wait(lock, [this]() {return mStop || !mQueue.empty();});
+                if (mQueue.empty()) return;
+                p_snapshot = std::move(mQueue.front());
+                mQueue.pop_front();
+                mBusy = true;
+            }
+            mCondition.notify_all(); // there's space in the queue
+
+            try {
+                Model model;
+                ModelPart& r_model_part = model.CreateModelPart(p_snapshot->mName);
+                RestoreSnapshot(*p_snapshot, r_model_part);
+                p_snapshot.reset(); // release the staging buffer before writing
+                mpWrapped->Write(r_model_part);
+            } catch (...) {
+                std::scoped_lock lock(mMutex);
+                if (!mpError) mpError = std::current_exception();
+            }
+
+            {
+                std::scoped_lock lock(mMutex);
+                mBusy = false;
+            }
+            mCondition.notify_all();
+        }
+    }
+
+    std::unique_ptr<ModelPartIO> mpWrapped;
+
+    std::size_t mQueueSize;
+
+    std::deque<std::unique_ptr<Snapshot>> mQueue;
+
+    // True while the worker is writing a snapshot it already took from the queue.
+    bool mBusy = false;
+
+    bool mStop = false;
+
+    std::exception_ptr mpError;
+
+    std::mutex mMutex;
+
+    std::condition_variable mCondition;
+
+    std::thread mWorker;
+}; // struct AsyncModelPartIO::Impl
+
+
+AsyncModelPartIO::AsyncModelPartIO(std::unique_ptr<ModelPartIO>&& pWrapped, std::size_t QueueSize)
+    : mpImpl(new Impl(std::move(pWrapped), QueueSize))
+{
+}
+
+
+AsyncModelPartIO::~AsyncModelPartIO()
+{
+}
+
+
+void AsyncModelPartIO::Read(Ref<ModelPart> rTarget) const
+{
+    KRATOS_TRY
+    mpImpl->Flush();
+    mpImpl->mpWrapped->Read(rTarget);
+    KRATOS_CATCH("")
+}
+
+
+void AsyncModelPartIO::Write(Ref<const ModelPart> rSource)
+{
+    KRATOS_TRY
+    // Snapshots are rebuilt with the serial communicator and would write ghost nodes as owned ones.
+    KRATOS_ERROR_IF(rSource.IsDistributed())
+        << "AsyncModelPartIO does not support distributed model parts (writing " << rSource.FullName() << ")\n";
+    {
+        std::unique_lock lock(mpImpl->mMutex);
+        mpImpl->RethrowError(lock);
+    }
+    mpImpl->Push(MakeSnapshot(rSource));
+    KRATOS_CATCH("")
+}
+
+
+void AsyncModelPartIO::Flush()
+{
+    KRATOS_TRY
+    mpImpl->Flush();
+    KRATOS_CATCH("")
+}
+
+
+} // namespace Kratos::UtilityApp
@@ -0,0 +1,598 @@
+/// @author Máté Kelemen
+
+// --- Core Includes ---
+#include "includes/model_part.h"
+#include "includes/kratos_components.h"
+#include "utilities/parallel_utilities.h"
+
+// --- Utility Includes ---
+#include "UtilityApp/ModelPartIO.hpp"
+#include "UtilityApp/MappedFile.hpp"
+#include "EntityConstruction.hpp"
+
+// --- STL Includes ---
+#include <filesystem> // path
+#include <fstream> // ofstream
+#include <array> // array
+#include <vector> // vector
+#include <string> // string
+#include <algorithm> // lower_bound, sort, is_sorted
+#include <cstdint> // uint64_t, int64_t
+#include <limits> // numeric_limits
+#include <type_traits> // is_same_v
+
+
+namespace Kratos::UtilityApp {
+
+
+namespace {
+
+
+// On-disk layout of a binary model part (native byte order):
+// @code
+// BinaryHeader
+// node IDs                  [node count] (ascending)
+// node X, Y, Z              [node count] each (current coordinates)
+// node X0, Y0, Z0           [node count] each (initial coordinates)
+// property IDs              [property count]
+// for geometries, elements and conditions, for each of their groups:
+//     BinaryGroupHeader
+//     name                  [name size]
+//     entity IDs            [entity count]
+//     property IDs          [entity count] (elements and conditions only)
+//     connectivity          [entity count * nodes per entity] (node indices)
+// for each sub model part (parents before their children):
+//     BinarySubModelPartHeader
+//     name                  [name size]
+//     node indices          [node count]
+//     geometry, element and condition indices
+//     property IDs
+// @endcode
+// Each entry is padded to BinaryAlignment bytes so that the arrays can be used in place
+// from a memory mapping. Entity indices refer to positions in the concatenation of the
+// groups of the same kind. Bump BinaryVersion whenever the layout changes.
+constexpr std::uint32_t BinaryVersion = 2;
+
+constexpr std::size_t BinaryAlignment = 64;
+
+// Distinguishes files written on machines with a different byte order.
+constexpr std::uint32_t BinaryByteOrderMark = 0x01020304;
+
+// Geometries, elements and conditions.
+constexpr std::size_t EntityKindCount = 3;
+
+
+struct BinaryHeader
+{
+    std::array<char,8> mMagic {'K', 'R', 'A', 'T', 'M', 'D', 'P', 'B'};
+
+    std::uint32_t mVersion = BinaryVersion;
+
+    std::uint32_t mByteOrderMark = BinaryByteOrderMark;
+
+    std::uint64_t mFileSize = 0;
+
+    std::uint64_t mNodeCount = 0;
+
+    std::uint64_t mPropertyCount = 0;
+
+    // Number of groups of geometries, elements and conditions.
+    std::array<std::uint64_t,EntityKindCount> mGroupCounts {0, 0, 0};
+
+    std::uint64_t mSubModelPartCount = 0;
+}; // struct BinaryHeader
+
+
+struct BinaryGroupHeader
+{
+    std::uint64_t mNameSize = 0;
+
+    std::uint64_t mEntityCount = 0;
+
+    std::uint64_t mNodesPerEntity = 0;
+}; // struct BinaryGroupHeader
+
+
+struct BinarySubModelPartHeader
+{
+    std::uint64_t mNameSize = 0;
+
+    // Index of the parent sub model part (-1 => the root).
+    std::int64_t mParentIndex = -1;
+
+    std::uint64_t mNodeCount = 0;
+
+    // Number of geometries, elements and conditions.
+    std::array<std::uint64_t,EntityKindCount> mEntityCounts {0, 0, 0};
+
+    std::uint64_t mPropertyCount = 0;
+}; // struct BinarySubModelPartHeader
+
+
+constexpr std::size_t PadToBinaryAlignment(std::size_t Size) noexcept
+{
+    return (Size + BinaryAlignment - 1) / BinaryAlignment * BinaryAlignment;
+}
+
+
+// Geometries, elements or conditions of a model part grouped by their registered names.
+struct EntityTable
+{
+    struct Group
+    {
+        std::string mName;
+
+        std::size_t mNodesPerEntity = 0;
+
+        std::vector<std::uint64_t> mIds;
+
+        std::vector<std::uint64_t> mPropertyIds;
+
+        std::vector<std::uint64_t> mConnectivity;
+    }; // struct Group
+
+    std::vector<Group> mGroups;
+
+    // (ID, index in the file) pairs sorted by ID, for translating sub model parts' entities.
+    std::vector<std::pair<std::uint64_t,std::uint64_t>> mIndices;
+
+    std::uint64_t FindIndex(std::uint64_t Id) const
+    {
+        const auto it = std::lower_bound(mIndices.begin(),
+                                         mIndices.end(),
+                                         std::make_pair(Id, std::uint64_t(0)));
+        KRATOS_ERROR_IF(it == mIndices.end() || it->first != Id)
+            << "entity " << Id << " of a sub model part is missing from the root model part\n";
+        return it->second;
+    }
+}; // struct EntityTable
+
+
+template <class TEntity, class TRange>
+EntityTable MakeEntityTable(TRange&& rEntities, const std::vector<std::uint64_t>& rNodeIds)
+{
+    constexpr bool has_properties = !std::is_same_v<TEntity,ModelPart::GeometryType>;
+
+    std::vector<const TEntity*> entities;
+    for (const auto& r_entity : rEntities) entities.push_back(&r_entity);
+
+    const Detail::EntityGrouping grouping = Detail::GroupByRegisteredName(rEntities);
+    EntityTable table;
+    table.mGroups.resize(grouping.mGroups.size());
+    std::vector<std::uint64_t> group_offsets(table.mGroups.size(), 0);
+    for (std::size_t i_group=0; i_group<table.mGroups.size(); ++i_group) {
+        const auto& r_grouped = grouping.mGroups[i_group];
+        auto& r_group = table.mGroups[i_group];
+        r_group.mName = r_grouped.mName;
+        r_group.mNodesPerEntity = r_grouped.mNodesPerEntity;
+        r_group.mIds.resize(r_grouped.mSize);
+        if (has_properties) r_group.mPropertyIds.resize(r_grouped.mSize);
+        r_group.mConnectivity.resize(r_grouped.mSize * r_grouped.mNodesPerEntity);
+        if (i_group) group_offsets[i_group] = group_offsets[i_group - 1] + grouping.mGroups[i_group - 1].mSize;
+    }
+    table.mIndices.resize(entities.size());
+
+    IndexPartition<std::size_t>(entities.size()).for_each([&](std::size_t i_entity) {
+        const TEntity& r_entity = *entities[i_entity];
+        const auto [i_group, i_position] = grouping.mPositions[i_entity];
+        auto& r_group = table.mGroups[i_group];
+
+        r_group.mIds[i_position] = r_entity.Id();
+        if constexpr (has_properties) {
+            r_group.mPropertyIds[i_position] = r_entity.pGetProperties() ? r_entity.GetProperties().Id() : Detail::NoProperties;
+        }
+
+        const auto& r_geometry = Detail::GetGeometryOf(r_entity);
+        KRATOS_ERROR_IF_NOT(r_geometry.size() == r_group.mNodesPerEntity)
+            << r_group.mName << " " << r_entity.Id() << " has " << r_geometry.size()
+            << " nodes instead of " << r_group.mNodesPerEntity << "\n";
+        for (std::size_t i_node=0; i_node<r_geometry.size(); ++i_node) {
+            r_group.mConnectivity[i_position * r_group.mNodesPerEntity + i_node] = Detail::FindNodeIndex(rNodeIds, r_geometry[i_node].Id());
+        }
+
+        table.mIndices[i_entity] = {r_entity.Id(), group_offsets[i_group] + i_position};
+    });
+
+    std::sort(table.mIndices.begin(), table.mIndices.end());
+    return table;
+}
+
+
+class BinaryWriter
+{
+public:
+    BinaryWriter(const std::filesystem::path& rPath)
+        : mFile(rPath, std::ios::binary)
+    {
+        KRATOS_ERROR_IF_NOT(mFile) << "cannot open " << rPath << " for writing\n";
+    }
+
+    template <class T>
+    void Write(const T* pBegin, std::size_t Count)
+    {
+        constexpr std::array<char,BinaryAlignment> padding {};
+        const std::size_t size = Count * sizeof(T);
+        mFile.write(reinterpret_cast<const char*>(pBegin), size);
+        mFile.write(padding.data(), PadToBinaryAlignment(size) - size);
+        mSize += PadToBinaryAlignment(size);
+    }
+
+    template <class T>
+    void Write(const std::vector<T>& rArray)
+    {
+        this->Write(rArray.data(), rArray.size());
+    }
+
+    void Write(const std::string& rString)
+    {
+        this->Write(rString.data(), rString.size());
+    }
+
+    // Overwrite the header at the beginning of the file.
+    void WriteHeader(const BinaryHeader& rHeader)
+    {
+        mFile.seekp(0);
+        mFile.write(reinterpret_cast<const char*>(&rHeader), sizeof(BinaryHeader));
+    }
+
+    std::size_t Size() const noexcept {return mSize;}
+
+    void Flush()
+    {
+        KRATOS_ERROR_IF_NOT(mFile.flush()) << "failed to write binary model part\n";
+    }
+
+private:
+    std::ofstream mFile;
+
+    std::size_t mSize = 0;
+}; // class BinaryWriter
+
+
+class BinaryReader
+{
+public:
+    BinaryReader(const std::filesystem::path& rPath)
+        : mpFile(MappedFile::Open(rPath))
+    {
+        KRATOS_ERROR_IF_NOT(mpFile) << "cannot open " << rPath << "\n";
+    }
+
+    // Pointer to Count objects of type T at the current position, in the mapped file.
+    template <class T>
+    const T* Read(std::size_t Count)
+    {
+        // Counts come from the file, so the bounds are checked without computing Count * sizeof(T) first.
+        const std::size_t remaining = mOffset <= mpFile->Size() ? mpFile->Size() - mOffset : 0;
+        KRATOS_ERROR_IF(remaining / sizeof(T) < Count || remaining < PadToBinaryAlignment(Count * sizeof(T)))
+            << "unexpected end of binary model part file\n";
+        const std::size_t size = PadToBinaryAlignment(Count * sizeof(T));
+        const T* p_begin = reinterpret_cast<const T*>(mpFile->Data() + mOffset);
+        mOffset += size;
+        return p_begin;
+    }
+
+    std::string ReadString(std::size_t Size)
+    {
+        const char* p_begin = this->Read<char>(Size);
+        return std::string(p_begin, p_begin + Size);
+    }
+
+    std::size_t Size() const noexcept {return mpFile->Size();}
+
+private:
+    std::shared_ptr<MappedFile> mpFile;
+
+    std::size_t mOffset = 0;
+}; // class BinaryReader
+
+
+template <class TEntity>
+std::vector<typename TEntity::Pointer> ReadEntities(BinaryReader& rReader,
+                                                    std::size_t GroupCount,
+                                                    const std::vector<ModelPart::NodeType::Pointer>& rNodes,
+                                                    ModelPart& rTarget)
+{
+    constexpr bool has_properties = !std::is_same_v<TEntity,ModelPart::GeometryType>;
+    std::vector<typename TEntity::Pointer> output;
+
+    for (std::size_t i_group=0; i_group<GroupCount; ++i_group) {
+        const auto& r_header = *rReader.Read<BinaryGroupHeader>(1);
+        const std::string name = rReader.ReadString(r_header.mNameSize);
+        const std::uint64_t* p_ids = rReader.Read<std::uint64_t>(r_header.mEntityCount);
+        const std::uint64_t* p_property_ids = has_properties ? rReader.Read<std::uint64_t>(r_header.mEntityCount) : nullptr;
+        KRATOS_ERROR_IF(r_header.mNodesPerEntity && std::numeric_limits<std::uint64_t>::max() / r_header.mNodesPerEntity < r_header.mEntityCount)
+            << "group '" << name << "' has a corrupt header\n";
+        const std::uint64_t* p_connectivity = rReader.Read<std::uint64_t>(r_header.mEntityCount * r_header.mNodesPerEntity);
+
+        KRATOS_ERROR_IF_NOT(KratosComponents<TEntity>::Has(name))
+            << "'" << name << "' is not registered. Is the application providing it imported?\n";
+        const TEntity& r_prototype = KratosComponents<TEntity>::Get(name);
+
+        const std::size_t offset = output.size();
+        output.resize(offset + r_header.mEntityCount);
+        Detail::MakeEntities(r_prototype,
+                             r_header.mEntityCount,
+                             r_header.mNodesPerEntity,
+                             [p_ids](std::size_t i_entity) {return p_ids[i_entity];},
+                             [p_property_ids](std::size_t i_entity) {return p_property_ids[i_entity];},
+                             [&](std::size_t i_entity, std::size_t i_node) {
+                                 const std::uint64_t i_node_index = p_connectivity[i_entity * r_header.mNodesPerEntity + i_node];
+                                 KRATOS_ERROR_IF_NOT(i_node_index < rNodes.size())
+                                     << "node index " << i_node_index << " of " << name << " " << p_ids[i_entity] << " is out of range\n";
+                                 return rNodes[i_node_index];
+                             },
+                             rTarget,
+                             output.data() + offset);
+    }
+
+    return output;
+}
+
+
+} // unnamed namespace
+
+
+struct BinaryModelPartIO::Impl {
+    std::filesystem::path mFilePath;
+}; // struct BinaryModelPartIO::Impl
+
+
+BinaryModelPartIO::BinaryModelPartIO()
+    : mpImpl(new Impl)
+{
+}
+
+
+BinaryModelPartIO::BinaryModelPartIO(RightRef<std::filesystem::path> rFilePath)
+    : mpImpl(new Impl {std::move(rFilePath)})
+{
+}
+
+
+BinaryModelPartIO::~BinaryModelPartIO()
+{
+}
+
+
+void BinaryModelPartIO::Read(Ref<ModelPart> rTarget) const
+{
+    KRATOS_TRY
+    BinaryReader reader(mpImpl->mFilePath);
+
+    const BinaryHeader& r_header = *reader.Read<BinaryHeader>(1);
+    KRATOS_ERROR_IF_NOT(r_header.mMagic == BinaryHeader().mMagic)
+        << mpImpl->mFilePath << " is not a binary model part file\n";
+    KRATOS_ERROR_IF_NOT(r_header.mByteOrderMark == BinaryByteOrderMark)
+        << mpImpl->mFilePath << " was written on a machine with a different byte order\n";
+    KRATOS_ERROR_IF_NOT(r_header.mVersion == BinaryVersion)
+        << mpImpl->mFilePath << " has version " << r_header.mVersion << " but version " << BinaryVersion << " is expected\n";
+    KRATOS_ERROR_IF_NOT(r_header.mFileSize == reader.Size())
+        << mpImpl->mFilePath << " is truncated\n";
+
+    // Nodes
+    const std::size_t node_count = r_header.mNodeCount;
+    const std::uint64_t* p_node_ids = reader.Read<std::uint64_t>(node_count);
+    const double* p_x = reader.Read<double>(node_count);
+    const double* p_y = reader.Read<double>(node_count);
+    const double* p_z = reader.Read<double>(node_count);
+    const double* p_x0 = reader.Read<double>(node_count);
+    const double* p_y0 = reader.Read<double>(node_count);
+    const double* p_z0 = reader.Read<double>(node_count);
+
+    std::vector<ModelPart::NodeType::Pointer> nodes(node_count);
+    const auto p_variables = rTarget.pGetNodalSolutionStepVariablesList();
+    const auto buffer_size = rTarget.GetBufferSize();
+    IndexPartition<std::size_t>(node_count).for_each([&](std::size_t i_node) {
+        nodes[i_node] = Detail::MakeNode(p_node_ids[i_node],
+                                         {p_x0[i_node], p_y0[i_node], p_z0[i_node]},
+                                         {p_x[i_node], p_y[i_node], p_z[i_node]},
+                                         p_variables,
+                                         buffer_size);
+    });
+
+    {
+        ModelPart::NodesContainerType container;
+        container.reserve(node_count);
+        for (const auto& rp_node : nodes) container.push_back(rp_node);
+        rTarget.AddNodes(container.begin(), container.end());
+    }
+
+    // Properties
+    const std::uint64_t* p_property_ids = reader.Read<std::uint64_t>(r_header.mPropertyCount);
+    for (std::size_t i_property=0; i_property<r_header.mPropertyCount; ++i_property) {
+        if (!rTarget.HasProperties(p_property_ids[i_property])) rTarget.CreateNewProperties(p_property_ids[i_property]);
+    }
+
+    // Geometries, elements and conditions
+    const auto geometries = ReadEntities<ModelPart::GeometryType>(reader, r_header.mGroupCounts[0], nodes, rTarget);
+    for (const auto& rp_geometry : geometries) rTarget.AddGeometry(rp_geometry);
+
+    const auto elements = ReadEntities<Element>(reader, r_header.mGroupCounts[1], nodes, rTarget);
+    {
+        ModelPart::ElementsContainerType container;
+        container.reserve(elements.size());
+        for (const auto& rp_element : elements) container.push_back(rp_element);
+        rTarget.AddElements(container.begin(), container.end());
+    }
+
+    const auto conditions = ReadEntities<Condition>(reader, r_header.mGroupCounts[2], nodes, rTarget);
+    {
+        ModelPart::ConditionsContainerType container;
+        container.reserve(conditions.size());
+        for (const auto& rp_condition : conditions) container.push_back(rp_condition);
+        rTarget.AddConditions(container.begin(), container.end());
+    }
+
+    // Sub model parts
+    std::vector<ModelPart*> sub_model_parts;
+    for (std::size_t i_sub_model_part=0; i_sub_model_part<r_header.mSubModelPartCount; ++i_sub_model_part) {
+        const auto& r_sub_header = *reader.Read<BinarySubModelPartHeader>(1);
+        const std::string name = reader.ReadString(r_sub_header.mNameSize);
+        KRATOS_ERROR_IF_NOT(r_sub_header.mParentIndex < static_cast<std::int64_t>(sub_model_parts.size()))
+            << "sub model part '" << name << "' is stored before its parent\n";
+
+        ModelPart& r_parent = r_sub_header.mParentIndex < 0 ? rTarget : *sub_model_parts[r_sub_header.mParentIndex];
+        ModelPart& r_sub_model_part = r_parent.HasSubModelPart(name) ? r_parent.GetSubModelPart(name) : r_parent.CreateSubModelPart(name);
+        sub_model_parts.push_back(&r_sub_model_part);
+
+        const auto check_index = [&name](std::uint64_t Index, std::size_t Size) {
+            KRATOS_ERROR_IF_NOT(Index < Size) << "index " << Index << " in sub model part '" << name << "' is out of range\n";
+            return Index;
+        };
+
+        const std::uint64_t* p_nodes = reader.Read<std::uint64_t>(r_sub_header.mNodeCount);
+        {
+            ModelPart::NodesContainerType container;
+            container.reserve(r_sub_header.mNodeCount);
+            for (std::size_t i=0; i<r_sub_header.mNodeCount; ++i) container.push_back(nodes[check_index(p_nodes[i], nodes.size())]);
+            r_sub_model_part.AddNodes(container.begin(), container.end());
+        }
+
+        const std::uint64_t* p_geometries = reader.Read<std::uint64_t>(r_sub_header.mEntityCounts[0]);
+        {
+            std::vector<ModelPart::IndexType> geometry_ids(r_sub_header.mEntityCounts[0]);
+            for (std::size_t i=0; i<geometry_ids.size(); ++i) geometry_ids[i] = geometries[check_index(p_geometries[i], geometries.size())]->Id();
+            r_sub_model_part.AddGeometries(geometry_ids);
+        }
+
+        const std::uint64_t* p_elements = reader.Read<std::uint64_t>(r_sub_header.mEntityCounts[1]);
+        {
+            ModelPart::ElementsContainerType container;
+            container.reserve(r_sub_header.mEntityCounts[1]);
+            for (std::size_t i=0; i<r_sub_header.mEntityCounts[1]; ++i) container.push_back(elements[check_index(p_elements[i], elements.size())]);
+            r_sub_model_part.AddElements(container.begin(), container.end());
+        }
+
+        const std::uint64_t* p_conditions = reader.Read<std::uint64_t>(r_sub_header.mEntityCounts[2]);
+        {
+            ModelPart::ConditionsContainerType container;
+            container.reserve(r_sub_header.mEntityCounts[2]);
+            for (std::size_t i=0; i<r_sub_header.mEntityCounts[2]; ++i) container.push_back(conditions[check_index(p_conditions[i], conditions.size())]);
+            r_sub_model_part.AddConditions(container.begin(), container.end());
+        }
+
+        const std::uint64_t* p_sub_property_ids = reader.Read<std::uint64_t>(r_sub_header.mPropertyCount);
+        for (std::size_t i=0; i<r_sub_header.mPropertyCount; ++i) {
+            r_sub_model_part.AddProperties(rTarget.pGetProperties(p_sub_property_ids[i]));
+        }
+    }
+    KRATOS_CATCH("")
+}
+
+
+void BinaryModelPartIO::Write(Ref<const ModelPart> rSource)
+{
+    KRATOS_TRY
+    // Nodes, sorted by ID
+    std::vector<const ModelPart::NodeType*> nodes;
+    nodes.reserve(rSource.NumberOfNodes());
+    for (const auto& r_node : rSource.Nodes()) nodes.push_back(&r_node);
+    const auto compare_ids = [](const auto* pLeft, const auto* pRight) {return pLeft->Id() < pRight->Id();};
+    if (!std::is_sorted(nodes.begin(), nodes.end(), compare_ids)) std::sort(nodes.begin(), nodes.end(), compare_ids);
+
+    std::vector<std::uint64_t> node_ids(nodes.size());
+    std::vector<double> x(nodes.size()), y(nodes.size()), z(nodes.size());
+    std::vector<double> x0(nodes.size()), y0(nodes.size()), z0(nodes.size());
+    IndexPartition<std::size_t>(nodes.size()).for_each([&](std::size_t i_node) {
+        const ModelPart::NodeType& r_node = *nodes[i_node];
+        node_ids[i_node] = r_node.Id();
+        x[i_node] = r_node.X();
+        y[i_node] = r_node.Y();
+        z[i_node] = r_node.Z();
+        x0[i_node] = r_node.X0();
+        y0[i_node] = r_node.Y0();
+        z0[i_node] = r_node.Z0();
+    });
+
+    std::vector<std::uint64_t> property_ids;
+    for (auto it_properties=rSource.PropertiesBegin(); it_properties!=rSource.PropertiesEnd(); ++it_properties) {
+        property_ids.push_back(it_properties->Id());
+    }
+
+    const std::array<EntityTable,EntityKindCount> tables {
+        MakeEntityTable<ModelPart::GeometryType>(rSource.Geometries(), node_ids),
+        MakeEntityTable<Element>(rSource.Elements(), node_ids),
+        MakeEntityTable<Condition>(rSource.Conditions(), node_ids)
+    };
+
+    // Sub model parts, parents before their children.
+    std::vector<std::pair<const ModelPart*,std::int64_t>> sub_model_parts;
+    for (const auto& r_sub_model_part : rSource.SubModelParts()) sub_model_parts.emplace_back(&r_sub_model_part, -1);
+    for (std::size_t i_sub_model_part=0; i_sub_model_part<sub_model_parts.size(); ++i_sub_model_part) {
+        for (const auto& r_child : sub_model_parts[i_sub_model_part].first->SubModelParts()) {
+            sub_model_parts.emplace_back(&r_child, static_cast<std::int64_t>(i_sub_model_part));
+        }
+    }
+
+    BinaryHeader header;
+    header.mNodeCount = nodes.size();
+    header.mPropertyCount = property_ids.size();
+    for (std::size_t i_kind=0; i_kind<EntityKindCount; ++i_kind) header.mGroupCounts[i_kind] = tables[i_kind].mGroups.size();
+    header.mSubModelPartCount = sub_model_parts.size();
+
+    BinaryWriter writer(mpImpl->mFilePath);
+    writer.Write(&header, 1); // the file size is set once everything is written
+
+    writer.Write(node_ids);
+    writer.Write(x);
+    writer.Write(y);
+    writer.Write(z);
+    writer.Write(x0);
+    writer.Write(y0);
+    writer.Write(z0);
+    writer.Write(property_ids);
+
+    for (std::size_t i_kind=0; i_kind<EntityKindCount; ++i_kind) {
+        for (const auto& r_group : tables[i_kind].mGroups) {
+            BinaryGroupHeader group_header;
+            group_header.mNameSize = r_group.mName.size();
+            group_header.mEntityCount = r_group.mIds.size();
+            group_header.mNodesPerEntity = r_group.mNodesPerEntity;
+            writer.Write(&group_header, 1);
+            writer.Write(r_group.mName);
+            writer.Write(r_group.mIds);
+            if (i_kind) writer.Write(r_group.mPropertyIds);
+            writer.Write(r_group.mConnectivity);
+        }
+    }
+
+    for (const auto& [rp_sub_model_part, i_parent] : sub_model_parts) {
+        const ModelPart& r_sub_model_part = *rp_sub_model_part;
+
+        std::vector<std::uint64_t> node_indices;
+        node_indices.reserve(r_sub_model_part.NumberOfNodes());
+        for (const auto& r_node : r_sub_model_part.Nodes()) node_indices.push_back(Detail::FindNodeIndex(node_ids, r_node.Id()));
+
+        std::array<std::vector<std::uint64_t>,EntityKindCount> entity_indices;
+        for (const auto& r_geometry : r_sub_model_part.Geometries()) entity_indices[0].push_back(tables[0].FindIndex(r_geometry.Id()));
+        for (const auto& r_element : r_sub_model_part.Elements()) entity_indices[1].push_back(tables[1].FindIndex(r_element.Id()));
+        for (const auto& r_condition : r_sub_model_part.Conditions()) entity_indices[2].push_back(tables[2].FindIndex(r_condition.Id()));
+
+        std::vector<std::uint64_t> sub_property_ids;
+        for (auto it_properties=r_sub_model_part.PropertiesBegin(); it_properties!=r_sub_model_part.PropertiesEnd(); ++it_properties) {
+            sub_property_ids.push_back(it_properties->Id());
+        }
+
+        BinarySubModelPartHeader sub_header;
+        sub_header.mNameSize = r_sub_model_part.Name().size();
+        sub_header.mParentIndex = i_parent;
+        sub_header.mNodeCount = node_indices.size();
+        for (std::size_t i_kind=0; i_kind<EntityKindCount; ++i_kind) sub_header.mEntityCounts[i_kind] = entity_indices[i_kind].size();
+        sub_header.mPropertyCount = sub_property_ids.size();
+
+        writer.Write(&sub_header, 1);
+        writer.Write(r_sub_model_part.Name());
+        writer.Write(node_indices);
+        for (const auto& r_indices : entity_indices) writer.Write(r_indices);
+        writer.Write(sub_property_ids);
+    }
+
+    header.mFileSize = writer.Size();
+    writer.WriteHeader(header);
+    writer.Flush();
+    KRATOS_CATCH("")
+}
+
+
+} // namespace Kratos::UtilityApp
@@ -0,0 +1,858 @@
+/// @author Máté Kelemen
+
+// --- HDF5 Includes ---
+#include <hdf5.h>
+
+// --- Core Includes ---
+#include "includes/model_part.h"
+#include "includes/kratos_components.h"
+#include "includes/variables.h"
+#include "utilities/parallel_utilities.h"
+
+#if defined(KRATOS_USING_MPI) && defined(H5_HAVE_PARALLEL)
+#include "mpi/includes/mpi_data_communicator.h"
+#endif
+
+// --- Utility Includes ---
+#include "UtilityApp/CollectiveHDF5.hpp"
+#include "EntityConstruction.hpp"
+
+// --- STL Includes ---
+#include <vector> // vector
+#include <array> // array
+#include <string> // string
+#include <map> // map
+#include <algorithm> // sort, unique, remove_if, lower_bound, upper_bound, clamp, min, max, find, any_of
+#include <cstdint> // uint64_t
+#include <limits> // numeric_limits
+#include <tuple> // tuple, get
+#include <utility> // pair, make_pair
+#include <type_traits> // is_same_v
+
+
+namespace Kratos::UtilityApp {
+
+
+namespace {
+
+
+/// @brief Identifier of the zstd filter in the registry of HDF5 filter plugins.
+constexpr H5Z_filter_t ZstdFilterId = 32015;
+
+
+hid_t CheckHDF5(hid_t Id, const char* pWhat)
+{
+    KRATOS_ERROR_IF(Id < 0) << "HDF5 failed to " << pWhat << "\n";
+    return Id;
+}
+
+
+/// @brief Owning wrapper of an HDF5 identifier.
+class HDF5Handle
+{
+public:
+    HDF5Handle(hid_t Id, herr_t (*pClose)(hid_t), const char* pWhat)
+        : mId(CheckHDF5(Id, pWhat)),
+          mpClose(pClose)
+    {
+    }
+
+    HDF5Handle(HDF5Handle&& rOther) noexcept
+        : mId(rOther.mId),
+          mpClose(rOther.mpClose)
+    {
+        rOther.mId = -1;
+    }
+
+    HDF5Handle(const HDF5Handle&) = delete;
+
+    ~HDF5Handle()
+    {
+        if (0 <= mId) mpClose(mId);
+    }
+
+    operator hid_t() const noexcept {return mId;}
+
+private:
+    hid_t mId;
+
+    herr_t (*mpClose)(hid_t);
+}; // class HDF5Handle
+
+
+template <class T>
+hid_t GetHDF5Type()
+{
+    if constexpr (std::is_same_v<T,double>) return H5T_NATIVE_DOUBLE;
+    else return H5T_NATIVE_UINT64;
+}
+
+
+/// @brief First row of each rank's equal share of @p RowCount rows, and the total at the end.
+std::vector<std::size_t> MakeShares(std::size_t RowCount, std::size_t RankCount)
+{
+    std::vector<std::size_t> shares(RankCount + 1);
+    for (std::size_t i_rank=0; i_rank<=RankCount; ++i_rank) {
+        shares[i_rank] = RowCount / RankCount * i_rank + std::min(i_rank, RowCount % RankCount);
+    }
+    return shares;
+}
+
+
+HDF5Handle OpenFile(const std::filesystem::path& rFilePath, const DataCommunicator& rDataCommunicator, bool Create)
+{
+    HDF5Handle access(H5Pcreate(H5P_FILE_ACCESS), H5Pclose, "create file access properties");
+    if (rDataCommunicator.IsDistributed()) {
+        #if defined(KRATOS_USING_MPI) && defined(H5_HAVE_PARALLEL)
+            CheckHDF5(H5Pset_fapl_mpio(access, MPIDataCommunicator::GetMPICommunicator(rDataCommunicator), MPI_INFO_NULL),
+                      "set MPI-IO file access");
+        #else
+            KRATOS_ERROR << "collective HDF5 IO on distributed model parts requires Kratos and HDF5 built with MPI\n";
+        #endif
+    }
+
+    if (Create) {
+        return HDF5Handle(H5Fcreate(rFilePath.string().c_str(), H5F_ACC_EXCL, H5P_DEFAULT, access), H5Fclose, "create file");
+    } else {
+        return HDF5Handle(H5Fopen(rFilePath.string().c_str(), H5F_ACC_RDONLY, access), H5Fclose, "open file");
+    }
+}
+
+
+/// @brief Check whether an item of @ref CollectiveHDF5Settings::mEntityTypes selects @p rKind or its group @p rName.
+bool IsSelected(const std::vector<std::string>& rSelection, const std::string& rKind, const std::string& rName = "")
+{
+    return rSelection.empty()
+           || std::find(rSelection.begin(), rSelection.end(), rKind) != rSelection.end()
+           || (!rName.empty() && std::find(rSelection.begin(), rSelection.end(), rName) != rSelection.end());
+}
+
+
+/// @brief Set up the compression of a dataset with @p ElementsPerChunk values in each of its chunks.
+void SetFilter(hid_t Creation, const CollectiveHDF5Settings& rSettings, std::size_t ElementsPerChunk)
+{
+    if (!rSettings.mCompressionLevel) return;
+    switch (rSettings.mFilter) {
+        case HDF5Filter::None:
+            break;
+        case HDF5Filter::Deflate:
+            // Shuffling groups the bytes of IDs and coordinates by significance,
+            // which makes the (mostly sequential) IDs compress considerably better.
+            CheckHDF5(H5Pset_shuffle(Creation), "set shuffle filter");
+            CheckHDF5(H5Pset_deflate(Creation, rSettings.mCompressionLevel), "set deflate filter");
+            break;
+        case HDF5Filter::Zstd: {
+            const unsigned level = rSettings.mCompressionLevel;
+            CheckHDF5(H5Pset_shuffle(Creation), "set shuffle filter");
+            CheckHDF5(H5Pset_filter(Creation, ZstdFilterId, H5Z_FLAG_MANDATORY, 1, &level), "set zstd filter");
+            break;
+        }
+        case HDF5Filter::Szip:
+            // Szip refuses chunks smaller than a block, which only happens for tiny datasets.
+            if (static_cast<std::size_t>(rSettings.mCompressionLevel) <= ElementsPerChunk) {
+                CheckHDF5(H5Pset_szip(Creation, H5_SZIP_NN_OPTION_MASK, rSettings.mCompressionLevel), "set szip filter");
+            }
+            break;
+    }
+}
+
+
+/// @brief Collective writer of each rank's rows into shared datasets.
+class CollectiveWriter
+{
+public:
+    CollectiveWriter(const std::filesystem::path& rFilePath,
+                     const DataCommunicator& rDataCommunicator,
+                     const CollectiveHDF5Settings& rSettings)
+        : mrDataCommunicator(rDataCommunicator),
+          mrSettings(rSettings),
+          mFile(OpenFile(rFilePath, rDataCommunicator, true)),
+          mLinkProperties(H5Pcreate(H5P_LINK_CREATE), H5Pclose, "create link properties"),
+          mTransferProperties(H5Pcreate(H5P_DATASET_XFER), H5Pclose, "create transfer properties")
+    {
+        KRATOS_ERROR_IF(rSettings.mCompressionLevel && !IsHDF5FilterAvailable(rSettings.mFilter))
+            << "the requested HDF5 compression filter is not available\n";
+        CheckHDF5(H5Pset_create_intermediate_group(mLinkProperties, 1), "set intermediate group creation");
+        #if defined(KRATOS_USING_MPI) && defined(H5_HAVE_PARALLEL)
+            if (rDataCommunicator.IsDistributed()) {
+                CheckHDF5(H5Pset_dxpl_mpio(mTransferProperties, H5FD_MPIO_COLLECTIVE), "set collective transfers");
+            }
+        #endif
+    }
+
+    /// @brief Write the local rows (of @p Columns values each) at the position of this rank. Collective.
+    template <class T>
+    void Write(const std::string& rPath, const std::vector<T>& rLocal, std::size_t Columns = 1)
+    {
+        const std::size_t local_rows = rLocal.size() / Columns;
+        const std::size_t row_begin = mrDataCommunicator.ScanSum(local_rows) - local_rows;
+        const std::size_t row_count = mrDataCommunicator.SumAll(local_rows);
+        const int dimensions = Columns == 1 ? 1 : 2;
+
+        const std::array<hsize_t,2> extent {row_count, Columns};
+        HDF5Handle file_space(H5Screate_simple(dimensions, extent.data(), nullptr), H5Sclose, "create file space");
+
+        // Chunks hold whole rows.
+        HDF5Handle creation(H5Pcreate(H5P_DATASET_CREATE), H5Pclose, "create dataset properties");
+        if (row_count) {
+            const std::array<hsize_t,2> chunk {std::clamp<std::size_t>(mrSettings.mChunkSize / (Columns * sizeof(T)), 1, row_count), Columns};
+            CheckHDF5(H5Pset_chunk(creation, dimensions, chunk.data()), "set chunk size");
+            SetFilter(creation, mrSettings, chunk[0] * chunk[1]);
+        }
+
+        const std::string path = mrSettings.mPrefix + "/" + rPath;
+        HDF5Handle dataset(H5Dcreate2(mFile, path.c_str(), GetHDF5Type<T>(), file_space, mLinkProperties, creation, H5P_DEFAULT),
+                           H5Dclose,
+                           "create dataset");
+
+        const std::array<hsize_t,2> offset {row_begin, 0}, count {local_rows, Columns};
+        HDF5Handle memory_space(H5Screate_simple(dimensions, count.data(), nullptr), H5Sclose, "create memory space");
+        if (local_rows) {
+            CheckHDF5(H5Sselect_hyperslab(file_space, H5S_SELECT_SET, offset.data(), nullptr, count.data(), nullptr), "select hyperslab");
+        } else {
+            CheckHDF5(H5Sselect_none(file_space), "select nothing");
+            CheckHDF5(H5Sselect_none(memory_space), "select nothing");
+        }
+        CheckHDF5(H5Dwrite(dataset, GetHDF5Type<T>(), memory_space, file_space, mTransferProperties, rLocal.data()),
+                  "write dataset");
+    }
+
+private:
+    const DataCommunicator& mrDataCommunicator;
+
+    const CollectiveHDF5Settings& mrSettings;
+
+    HDF5Handle mFile;
+
+    HDF5Handle mLinkProperties;
+
+    HDF5Handle mTransferProperties;
+}; // class CollectiveWriter
+
+
+/// @brief Write elements or conditions grouped by their registered names. Collective.
+template <class TEntity, class TContainer>
+void WriteEntities(Ref<CollectiveWriter> rWriter,
+                   const TContainer& rEntities,
+                   const DataCommunicator& rDataCommunicator,
+                   const std::string& rKind)
+{
+    const Detail::EntityGrouping grouping = Detail::GroupByRegisteredName(rEntities);
+    std::map<std::string,std::vector<const TEntity*>> groups;
+    auto it_position = grouping.mPositions.begin();
+    for (const auto& r_entity : rEntities) groups[grouping.mGroups[(it_position++)->first].mName].push_back(&r_entity);
+
+    // Every rank has to create every dataset, so groups are agreed on through
+    // their positions in the registry, which is identical on all ranks.
+    const auto& r_components = KratosComponents<TEntity>::GetComponents();
+    std::vector<int> flags(r_components.size(), 0);
+    std::size_t i_component = 0;
+    for (const auto& r_pair : r_components) flags[i_component++] = groups.count(r_pair.first) ? 1 : 0;
+    flags = rDataCommunicator.MaxAll(flags);
+
+    i_component = 0;
+    for (const auto& r_pair : r_components) {
+        if (!flags[i_component++]) continue;
+        const std::string& r_name = r_pair.first;
+        const auto it_group = groups.find(r_name);
+        const std::size_t entity_count = it_group == groups.end() ? 0 : it_group->second.size();
+        const std::size_t nodes_per_entity = r_pair.second->GetGeometry().size();
+
+        std::vector<std::uint64_t> ids(entity_count), property_ids(entity_count), connectivities(entity_count * nodes_per_entity);
+        IndexPartition<std::size_t>(entity_count).for_each([&](std::size_t i_entity) {
+            const TEntity& r_entity = *it_group->second[i_entity];
+            const auto& r_geometry = r_entity.GetGeometry();
+            KRATOS_ERROR_IF_NOT(r_geometry.size() == nodes_per_entity)
+                << r_name << " " << r_entity.Id() << " has " << r_geometry.size() << " nodes instead of " << nodes_per_entity << "\n";
+            ids[i_entity] = r_entity.Id();
+            property_ids[i_entity] = r_entity.pGetProperties() ? r_entity.GetProperties().Id() : Detail::NoProperties;
+            for (std::size_t i_node=0; i_node<nodes_per_entity; ++i_node) {
+                connectivities[i_entity * nodes_per_entity + i_node] = r_geometry[i_node].Id();
+            }
+        });
+
+        const std::string group = rKind + "/" + r_name + "/";
+        rWriter.Write(group + "Ids", ids);
+        rWriter.Write(group + "PropertyIds", property_ids);
+        rWriter.Write(group + "Connectivities", connectivities, std::max<std::size_t>(nodes_per_entity, 1));
+    }
+}
+
+
+template <class TIterator>
+std::vector<std::uint64_t> CollectIds(TIterator itBegin, TIterator itEnd)
+{
+    std::vector<std::uint64_t> ids;
+    for (; itBegin!=itEnd; ++itBegin) ids.push_back(itBegin->Id());
+    return ids;
+}
+
+
+void WriteSubModelParts(Ref<CollectiveWriter> rWriter,
+                        Ref<const ModelPart> rModelPart,
+                        const DataCommunicator& rDataCommunicator,
+                        const std::string& rPath)
+{
+    auto names = rModelPart.GetSubModelPartNames();
+    std::sort(names.begin(), names.end());
+
+    // Every rank has to create the same datasets, so the names are compared with the ones on the first rank.
+    std::string joined_names;
+    for (const auto& r_name : names) joined_names += r_name + "\n";
+    int name_size = joined_names.size();
+    rDataCommunicator.Broadcast(name_size, 0);
+    std::string reference_names = joined_names;
+    reference_names.resize(name_size);
+    rDataCommunicator.Broadcast(reference_names, 0);
+    KRATOS_ERROR_IF_NOT(rDataCommunicator.MinAll(static_cast<int>(reference_names == joined_names)))
+        << "ranks have different sub model parts in " << rModelPart.FullName() << "\n";
+
+    for (const auto& r_name : names) {
+        const ModelPart& r_sub_model_part = rModelPart.GetSubModelPart(r_name);
+        const auto& r_local_mesh = r_sub_model_part.GetCommunicator().LocalMesh();
+        const std::string path = rPath + "SubModelParts/" + r_name + "/";
+        rWriter.Write(path + "NodeIds", CollectIds(r_local_mesh.NodesBegin(), r_local_mesh.NodesEnd()));
+        rWriter.Write(path + "ElementIds", CollectIds(r_sub_model_part.ElementsBegin(), r_sub_model_part.ElementsEnd()));
+        rWriter.Write(path + "ConditionIds", CollectIds(r_sub_model_part.ConditionsBegin(), r_sub_model_part.ConditionsEnd()));
+        rWriter.Write(path + "PropertyIds", rDataCommunicator.Rank() ? std::vector<std::uint64_t>() : CollectIds(r_sub_model_part.PropertiesBegin(), r_sub_model_part.PropertiesEnd()));
+        WriteSubModelParts(rWriter, r_sub_model_part, rDataCommunicator, path);
+    }
+}
+
+
+/// @brief Collective reads of parts of datasets.
+/// @details Every rank must call each read, even if it selects nothing.
+class Reader
+{
+public:
+    Reader(const std::filesystem::path& rFilePath,
+           const DataCommunicator& rDataCommunicator,
+           const CollectiveHDF5Settings& rSettings)
+        : mFile(OpenFile(rFilePath, rDataCommunicator, false)),
+          mTransferProperties(H5Pcreate(H5P_DATASET_XFER), H5Pclose, "create transfer properties"),
+          mPrefix(rSettings.mPrefix)
+    {
+        #if defined(KRATOS_USING_MPI) && defined(H5_HAVE_PARALLEL)
+            if (rDataCommunicator.IsDistributed()) {
+                CheckHDF5(H5Pset_dxpl_mpio(mTransferProperties, H5FD_MPIO_COLLECTIVE), "set collective transfers");
+            }
+        #endif
+    }
+
+    bool Has(const std::string& rPath) const
+    {
+        // Check each link along the path, since checking a link whose parent is missing fails.
+        const std::string full_path = mPrefix + "/" + rPath;
+        for (std::size_t end=full_path.find('/', 1); ; end=full_path.find('/', end + 1)) {
+            const std::string path = full_path.substr(0, end);
+            if (!path.empty() && path.back() != '/' && H5Lexists(mFile, path.c_str(), H5P_DEFAULT) <= 0) return false;
+            if (end == std::string::npos) break;
+        }
+        return true;
+    }
+
+    /// @brief Names of the links in a group, or nothing if the group does not exist.
+    std::vector<std::string> List(const std::string& rPath) const
+    {
+        std::vector<std::string> names;
+        if (!this->Has(rPath)) return names;
+        HDF5Handle group(H5Gopen2(mFile, (mPrefix + "/" + rPath).c_str(), H5P_DEFAULT), H5Gclose, "open group");
+        H5G_info_t info;
+        CheckHDF5(H5Gget_info(group, &info), "get group info");
+        for (hsize_t i_link=0; i_link<info.nlinks; ++i_link) {
+            const auto size = CheckHDF5(H5Lget_name_by_idx(group, ".", H5_INDEX_NAME, H5_ITER_INC, i_link, nullptr, 0, H5P_DEFAULT), "get link name");
+            std::string name(size + 1, '\0');
+            CheckHDF5(H5Lget_name_by_idx(group, ".", H5_INDEX_NAME, H5_ITER_INC, i_link, name.data(), name.size(), H5P_DEFAULT), "get link name");
+            name.resize(size);
+            names.push_back(std::move(name));
+        }
+        return names;
+    }
+
+    /// @brief Number of rows and columns of a dataset.
+    std::pair<std::size_t,std::size_t> Shape(const std::string& rPath) const
+    {
+        HDF5Handle dataset = this->Open(rPath);
+        HDF5Handle space(H5Dget_space(dataset), H5Sclose, "get file space");
+        std::array<hsize_t,2> extent {0, 1};
+        CheckHDF5(H5Sget_simple_extent_dims(space, extent.data(), nullptr), "get extent");
+        return {extent[0], extent[1]};
+    }
+
+    /// @brief Read a contiguous range of rows. Collective.
+    template <class T>
+    std::vector<T> Read(const std::string& rPath, std::size_t RowBegin, std::size_t RowCount) const
+    {
+        HDF5Handle dataset = this->Open(rPath);
+        HDF5Handle file_space(H5Dget_space(dataset), H5Sclose, "get file space");
+        const int dimensions = H5Sget_simple_extent_ndims(file_space);
+        std::array<hsize_t,2> extent {0, 1};
+        CheckHDF5(H5Sget_simple_extent_dims(file_space, extent.data(), nullptr), "get extent");
+
+        std::vector<T> output(RowCount * extent[1]);
+        const std::array<hsize_t,2> offset {RowBegin, 0}, count {RowCount, extent[1]};
+        HDF5Handle memory_space(H5Screate_simple(dimensions, count.data(), nullptr), H5Sclose, "create memory space");
+        if (RowCount) {
+            CheckHDF5(H5Sselect_hyperslab(file_space, H5S_SELECT_SET, offset.data(), nullptr, count.data(), nullptr), "select hyperslab");
+        } else {
+            CheckHDF5(H5Sselect_none(file_space), "select nothing");
+            CheckHDF5(H5Sselect_none(memory_space), "select nothing");
+        }
+        CheckHDF5(H5Dread(dataset, GetHDF5Type<T>(), memory_space, file_space, mTransferProperties, output.data()), "read dataset");
+        return output;
+    }
+
+    /// @brief Read this rank's equal share of a dataset's rows (see @ref MakeShares). Collective.
+    template <class T>
+    std::vector<T> ReadShare(const std::string& rPath, int Rank, int RankCount) const
+    {
+        const auto shares = MakeShares(this->Shape(rPath).first, RankCount);
+        return this->Read<T>(rPath, shares[Rank], shares[Rank + 1] - shares[Rank]);
+    }
+
+
+private:
+    HDF5Handle Open(const std::string& rPath) const
+    {
+        return HDF5Handle(H5Dopen2(mFile, (mPrefix + "/" + rPath).c_str(), H5P_DEFAULT), H5Dclose, "open dataset");
+    }
+
+    HDF5Handle mFile;
+
+    HDF5Handle mTransferProperties;
+
+    std::string mPrefix;
+}; // class Reader
+
+
+/// @brief Send a list of values to each rank, and receive the lists the other ranks sent to this one. Collective.
+/// @details Pairwise exchanges in @a RankCount - 1 rounds, so only the listed values are communicated.
+template <class T>
+std::vector<std::vector<T>> Exchange(const DataCommunicator& rDataCommunicator, const std::vector<std::vector<T>>& rOutgoing)
+{
+    const int rank = rDataCommunicator.Rank();
+    const int rank_count = rDataCommunicator.Size();
+    std::vector<std::vector<T>> incoming(rank_count);
+    incoming[rank] = rOutgoing[rank];
+    for (int offset=1; offset<rank_count; ++offset) {
+        const int destination = (rank + offset) % rank_count;
+        const int source = (rank - offset + rank_count) % rank_count;
+        incoming[source] = rDataCommunicator.SendRecv(rOutgoing[destination], destination, source);
+    }
+    return incoming;
+}
+
+
+/// @brief Smallest and largest ID on each rank, for finding the ranks an ID can be on.
+/// @details Ranges of different ranks may overlap, in which case an ID is sent to each of them.
+class IdRanges
+{
+public:
+    /// @brief Gather the range of IDs in [@p itBegin, @p itEnd) on each rank. Collective.
+    template <class TIterator, class TGetId>
+    IdRanges(const DataCommunicator& rDataCommunicator, TIterator itBegin, TIterator itEnd, TGetId&& rGetId)
+    {
+        std::vector<std::uint64_t> bounds {std::numeric_limits<std::uint64_t>::max(), 0};
+        for (; itBegin!=itEnd; ++itBegin) {
+            const std::uint64_t id = rGetId(*itBegin);
+            bounds[0] = std::min(bounds[0], id);
+            bounds[1] = std::max(bounds[1], id);
+        }
+        bounds = rDataCommunicator.AllGather(bounds);
+
+        for (int i_rank=0; i_rank<rDataCommunicator.Size(); ++i_rank) {
+            if (bounds[2 * i_rank] <= bounds[2 * i_rank + 1]) {
+                mRanges.push_back({bounds[2 * i_rank], bounds[2 * i_rank + 1], i_rank});
+            }
+        }
+        std::sort(mRanges.begin(), mRanges.end(), [](const Range& rLeft, const Range& rRight){return rLeft.mBegin < rRight.mBegin;});
+        for (std::size_t i_range=0; i_range<mRanges.size(); ++i_range) {
+            mMaxEnds.push_back(std::max(mRanges[i_range].mEnd, i_range ? mMaxEnds.back() : 0));
+        }
+    }
+
+    /// @brief Sort @p rIds into lists for each rank whose range contains them.
+    std::vector<std::vector<std::uint64_t>> Route(const std::vector<std::uint64_t>& rIds, int RankCount) const
+    {
+        std::vector<std::vector<std::uint64_t>> output(RankCount);
+        for (auto id : rIds) {
+            // Ranges starting after the ID cannot contain it, and neither can
+            // the ones before the last range that could reach it.
+            std::size_t i_range = std::distance(mRanges.begin(), std::upper_bound(mRanges.begin(), mRanges.end(), id, [](auto Id, const Range& rRange){return Id < rRange.mBegin;}));
+            while (i_range && id <= mMaxEnds[i_range - 1]) {
+                const Range& r_range = mRanges[--i_range];
+                if (id <= r_range.mEnd) output[r_range.mRank].push_back(id);
+            }
+        }
+        return output;
+    }
+
+private:
+    struct Range
+    {
+        std::uint64_t mBegin, mEnd; // inclusive
+
+        int mRank;
+    }; // struct Range
+
+    std::vector<Range> mRanges;
+
+    // Largest end of the ranges up to and including each one.
+    std::vector<std::uint64_t> mMaxEnds;
+}; // class IdRanges
+
+
+/// @brief Elements or conditions of a group read by this rank.
+struct EntityGroup
+{
+    std::string mName;
+
+    std::size_t mNodesPerEntity;
+
+    std::vector<std::uint64_t> mIds;
+
+    std::vector<std::uint64_t> mPropertyIds;
+
+    std::vector<std::uint64_t> mConnectivities;
+}; // struct EntityGroup
+
+
+template <class TEntity>
+std::vector<EntityGroup> ReadEntityGroups(const Reader& rReader,
+                                          const std::string& rKind,
+                                          const std::vector<std::string>& rSelection,
+                                          int Rank,
+                                          int RankCount)
+{
+    std::vector<EntityGroup> groups;
+    for (const auto& r_name : rReader.List(rKind)) {
+        if (!IsSelected(rSelection, rKind, r_name)) continue;
+        KRATOS_ERROR_IF_NOT(KratosComponents<TEntity>::Has(r_name))
+            << "'" << r_name << "' is not registered. Is the application providing it imported?\n";
+
+        const std::string path = rKind + "/" + r_name + "/";
+        const auto [entity_count, nodes_per_entity] = rReader.Shape(path + "Connectivities");
+        const auto shares = MakeShares(entity_count, RankCount);
+        const std::size_t begin = shares[Rank], count = shares[Rank + 1] - shares[Rank];
+
+        EntityGroup& r_group = groups.emplace_back();
+        r_group.mName = r_name;
+        r_group.mNodesPerEntity = nodes_per_entity;
+        r_group.mIds = rReader.Read<std::uint64_t>(path + "Ids", begin, count);
+        r_group.mPropertyIds = rReader.Read<std::uint64_t>(path + "PropertyIds", begin, count);
+        r_group.mConnectivities = rReader.Read<std::uint64_t>(path + "Connectivities", begin, count);
+    }
+    return groups;
+}
+
+
+template <class TEntity>
+std::vector<typename TEntity::Pointer> MakeEntities(const std::vector<EntityGroup>& rGroups, Ref<ModelPart> rTarget)
+{
+    std::vector<typename TEntity::Pointer> output;
+    for (const EntityGroup& r_group : rGroups) {
+        const std::size_t offset = output.size();
+        output.resize(offset + r_group.mIds.size());
+        Detail::MakeEntities(KratosComponents<TEntity>::Get(r_group.mName),
+                             r_group.mIds.size(),
+                             r_group.mNodesPerEntity,
+                             [&r_group](std::size_t i_entity) {return r_group.mIds[i_entity];},
+                             [&r_group](std::size_t i_entity) {return r_group.mPropertyIds[i_entity];},
+                             [&r_group, &rTarget](std::size_t i_entity, std::size_t i_node) {
+                                 return rTarget.pGetNode(r_group.mConnectivities[i_entity * r_group.mNodesPerEntity + i_node]);
+                             },
+                             rTarget,
+                             output.data() + offset);
+    }
+    return output;
+}
+
+
+/// @brief Read an ID dataset, each rank a share, and send the IDs to the ranks whose range contains them. Collective.
+/// @param pRanges Ranges of the IDs each rank can use, or nullptr to send all IDs to all ranks.
+/// @param rFilter Predicate selecting the received IDs this rank keeps.
+template <class TFilter>
+std::vector<ModelPart::IndexType> ReadIds(const Reader& rReader,
+                                          const std::string& rPath,
+                                          const DataCommunicator& rDataCommunicator,
+                                          const IdRanges* pRanges,
+                                          TFilter&& rFilter)
+{
+    std::vector<ModelPart::IndexType> ids;
+    if (!rReader.Has(rPath)) return ids;
+
+    const int rank_count = rDataCommunicator.Size();
+    const auto share = rReader.ReadShare<std::uint64_t>(rPath, rDataCommunicator.Rank(), rank_count);
+    const auto incoming = Exchange(rDataCommunicator,
+                                   pRanges ? pRanges->Route(share, rank_count) : std::vector<std::vector<std::uint64_t>>(rank_count, share));
+    for (const auto& r_ids : incoming) {
+        for (auto id : r_ids) if (rFilter(id)) ids.push_back(id);
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+
+/// @brief Ranges of the IDs of nodes, elements and conditions each rank holds after reading the mesh.
+struct LocalRanges
+{
+    IdRanges mNodes, mElements, mConditions;
+}; // struct LocalRanges
+
+
+/// @brief Path of the group holding a sub model part, from its name relative to the root ("a.b" => "SubModelParts/a/SubModelParts/b/").
+std::string GetSubModelPartPath(const std::string& rName)
+{
+    std::string path;
+    for (std::size_t begin=0, end=0; end!=std::string::npos; begin=end+1) {
+        end = rName.find('.', begin);
+        path += "SubModelParts/" + rName.substr(begin, end - begin) + "/";
+    }
+    return path;
+}
+
+
+void ReadSubModelParts(const Reader& rReader,
+                       Ref<ModelPart> rModelPart,
+                       const std::string& rPath,
+                       const DataCommunicator& rDataCommunicator,
+                       const LocalRanges& rRanges,
+                       const CollectiveHDF5Settings& rSettings)
+{
+    const ModelPart& r_root = rModelPart.GetRootModelPart();
+    const bool read_properties = IsSelected(rSettings.mEntityTypes, "Properties");
+    const auto& r_selection = rSettings.mSubModelParts;
+
+    for (const auto& r_name : rReader.List(rPath + "SubModelParts")) {
+        const std::string path = rPath + "SubModelParts/" + r_name + "/";
+
+        // Selected sub model parts are read along with their descendants,
+        // while their ancestors are only created to hold them.
+        const bool is_selected = r_selection.empty() || std::any_of(r_selection.begin(), r_selection.end(), [&path](const std::string& r_item){
+            return path.rfind(GetSubModelPartPath(r_item), 0) == 0;
+        });
+        const bool is_ancestor = std::any_of(r_selection.begin(), r_selection.end(), [&path](const std::string& r_item){
+            return GetSubModelPartPath(r_item).rfind(path, 0) == 0;
+        });
+        if (!is_selected && !is_ancestor) continue;
+
+        ModelPart& r_sub_model_part = rModelPart.HasSubModelPart(r_name) ? rModelPart.GetSubModelPart(r_name) : rModelPart.CreateSubModelPart(r_name);
+        if (is_selected) {
+            // Only entities that were read by this rank are added.
+            r_sub_model_part.AddNodes(ReadIds(rReader, path + "NodeIds", rDataCommunicator, &rRanges.mNodes, [&r_root](auto Id){return r_root.HasNode(Id);}));
+            r_sub_model_part.AddElements(ReadIds(rReader, path + "ElementIds", rDataCommunicator, &rRanges.mElements, [&r_root](auto Id){return r_root.HasElement(Id);}));
+            r_sub_model_part.AddConditions(ReadIds(rReader, path + "ConditionIds", rDataCommunicator, &rRanges.mConditions, [&r_root](auto Id){return r_root.HasCondition(Id);}));
+            if (read_properties) {
+                for (auto id : ReadIds(rReader, path + "PropertyIds", rDataCommunicator, nullptr, [](auto){return true;})) {
+                    r_sub_model_part.AddProperties(rModelPart.GetRootModelPart().pGetProperties(id));
+                }
+            }
+        }
+
+        ReadSubModelParts(rReader, r_sub_model_part, path, rDataCommunicator, rRanges, rSettings);
+    }
+}
+
+
+} // unnamed namespace
+
+
+bool IsHDF5FilterAvailable(HDF5Filter Filter)
+{
+    H5Z_filter_t id = H5Z_FILTER_DEFLATE;
+    switch (Filter) {
+        case HDF5Filter::None: return true;
+        case HDF5Filter::Deflate: id = H5Z_FILTER_DEFLATE; break;
+        case HDF5Filter::Zstd: id = ZstdFilterId; break;
+        case HDF5Filter::Szip: id = H5Z_FILTER_SZIP; break;
+    }
+
+    // Looks for dynamically loaded plugins as well.
+    if (H5Zfilter_avail(id) <= 0) return false;
+    unsigned flags = 0;
+    return 0 <= H5Zget_filter_info(id, &flags) && (flags & H5Z_FILTER_CONFIG_ENCODE_ENABLED);
+}
+
+
+void WriteCollectiveHDF5(const std::filesystem::path& rFilePath,
+                         Ref<const ModelPart> rSource,
+                         const DataCommunicator& rDataCommunicator,
+                         const CollectiveHDF5Settings& rSettings)
+{
+    KRATOS_TRY
+    CollectiveWriter writer(rFilePath, rDataCommunicator, rSettings);
+
+    // Owned nodes
+    const auto& r_nodes = rSource.GetCommunicator().LocalMesh().Nodes();
+    std::vector<std::uint64_t> node_ids(r_nodes.size());
+    std::vector<double> coordinates(3 * r_nodes.size());
+    IndexPartition<std::size_t>(r_nodes.size()).for_each([&](std::size_t i_node) {
+        const auto& r_node = *(r_nodes.begin() + i_node);
+        node_ids[i_node] = r_node.Id();
+        coordinates[3 * i_node] = r_node.X();
+        coordinates[3 * i_node + 1] = r_node.Y();
+        coordinates[3 * i_node + 2] = r_node.Z();
+    });
+    writer.Write("Nodes/Ids", node_ids);
+    writer.Write("Nodes/Coordinates", coordinates, 3);
+
+    // Properties are identical on all ranks.
+    writer.Write("Properties/Ids", rDataCommunicator.Rank() ? std::vector<std::uint64_t>() : CollectIds(rSource.PropertiesBegin(), rSource.PropertiesEnd()));
+
+    WriteEntities<Element>(writer, rSource.Elements(), rDataCommunicator, "Elements");
+    WriteEntities<Condition>(writer, rSource.Conditions(), rDataCommunicator, "Conditions");
+    WriteSubModelParts(writer, rSource, rDataCommunicator, "");
+    KRATOS_CATCH("")
+}
+
+
+void ReadCollectiveHDF5(const std::filesystem::path& rFilePath,
+                        Ref<ModelPart> rTarget,
+                        const DataCommunicator& rDataCommunicator,
+                        const CollectiveHDF5Settings& rSettings)
+{
+    KRATOS_TRY
+    const Reader reader(rFilePath, rDataCommunicator, rSettings);
+    const int rank = rDataCommunicator.Rank();
+    const int rank_count = rDataCommunicator.Size();
+    const auto& r_selection = rSettings.mEntityTypes;
+
+    for (const auto& r_item : r_selection) {
+        KRATOS_ERROR_IF_NOT(r_item == "Properties" || r_item == "Elements" || r_item == "Conditions" || r_item == "SubModelParts"
+                            || KratosComponents<Element>::Has(r_item) || KratosComponents<Condition>::Has(r_item))
+            << "'" << r_item << "' is neither a part of the mesh nor a registered element or condition\n";
+    }
+    if (IsSelected(r_selection, "SubModelParts")) {
+        for (const auto& r_name : rSettings.mSubModelParts) {
+            KRATOS_ERROR_IF_NOT(reader.Has(GetSubModelPartPath(r_name)))
+                << "no sub model part '" << r_name << "' in " << rFilePath << "\n";
+        }
+    }
+
+    // Properties
+    if (IsSelected(r_selection, "Properties")) {
+        for (auto id : ReadIds(reader, "Properties/Ids", rDataCommunicator, nullptr, [](auto){return true;})) {
+            if (!rTarget.HasProperties(id)) rTarget.CreateNewProperties(id);
+        }
+    }
+
+    // This rank's share of elements and conditions
+    const auto element_groups = ReadEntityGroups<Element>(reader, "Elements", r_selection, rank, rank_count);
+    const auto condition_groups = ReadEntityGroups<Condition>(reader, "Conditions", r_selection, rank, rank_count);
+
+    // Nodes: this rank's share, and the ones referenced by its elements and conditions.
+    const std::size_t node_count = reader.Shape("Nodes/Ids").first;
+    const auto node_shares = MakeShares(node_count, rank_count);
+    auto owned_ids = reader.Read<std::uint64_t>("Nodes/Ids", node_shares[rank], node_shares[rank + 1] - node_shares[rank]);
+    auto owned_coordinates = reader.Read<double>("Nodes/Coordinates", node_shares[rank], owned_ids.size());
+
+    // (ID, position in the share) sorted by ID.
+    std::vector<std::pair<std::uint64_t,std::size_t>> owned_index(owned_ids.size());
+    for (std::size_t i_node=0; i_node<owned_ids.size(); ++i_node) owned_index[i_node] = {owned_ids[i_node], i_node};
+    std::sort(owned_index.begin(), owned_index.end());
+    const auto find_owned = [&owned_index](std::uint64_t Id) {
+        const auto it = std::lower_bound(owned_index.begin(), owned_index.end(), std::make_pair(Id, std::size_t(0)));
+        return (it != owned_index.end() && it->first == Id) ? it : owned_index.end();
+    };
+
+    std::vector<std::uint64_t> referenced_ids;
+    for (const auto* p_groups : {&element_groups, &condition_groups}) {
+        for (const auto& r_group : *p_groups) {
+            referenced_ids.insert(referenced_ids.end(), r_group.mConnectivities.begin(), r_group.mConnectivities.end());
+        }
+    }
+    std::sort(referenced_ids.begin(), referenced_ids.end());
+    referenced_ids.erase(std::unique(referenced_ids.begin(), referenced_ids.end()), referenced_ids.end());
+    referenced_ids.erase(std::remove_if(referenced_ids.begin(),
+                                        referenced_ids.end(),
+                                        [&](std::uint64_t Id){return find_owned(Id) != owned_index.end();}),
+                         referenced_ids.end());
+
+    // Request referenced nodes outside this rank's share from the ranks whose share
+    // spans their IDs, which answer with the coordinates of the ones they own.
+    std::vector<std::vector<std::uint64_t>> answer_ids(rank_count);
+    std::vector<std::vector<double>> answer_coordinates(rank_count);
+    {
+        const IdRanges share_ranges(rDataCommunicator, owned_ids.begin(), owned_ids.end(), [](auto Id){return Id;});
+        const auto requests = Exchange(rDataCommunicator, share_ranges.Route(referenced_ids, rank_count));
+        for (int i_rank=0; i_rank<rank_count; ++i_rank) {
+            for (auto id : requests[i_rank]) {
+                const auto it = find_owned(id);
+                if (it == owned_index.end()) continue;
+                answer_ids[i_rank].push_back(id);
+                const double* p_coordinates = owned_coordinates.data() + 3 * it->second;
+                answer_coordinates[i_rank].insert(answer_coordinates[i_rank].end(), p_coordinates, p_coordinates + 3);
+            }
+        }
+    }
+    const auto ghost_ids = Exchange(rDataCommunicator, answer_ids);
+    const auto ghost_coordinates = Exchange(rDataCommunicator, answer_coordinates);
+
+    // (ID, owner rank, coordinates) of each ghost node.
+    std::vector<std::tuple<std::uint64_t,int,const double*>> ghosts;
+    for (int i_rank=0; i_rank<rank_count; ++i_rank) {
+        for (std::size_t i_ghost=0; i_ghost<ghost_ids[i_rank].size(); ++i_ghost) {
+            ghosts.emplace_back(ghost_ids[i_rank][i_ghost], i_rank, ghost_coordinates[i_rank].data() + 3 * i_ghost);
+        }
+    }
+    KRATOS_ERROR_IF(ghosts.size() != referenced_ids.size())
+        << "found " << ghosts.size() << " of the " << referenced_ids.size()
+        << " nodes referenced by elements and conditions outside this rank's share in " << rFilePath << "\n";
+
+    const std::size_t owned_count = owned_ids.size();
+    std::vector<ModelPart::NodeType::Pointer> nodes(owned_count + ghosts.size());
+    const auto p_variables = rTarget.pGetNodalSolutionStepVariablesList();
+    const auto buffer_size = rTarget.GetBufferSize();
+    const bool has_partition_index = rTarget.HasNodalSolutionStepVariable(PARTITION_INDEX);
+    IndexPartition<std::size_t>(nodes.size()).for_each([&](std::size_t i_node) {
+        const bool is_owned = i_node < owned_count;
+        const std::uint64_t id = is_owned ? owned_ids[i_node] : std::get<0>(ghosts[i_node - owned_count]);
+        const double* p_coordinates = is_owned ? owned_coordinates.data() + 3 * i_node : std::get<2>(ghosts[i_node - owned_count]);
+        const std::array<double,3> coordinates {p_coordinates[0], p_coordinates[1], p_coordinates[2]};
+        auto p_node = Detail::MakeNode(id, coordinates, coordinates, p_variables, buffer_size);
+        if (has_partition_index) {
+            // Nodes belong to the rank whose share they are in.
+            p_node->FastGetSolutionStepValue(PARTITION_INDEX) = is_owned ? rank : std::get<1>(ghosts[i_node - owned_count]);
+        }
+        nodes[i_node] = std::move(p_node);
+    });
+
+    {
+        ModelPart::NodesContainerType container;
+        container.reserve(nodes.size());
+        for (const auto& rp_node : nodes) container.push_back(rp_node);
+        rTarget.AddNodes(container.begin(), container.end());
+    }
+
+    // Elements and conditions
+    {
+        const auto elements = MakeEntities<Element>(element_groups, rTarget);
+        ModelPart::ElementsContainerType container;
+        container.reserve(elements.size());
+        for (const auto& rp_element : elements) container.push_back(rp_element);
+        rTarget.AddElements(container.begin(), container.end());
+    }
+
+    {
+        const auto conditions = MakeEntities<Condition>(condition_groups, rTarget);
+        ModelPart::ConditionsContainerType container;
+        container.reserve(conditions.size());
+        for (const auto& rp_condition : conditions) container.push_back(rp_condition);
+        rTarget.AddConditions(container.begin(), container.end());
+    }
+
+    if (IsSelected(r_selection, "SubModelParts")) {
+        const auto get_id = [](const auto& rEntity) -> std::uint64_t {return rEntity.Id();};
+        const LocalRanges ranges {
+            IdRanges(rDataCommunicator, rTarget.NodesBegin(), rTarget.NodesEnd(), get_id),
+            IdRanges(rDataCommunicator, rTarget.ElementsBegin(), rTarget.ElementsEnd(), get_id),
+            IdRanges(rDataCommunicator, rTarget.ConditionsBegin(), rTarget.ConditionsEnd(), get_id)
+        };
+        ReadSubModelParts(reader, rTarget, "", rDataCommunicator, ranges, rSettings);
+    }
+    KRATOS_CATCH("")
+}
+
+
+} // namespace Kratos::UtilityApp
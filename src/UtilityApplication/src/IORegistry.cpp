@@ -0,0 +1,307 @@
+/// @author Máté Kelemen
+
+// --- HDF5 Includes ---
+#include <hdf5.h>
+
+// --- Core Includes ---
+#include "includes/define.h"
+#include "input_output/logger.h"
+
+// --- Utility Includes ---
+#include "UtilityApp/IORegistry.hpp"
+
+// --- STL Includes ---
+#include <fstream> // ifstream
+#include <algorithm> // transform, find, find_if, remove_if, equal
+#include <array> // array
+#include <cctype> // tolower, isspace
+#include <string_view> // string_view
+#include <optional> // optional
+
+
+namespace Kratos::UtilityApp {
+
+
+namespace {
+
+
+std::string ToLower(std::string String)
+{
+    std::transform(String.begin(),
+                   String.end(),
+                   String.begin(),
+                   [](unsigned char item){return std::tolower(item);});
+    return String;
+}
+
+
+/// @brief Check for the HDF5 signature at the offsets the superblock may be at (after a user block).
+bool HasHDF5Signature(std::span<const char> Head)
+{
+    constexpr std::string_view signature("\x89HDF\r\n\x1a\n", 8);
+    for (std::size_t offset : {0, 512, 1024, 2048}) {
+        if (Head.size() < offset + signature.size()) break;
+        if (std::equal(signature.begin(), signature.end(), Head.begin() + offset)) return true;
+    }
+    return false;
+}
+
+
+/// @brief Check whether an HDF5 file has the group MED files are identified by.
+bool HasMEDGroup(const std::filesystem::path& rFilePath)
+{
+    bool output = false;
+    H5E_BEGIN_TRY {
+        const hid_t file = H5Fopen(rFilePath.string().c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        if (0 <= file) {
+            output = 0 < H5Lexists(file, "INFOS_GENERALES", H5P_DEFAULT);
+            H5Fclose(file);
+        }
+    } H5E_END_TRY;
+    return output;
+}
+
+
+std::optional<bool> IsMDPA(const std::filesystem::path&, std::span<const char> Head)
+{
+    // Skip whitespace and comments. Heads without anything else (files starting with more
+    // comments than the head can hold) are inconclusive, and left to the extension.
+    const std::string_view head(Head.data(), Head.size());
+    std::size_t position = 0;
+    while (position < head.size()) {
+        if (std::isspace(static_cast<unsigned char>(head[position]))) {
+            ++position;
+        } else if (head.substr(position, 2) == "//") {
+            position = head.find('\n', position);
+        } else {
+            break;
+        }
+    }
+    if (head.size() <= position) return {};
+
+    constexpr std::string_view token = "Begin";
+    return head.substr(position, token.size()) == token
+           && (head.size() == position + token.size() || std::isspace(static_cast<unsigned char>(head[position + token.size()])));
+}
+
+
+bool IsMED(const std::filesystem::path& rFilePath, std::span<const char> Head)
+{
+    return HasHDF5Signature(Head) && HasMEDGroup(rFilePath);
+}
+
+
+bool IsHDF5(const std::filesystem::path& rFilePath, std::span<const char> Head)
+{
+    return HasHDF5Signature(Head) && !HasMEDGroup(rFilePath);
+}
+
+
+bool IsMDPB(const std::filesystem::path&, std::span<const char> Head)
+{
+    constexpr std::string_view magic = "KRATMDPB";
+    return magic.size() <= Head.size() && std::equal(magic.begin(), magic.end(), Head.begin());
+}
+
+
+/// @brief Format whose extensions include the one of @p rFilePath.
+template <class TIterator>
+TIterator FindByExtension(TIterator itBegin, TIterator itEnd, const std::filesystem::path& rFilePath)
+{
+    const std::string extension = ToLower(rFilePath.extension().string());
+    return std::find_if(itBegin, itEnd, [&extension](const IORegistry::Format& r_format){
+        return std::find(r_format.mExtensions.begin(), r_format.mExtensions.end(), extension) != r_format.mExtensions.end();
+    });
+}
+
+
+/// @brief IO that identifies files by their contents when reading, and writes with the format of their extension.
+class DeferredModelPartIO final : public ModelPartIO
+{
+public:
+    DeferredModelPartIO(const IORegistry& rRegistry,
+                        RightRef<std::filesystem::path> rFilePath,
+                        RightRef<std::optional<IORegistry::Format>> rMaybeWriteFormat)
+        : mrRegistry(rRegistry),
+          mFilePath(std::move(rFilePath)),
+          mMaybeWriteFormat(std::move(rMaybeWriteFormat))
+    {
+    }
+
+    void Read(Ref<ModelPart> rTarget) const override
+    {
+        // The file may have been (re)written since the last read, so it's sniffed every time.
+        mrRegistry.Find(mFilePath, IORegistry::Access::Read).mFactory(mFilePath)->Read(rTarget);
+    }
+
+    void Write(Ref<const ModelPart> rSource) override
+    {
+        // Whatever is at the path gets overwritten, so its contents are irrelevant.
+        if (!mpWriter) {
+            KRATOS_ERROR_IF_NOT(mMaybeWriteFormat)
+                << "cannot write " << mFilePath << ": no format has the extension " << mFilePath.extension() << "\n";
+            mpWriter = mMaybeWriteFormat->mFactory(mFilePath);
+        }
+        mpWriter->Write(rSource);
+    }
+
+private:
+    const IORegistry& mrRegistry;
+
+    std::filesystem::path mFilePath;
+
+    std::optional<IORegistry::Format> mMaybeWriteFormat;
+
+    std::unique_ptr<ModelPartIO> mpWriter;
+}; // class DeferredModelPartIO
+
+
+} // unnamed namespace
+
+
+IORegistry::IORegistry()
+{
+    this->Register({"mdpa", {".mdpa"}, IsMDPA, [](const std::filesystem::path& rFilePath) {
+        // MDPAModelPartIO takes the path without the extension, except for misnamed files.
+        std::filesystem::path path = rFilePath;
+        if (ToLower(path.extension().string()) == ".mdpa") path.replace_extension("");
+        return std::unique_ptr<ModelPartIO>(new MDPAModelPartIO(std::move(path)));
+    }});
+
+    this->Register({"med", {".med"}, IsMED, [](const std::filesystem::path& rFilePath) {
+        return std::unique_ptr<ModelPartIO>(new MedModelPartIO(std::filesystem::path(rFilePath)));
+    }});
+
+    this->Register({"hdf5", {".h5", ".hdf5"}, IsHDF5, [](const std::filesystem::path& rFilePath) {
+        return std::unique_ptr<ModelPartIO>(new HDF5ModelPartIO(std::filesystem::path(rFilePath)));
+    }});
+
+    this->Register({"mdpb", {".mdpb"}, IsMDPB, [](const std::filesystem::path& rFilePath) {
+        return std::unique_ptr<ModelPartIO>(new BinaryModelPartIO(std::filesystem::path(rFilePath)));
+    }});
+}
+
+
+IORegistry& IORegistry::Get()
+{
+    static IORegistry registry;
+    return registry;
+}
+
+
+void IORegistry::Register(Format NewFormat)
+{
+    KRATOS_ERROR_IF(NewFormat.mName.empty()) << "formats must have a name\n";
+    KRATOS_ERROR_IF_NOT(NewFormat.mFactory) << "format '" << NewFormat.mName << "' has no factory\n";
+    for (auto& r_extension : NewFormat.mExtensions) r_extension = ToLower(r_extension);
+
+    std::scoped_lock lock(mMutex);
+    const auto it_format = std::find_if(mFormats.begin(), mFormats.end(), [&NewFormat](const Format& r_format){
+        return r_format.mName == NewFormat.mName;
+    });
+    if (it_format == mFormats.end()) {
+        mFormats.push_back(std::move(NewFormat));
+    } else {
+        *it_format = std::move(NewFormat);
+    }
+}
+
+
+void IORegistry::Unregister(const std::string& rName)
+{
+    std::scoped_lock lock(mMutex);
+    mFormats.erase(std::remove_if(mFormats.begin(), mFormats.end(), [&rName](const Format& r_format){
+                       return r_format.mName == rName;
+                   }),
+                   mFormats.end());
+}
+
+
+std::vector<std::string> IORegistry::GetNames() const
+{
+    std::scoped_lock lock(mMutex);
+    std::vector<std::string> names;
+    for (const auto& r_format : mFormats) names.push_back(r_format.mName);
+    return names;
+}
+
+
+std::string IORegistry::Detect(const std::filesystem::path& rFilePath, Access Mode) const
+{
+    return this->Find(rFilePath, Mode).mName;
+}
+
+
+std::unique_ptr<ModelPartIO> IORegistry::Create(const std::filesystem::path& rFilePath) const
+{
+    KRATOS_TRY
+
+    // The format of the extension is resolved right away, so unsupported targets are reported
+    // before the caller gets to do any work. Only sniffing waits until the file is read.
+    std::optional<Format> maybe_write_format;
+    {
+        std::scoped_lock lock(mMutex);
+        const auto it_format = FindByExtension(mFormats.begin(), mFormats.end(), rFilePath);
+        if (it_format != mFormats.end()) maybe_write_format = *it_format;
+    }
+
+    KRATOS_ERROR_IF(!maybe_write_format && !std::filesystem::is_regular_file(rFilePath))
+        << "Unsupported file format: " << rFilePath.extension();
+
+    return std::unique_ptr<ModelPartIO>(new DeferredModelPartIO(*this,
+                                                                std::filesystem::path(rFilePath),
+                                                                std::move(maybe_write_format)));
+
+    KRATOS_CATCH("")
+}
+
+
+IORegistry::Format IORegistry::Find(const std::filesystem::path& rFilePath, Access Mode) const
+{
+    KRATOS_TRY
+
+    // Sniffers and factories may call into Python, so they're invoked on a copy outside the lock.
+    std::vector<Format> formats;
+    {
+        std::scoped_lock lock(mMutex);
+        formats = mFormats;
+    }
+
+    const auto it_by_extension = FindByExtension(formats.begin(), formats.end(), rFilePath);
+
+    std::vector<char> head;
+    if (Mode == Access::Read && std::filesystem::is_regular_file(rFilePath)) {
+        std::ifstream file(rFilePath, std::ios::binary);
+        KRATOS_ERROR_IF_NOT(file) << "cannot open " << rFilePath << "\n";
+        head.resize(SniffSize);
+        file.read(head.data(), head.size());
+        head.resize(file.gcount());
+    }
+
+    if (!head.empty()) {
+        // Heads the sniffer of the extension can't decide on are left to the extension.
+        std::optional<bool> maybe_extension_verdict;
+        if (it_by_extension != formats.end() && it_by_extension->mSniffer) {
+            maybe_extension_verdict = it_by_extension->mSniffer(rFilePath, head);
+            if (maybe_extension_verdict.value_or(true)) return *it_by_extension;
+        }
+
+        for (auto it_format=formats.rbegin(); it_format!=formats.rend(); ++it_format) {
+            if (it_format->mSniffer && it_format->mSniffer(rFilePath, head).value_or(false)) {
+                KRATOS_WARNING("IOFactory") << rFilePath << " is read as '" << it_format->mName << "' despite its extension\n";
+                return *it_format;
+            }
+        }
+
+        KRATOS_ERROR_IF(maybe_extension_verdict.has_value())
+            << rFilePath << " does not look like a '" << it_by_extension->mName << "' file\n";
+    }
+
+    KRATOS_ERROR_IF(it_by_extension == formats.end()) << "Unsupported file format: " << rFilePath.extension();
+    return *it_by_extension;
+
+    KRATOS_CATCH("")
+}
+
+
+} // namespace Kratos::UtilityApp
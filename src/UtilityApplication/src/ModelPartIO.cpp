@@ -2,9 +2,14 @@
 
 // --- Core Includes ---
 #include "includes/model_part_io.h"
+#include "includes/parallel_environment.h"
 
 // --- Utiltiy Includes ---
 #include "UtilityApp/ModelPartIO.hpp"
+#include "UtilityApp/IORegistry.hpp"
+#include "UtilityApp/ParallelMDPA.hpp"
+#include "UtilityApp/CollectiveHDF5.hpp"
+#include "UtilityApp/StreamingMED.hpp"
 
 // --- MED Includes ---
 #include "custom_io/med_model_part_io.h"
@@ -44,12 +49,29 @@ MDPAModelPartIO::~MDPAModelPartIO()
 
 void MDPAModelPartIO::Read(Ref<ModelPart> rTarget) const
 {
+    // The parallel reader leaves the model part untouched if the file has
+    // anything it doesn't support, in which case the core reader takes over.
+    auto file_path = mpImpl->mFilePath;
+    file_path += ".mdpa";
+
+    // Misnamed files detected by IOFactory are passed with their full name,
+    // which only the parallel reader can deal with.
+    if (!std::filesystem::exists(file_path) && std::filesystem::is_regular_file(mpImpl->mFilePath)) {
+        KRATOS_ERROR_IF_NOT(ReadMDPA(mpImpl->mFilePath, rTarget))
+            << mpImpl->mFilePath << " has contents only the core reader supports, which requires the *.mdpa extension\n";
+        return;
+    }
+
+    if (ReadMDPA(file_path, rTarget)) return;
     Kratos::ModelPartIO(mpImpl->mFilePath, IO::READ).ReadModelPart(rTarget);
 }
 
 
 void MDPAModelPartIO::Write(Ref<const ModelPart> rSource)
 {
+    auto file_path = mpImpl->mFilePath;
+    file_path += ".mdpa";
+    if (WriteMDPA(file_path, rSource)) return;
     Ref<ModelPart> omfg = const_cast<Ref<ModelPart>>(rSource);
     Kratos::ModelPartIO(mpImpl->mFilePath, IO::WRITE | IO::SCIENTIFIC_PRECISION).WriteModelPart(omfg);
 }
@@ -85,13 +107,64 @@ void MedModelPartIO::Read(Ref<ModelPart> rTarget) const
 
 void MedModelPartIO::Write(Ref<const ModelPart> rSource)
 {
+    if (WriteMED(mpImpl->mFilePath, rSource)) return;
     Ref<ModelPart> omfg = const_cast<Ref<ModelPart>>(rSource);
-    Kratos::ModelPartIO(mpImpl->mFilePath, IO::WRITE).WriteModelPart(omfg);
+    Kratos::MedModelPartIO(mpImpl->mFilePath, IO::WRITE).WriteModelPart(omfg);
 }
 
 
 struct HDF5ModelPartIO::Impl {
+    static Parameters GetDefaultSettings()
+    {
+        return Parameters(R"({
+            "prefix" : "/ModelData",
+            "collective" : false,
+            "data_communicator" : "",
+            "chunk_size" : 1048576,
+            "filter" : "deflate",
+            "compression_level" : 0,
+            "entity_types" : [],
+            "sub_model_parts" : []
+        })");
+    }
+
+    static HDF5Filter GetFilter(const std::string& rName)
+    {
+        if (rName == "none") return HDF5Filter::None;
+        else if (rName == "deflate") return HDF5Filter::Deflate;
+        else if (rName == "zstd") return HDF5Filter::Zstd;
+        else if (rName == "szip") return HDF5Filter::Szip;
+        KRATOS_ERROR << "unknown HDF5 filter '" << rName << "' (expecting 'none', 'deflate', 'zstd' or 'szip')\n";
+    }
+
+    const DataCommunicator& GetDataCommunicator(Ref<const ModelPart> rModelPart) const
+    {
+        const std::string name = mSettings["data_communicator"].GetString();
+        return name.empty() ? rModelPart.GetCommunicator().GetDataCommunicator() : ParallelEnvironment::GetDataCommunicator(name);
+    }
+
+    CollectiveHDF5Settings GetCollectiveSettings() const
+    {
+        CollectiveHDF5Settings settings;
+        settings.mPrefix = mSettings["prefix"].GetString();
+        settings.mChunkSize = mSettings["chunk_size"].GetInt();
+        settings.mFilter = GetFilter(mSettings["filter"].GetString());
+        settings.mCompressionLevel = mSettings["compression_level"].GetInt();
+        settings.mEntityTypes = mSettings["entity_types"].GetStringArray();
+        settings.mSubModelParts = mSettings["sub_model_parts"].GetStringArray();
+        return settings;
+    }
+
+    Parameters GetIOParameters() const
+    {
+        Parameters parameters;
+        parameters.AddValue("prefix", mSettings["prefix"]);
+        return parameters;
+    }
+
     std::filesystem::path mFilePath;
+
+    Parameters mSettings = GetDefaultSettings();
 }; // HDF5ModelPartIO::Impl
 
 
@@ -112,58 +185,89 @@ HDF5ModelPartIO::HDF5ModelPartIO(RightRef<std::filesystem::path> rFilePath)
 }
 
 
+HDF5ModelPartIO::HDF5ModelPartIO(RightRef<std::filesystem::path> rFilePath, Parameters Settings)
+    : HDF5ModelPartIO(std::move(rFilePath))
+{
+    KRATOS_TRY
+    Settings.ValidateAndAssignDefaults(Impl::GetDefaultSettings());
+    KRATOS_ERROR_IF(Settings["chunk_size"].GetInt() < 1)
+        << "invalid chunk size " << Settings["chunk_size"].GetInt() << "\n";
+
+    const int level = Settings["compression_level"].GetInt();
+    switch (Impl::GetFilter(Settings["filter"].GetString())) {
+        case HDF5Filter::None:
+            break;
+        case HDF5Filter::Deflate:
+            KRATOS_ERROR_IF(level < 0 || 9 < level) << "invalid deflate level " << level << " (expecting 0-9)\n";
+            break;
+        case HDF5Filter::Zstd:
+            KRATOS_ERROR_IF(level < 0 || 22 < level) << "invalid zstd level " << level << " (expecting 0-22)\n";
+            break;
+        case HDF5Filter::Szip:
+            KRATOS_ERROR_IF(level < 0 || 32 < level || level % 2) << "invalid szip pixels per block " << level << " (expecting an even number in 0-32)\n";
+            break;
+    }
+
+    // The HDF5 application's layout can only be read as a whole.
+    KRATOS_ERROR_IF(!Settings["collective"].GetBool() && (Settings["entity_types"].size() || Settings["sub_model_parts"].size()))
+        << "selective loading requires \"collective\" : true\n";
+    mpImpl->mSettings = Settings;
+    KRATOS_CATCH("")
+}
+
+
 void HDF5ModelPartIO::Read(Ref<ModelPart> rTarget) const
 {
+    if (mpImpl->mSettings["collective"].GetBool()) {
+        ReadCollectiveHDF5(mpImpl->mFilePath,
+                           rTarget,
+                           mpImpl->GetDataCommunicator(rTarget),
+                           mpImpl->GetCollectiveSettings());
+        return;
+    }
+
     Kratos::Parameters file_parameters(R"({
         "file_name" : "",
         "file_access_mode" : "read_only"
     })");
     file_parameters["file_name"].SetString(mpImpl->mFilePath.string());
     Kratos::HDF5::File::Pointer p_file(new Kratos::HDF5::File(
-        rTarget.GetCommunicator().GetDataCommunicator(),
+        mpImpl->GetDataCommunicator(rTarget),
         file_parameters));
     Kratos::HDF5::ModelPartIO(
-        Parameters(R"("prefix" : "/ModelData")"),
+        mpImpl->GetIOParameters(),
         p_file).ReadModelPart(rTarget);
 }
 
 
 void HDF5ModelPartIO::Write(Ref<const ModelPart> rSource)
 {
+    if (mpImpl->mSettings["collective"].GetBool()) {
+        WriteCollectiveHDF5(mpImpl->mFilePath,
+                            rSource,
+                            mpImpl->GetDataCommunicator(rSource),
+                            mpImpl->GetCollectiveSettings());
+        return;
+    }
+
     Kratos::Parameters file_parameters(R"({
         "file_name" : "",
         "file_access_mode" : "exclusive"
     })");
     file_parameters["file_name"].SetString(mpImpl->mFilePath.string());
     Kratos::HDF5::File::Pointer p_file(new Kratos::HDF5::File(
-        rSource.GetCommunicator().GetDataCommunicator(),
+        mpImpl->GetDataCommunicator(rSource),
         file_parameters));
     Ref<ModelPart> omfg = const_cast<Ref<ModelPart>>(rSource);
     Kratos::HDF5::ModelPartIO(
-        Parameters(R"("prefix" : "/ModelData")"),
+        mpImpl->GetIOParameters(),
         p_file).WriteModelPart(omfg);
 }
 
 
 std::unique_ptr<Kratos::UtilityApp::ModelPartIO> IOFactory(const std::filesystem::path& rFilePath)
 {
-    std::string suffix = rFilePath.extension().string();
-    std::transform(suffix.begin(),
-                   suffix.end(),
-                   suffix.begin(),
-                   [](auto item){return std::tolower(item);});
-
-    using IOPtr = std::unique_ptr<Kratos::UtilityApp::ModelPartIO>;
-    if (suffix == ".mdpa") {
-        std::filesystem::path path = rFilePath;
-        path.replace_extension("");
-        return IOPtr(new Kratos::UtilityApp::MDPAModelPartIO(std::move(path)));
-    } else if (suffix == ".med") {
-        return IOPtr(new Kratos::UtilityApp::MedModelPartIO(std::filesystem::path(rFilePath)));
-    } else if (suffix == ".h5" || suffix == ".hdf5") {
-        return IOPtr(new Kratos::UtilityApp::HDF5ModelPartIO(std::filesystem::path(rFilePath)));
-    }
-    KRATOS_ERROR << "Unsupported file format: " << rFilePath.extension();
+    return IORegistry::Get().Create(rFilePath);
 }
 
 
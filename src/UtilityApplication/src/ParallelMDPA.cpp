@@ -0,0 +1,805 @@
+/// @author Máté Kelemen
+
+// --- Core Includes ---
+#include "containers/model.h"
+#include "includes/model_part.h"
+#include "includes/model_part_io.h"
+#include "includes/kratos_components.h"
+#include "utilities/parallel_utilities.h"
+#include "utilities/reduction_utilities.h"
+
+// --- Utility Includes ---
+#include "UtilityApp/ParallelMDPA.hpp"
+#include "UtilityApp/MappedFile.hpp"
+#include "EntityConstruction.hpp"
+
+// --- STL Includes ---
+#include <string_view> // string_view
+#include <string> // string
+#include <vector> // vector
+#include <optional> // optional
+#include <charconv> // from_chars, to_chars, chars_format
+#include <array> // array
+#include <fstream> // ofstream
+#include <sstream> // stringstream
+#include <memory> // make_shared
+#include <algorithm> // sort, unique, binary_search, min
+#include <cstring> // memchr
+#include <type_traits> // is_same_v
+
+
+namespace Kratos::UtilityApp {
+
+
+namespace {
+
+
+using Text = std::string_view;
+
+
+/// @brief Approximate number of bytes parsed by a single task.
+constexpr std::size_t ChunkSize = std::size_t(1) << 20;
+
+
+bool IsSpace(char Character) noexcept
+{
+    return Character == ' ' || Character == '\t' || Character == '\r' || Character == '\n' || Character == '\v' || Character == '\f';
+}
+
+
+Text StripComment(Text Line) noexcept
+{
+    const auto position = Line.find("//");
+    return position == Text::npos ? Line : Line.substr(0, position);
+}
+
+
+std::vector<Text> SplitWords(Text Line)
+{
+    std::vector<Text> words;
+    std::size_t begin = 0;
+    while (true) {
+        while (begin < Line.size() && IsSpace(Line[begin])) ++begin;
+        if (begin == Line.size()) break;
+        std::size_t end = begin;
+        while (end < Line.size() && !IsSpace(Line[end])) ++end;
+        words.push_back(Line.substr(begin, end - begin));
+        begin = end;
+    }
+    return words;
+}
+
+
+/// @brief Split text at line boundaries into pieces of roughly @ref ChunkSize bytes.
+std::vector<Text> SplitLines(Text Content)
+{
+    std::vector<Text> chunks;
+    while (!Content.empty()) {
+        std::size_t end = std::min(ChunkSize, Content.size());
+        if (end < Content.size()) {
+            const auto line_end = Content.find('\n', end);
+            end = line_end == Text::npos ? Content.size() : line_end + 1;
+        }
+        chunks.push_back(Content.substr(0, end));
+        Content.remove_prefix(end);
+    }
+    return chunks;
+}
+
+
+/// @brief Check whether the text consists of whitespace and comments only.
+bool IsBlank(Text Content)
+{
+    while (!Content.empty()) {
+        const auto line_end = std::min(Content.find('\n'), Content.size());
+        for (char character : StripComment(Content.substr(0, line_end))) {
+            if (!IsSpace(character)) return false;
+        }
+        Content.remove_prefix(std::min(line_end + 1, Content.size()));
+    }
+    return true;
+}
+
+
+/// @brief A "Begin ..." or "End ..." line.
+struct Marker
+{
+    bool mIsBegin;
+
+    Text mLine;
+}; // struct Marker
+
+
+/// @brief Collect block markers in the order they appear in the file, scanning chunks in parallel.
+std::vector<Marker> FindMarkers(Text File)
+{
+    const std::size_t chunk_count = (File.size() + ChunkSize - 1) / ChunkSize;
+    std::vector<std::vector<Marker>> chunk_markers(chunk_count);
+
+    IndexPartition<std::size_t>(chunk_count).for_each([&](std::size_t i_chunk) {
+        // Each chunk handles the lines beginning within it.
+        std::size_t begin = i_chunk * ChunkSize;
+        const std::size_t end = std::min(File.size(), begin + ChunkSize);
+        if (begin && File[begin - 1] != '\n') {
+            const auto line_end = File.find('\n', begin);
+            begin = line_end == Text::npos ? File.size() : line_end + 1;
+        }
+
+        while (begin < end) {
+            const auto line_end = std::min(File.find('\n', begin), File.size());
+            Text line = File.substr(begin, line_end - begin);
+            std::size_t i_first = 0;
+            while (i_first < line.size() && IsSpace(line[i_first])) ++i_first;
+            line.remove_prefix(i_first);
+
+            for (const auto [keyword, is_begin] : {std::pair<Text,bool>("Begin", true), std::pair<Text,bool>("End", false)}) {
+                if (line.substr(0, keyword.size()) == keyword && (line.size() == keyword.size() || IsSpace(line[keyword.size()]))) {
+                    chunk_markers[i_chunk].push_back(Marker {is_begin, line});
+                }
+            }
+            begin = line_end + 1;
+        }
+    });
+
+    std::vector<Marker> markers;
+    for (const auto& r_chunk : chunk_markers) markers.insert(markers.end(), r_chunk.begin(), r_chunk.end());
+    return markers;
+}
+
+
+/// @brief A "Begin <type> [arguments]" ... "End <type>" block and its parsed contents.
+struct Block
+{
+    /// @brief Words of the "Begin" line after "Begin": the block's type followed by its arguments.
+    std::vector<std::string> mWords;
+
+    /// @brief Everything between the "Begin" and "End" lines, including nested blocks.
+    Text mContent;
+
+    std::vector<std::size_t> mChildren;
+
+    /// @brief Number of integers at the beginning of each line, or 0 for any number of integers and no reals.
+    std::size_t mIntegersPerLine = 0;
+
+    std::size_t mRealsPerLine = 0;
+
+    bool mHasData = false;
+
+    std::vector<std::size_t> mIntegers;
+
+    std::vector<double> mReals;
+
+    const std::string& Type() const {return mWords.front();}
+}; // struct Block
+
+
+/// @brief Assemble the block tree from the markers, the first block being the file itself.
+std::optional<std::vector<Block>> MakeBlocks(Text File, const std::vector<Marker>& rMarkers)
+{
+    std::vector<Block> blocks(1);
+    blocks.front().mWords.emplace_back();
+    blocks.front().mContent = File;
+    std::vector<std::size_t> stack {0};
+
+    for (const Marker& r_marker : rMarkers) {
+        const auto words = SplitWords(StripComment(r_marker.mLine));
+        if (words.size() < 2) return {};
+        const char* p_line_end = r_marker.mLine.data() + r_marker.mLine.size();
+
+        if (r_marker.mIsBegin) {
+            Block block;
+            for (auto it_word=words.begin()+1; it_word!=words.end(); ++it_word) block.mWords.emplace_back(*it_word);
+            const char* p_content = p_line_end + (p_line_end < File.data() + File.size());
+            block.mContent = Text(p_content, 0);
+            blocks[stack.back()].mChildren.push_back(blocks.size());
+            stack.push_back(blocks.size());
+            blocks.push_back(std::move(block));
+        } else {
+            if (stack.size() == 1) return {};
+            Block& r_block = blocks[stack.back()];
+            if (words[1] != r_block.Type()) return {};
+
+            // The "End" line starts with whitespace at most.
+            const char* p_content_end = r_marker.mLine.data();
+            while (File.data() < p_content_end && p_content_end[-1] != '\n') --p_content_end;
+            if (p_content_end < r_block.mContent.data()) return {};
+            r_block.mContent = Text(r_block.mContent.data(), p_content_end - r_block.mContent.data());
+            stack.pop_back();
+        }
+    }
+
+    if (stack.size() != 1) return {};
+    return blocks;
+}
+
+
+template <class TEntity>
+std::optional<std::size_t> GetNodesPerEntity(const std::string& rName)
+{
+    if (!KratosComponents<TEntity>::Has(rName)) return {};
+    if constexpr (std::is_same_v<TEntity,ModelPart::GeometryType>) {
+        return KratosComponents<TEntity>::Get(rName).PointsNumber();
+    } else {
+        return KratosComponents<TEntity>::Get(rName).GetGeometry().size();
+    }
+}
+
+
+/// @brief Set the line layout of supported blocks and check that no other blocks are present.
+bool ConfigureBlocks(Ref<std::vector<Block>> rBlocks, std::size_t iParent, bool IsSubModelPart)
+{
+    for (std::size_t i_block : rBlocks[iParent].mChildren) {
+        Block& r_block = rBlocks[i_block];
+        const std::string& r_type = r_block.Type();
+        const std::size_t argument_count = r_block.mWords.size() - 1;
+
+        if (r_type == "SubModelPart") {
+            if (argument_count != 1 || !ConfigureBlocks(rBlocks, i_block, true)) return false;
+            continue;
+        }
+
+        if (!r_block.mChildren.empty()) return false;
+
+        if (!IsSubModelPart) {
+            if (r_type == "ModelPartData") {
+                if (argument_count || !IsBlank(r_block.mContent)) return false;
+            } else if (r_type == "Properties") {
+                std::size_t id;
+                const auto& r_id = r_block.mWords[1];
+                if (argument_count != 1
+                    || std::from_chars(r_id.data(), r_id.data() + r_id.size(), id).ptr != r_id.data() + r_id.size()
+                    || !IsBlank(r_block.mContent)) return false;
+                r_block.mIntegers.push_back(id);
+            } else if (r_type == "Nodes") {
+                if (argument_count) return false;
+                r_block.mIntegersPerLine = 1;
+                r_block.mRealsPerLine = 3;
+                r_block.mHasData = true;
+            } else if (r_type == "Geometries" || r_type == "Elements" || r_type == "Conditions") {
+                if (argument_count != 1) return false;
+                const std::string& r_name = r_block.mWords[1];
+                const auto nodes_per_entity = r_type == "Geometries" ? GetNodesPerEntity<ModelPart::GeometryType>(r_name)
+                                            : r_type == "Elements" ? GetNodesPerEntity<Element>(r_name)
+                                            : GetNodesPerEntity<Condition>(r_name);
+                if (!nodes_per_entity.has_value()) return false;
+                r_block.mIntegersPerLine = (r_type == "Geometries" ? 1 : 2) + nodes_per_entity.value();
+                r_block.mHasData = true;
+            } else {
+                return false;
+            }
+        } else {
+            if (r_type == "SubModelPartData" || r_type == "SubModelPartTables") {
+                if (argument_count || !IsBlank(r_block.mContent)) return false;
+            } else if (r_type == "SubModelPartNodes"
+                       || r_type == "SubModelPartGeometries"
+                       || r_type == "SubModelPartElements"
+                       || r_type == "SubModelPartConditions"
+                       || r_type == "SubModelPartProperties") {
+                if (argument_count) return false;
+                r_block.mHasData = true;
+            } else {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+/// @brief Parse the lines of a chunk of a block.
+bool ParseLines(Text Lines,
+                std::size_t IntegersPerLine,
+                std::size_t RealsPerLine,
+                Ref<std::vector<std::size_t>> rIntegers,
+                Ref<std::vector<double>> rReals)
+{
+    while (!Lines.empty()) {
+        const char* p_line_end = static_cast<const char*>(std::memchr(Lines.data(), '\n', Lines.size()));
+        if (!p_line_end) p_line_end = Lines.data() + Lines.size();
+        const std::size_t line_size = p_line_end - Lines.data();
+        const Text line = StripComment(Lines.substr(0, line_size));
+        Lines.remove_prefix(std::min(line_size + 1, Lines.size()));
+
+        const char* it = line.data();
+        const char* it_end = it + line.size();
+        std::size_t value_count = 0;
+        while (true) {
+            while (it != it_end && IsSpace(*it)) ++it;
+            if (it == it_end) break;
+
+            std::from_chars_result result;
+            if (!IntegersPerLine || value_count < IntegersPerLine) {
+                std::size_t value;
+                result = std::from_chars(it, it_end, value);
+                rIntegers.push_back(value);
+            } else {
+                double value;
+                result = std::from_chars(it, it_end, value);
+                rReals.push_back(value);
+            }
+            if (result.ec != std::errc() || (result.ptr != it_end && !IsSpace(*result.ptr))) return false;
+            it = result.ptr;
+            ++value_count;
+        }
+
+        if (value_count && IntegersPerLine && value_count != IntegersPerLine + RealsPerLine) return false;
+    }
+    return true;
+}
+
+
+/// @brief Parse all data blocks, splitting them into chunks that are processed in parallel.
+bool ParseBlocks(Ref<std::vector<Block>> rBlocks)
+{
+    struct Task
+    {
+        std::size_t mBlock;
+        Text mLines;
+        std::vector<std::size_t> mIntegers;
+        std::vector<double> mReals;
+        bool mSuccess;
+    };
+
+    std::vector<Task> tasks;
+    for (std::size_t i_block=0; i_block<rBlocks.size(); ++i_block) {
+        if (!rBlocks[i_block].mHasData) continue;
+        for (Text lines : SplitLines(rBlocks[i_block].mContent)) tasks.push_back(Task {i_block, lines, {}, {}, false});
+    }
+
+    IndexPartition<std::size_t>(tasks.size()).for_each([&rBlocks, &tasks](std::size_t i_task) {
+        Task& r_task = tasks[i_task];
+        const Block& r_block = rBlocks[r_task.mBlock];
+        r_task.mSuccess = ParseLines(r_task.mLines,
+                                     r_block.mIntegersPerLine,
+                                     r_block.mRealsPerLine,
+                                     r_task.mIntegers,
+                                     r_task.mReals);
+    });
+
+    for (Task& r_task : tasks) {
+        if (!r_task.mSuccess) return false;
+        Block& r_block = rBlocks[r_task.mBlock];
+        r_block.mIntegers.insert(r_block.mIntegers.end(), r_task.mIntegers.begin(), r_task.mIntegers.end());
+        r_block.mReals.insert(r_block.mReals.end(), r_task.mReals.begin(), r_task.mReals.end());
+    }
+    return true;
+}
+
+
+/// @brief Sort and deduplicate IDs.
+void MakeUnique(Ref<std::vector<std::size_t>> rIds)
+{
+    std::sort(rIds.begin(), rIds.end());
+    rIds.erase(std::unique(rIds.begin(), rIds.end()), rIds.end());
+}
+
+
+/// @brief Count the values in records of @p Stride integers (at [Offset, Offset + Count) of each record) missing from the sorted @p rAvailable.
+std::size_t CountMissing(const std::vector<std::size_t>& rValues,
+                         std::size_t Stride,
+                         std::size_t Offset,
+                         std::size_t Count,
+                         const std::vector<std::size_t>& rAvailable)
+{
+    return IndexPartition<std::size_t>(rValues.size() / Stride).for_each<SumReduction<std::size_t>>([&](std::size_t i_record) {
+        std::size_t missing = 0;
+        for (std::size_t i_value=Offset; i_value<Offset+Count; ++i_value) {
+            missing += !std::binary_search(rAvailable.begin(), rAvailable.end(), rValues[i_record * Stride + i_value]);
+        }
+        return missing;
+    });
+}
+
+
+/// @brief Check that everything the blocks refer to exists either in the file or in the target model part.
+bool CheckReferences(const std::vector<Block>& rBlocks, Ref<const ModelPart> rTarget)
+{
+    std::vector<std::size_t> nodes, properties, geometries, elements, conditions;
+    for (const auto& r_node : rTarget.Nodes()) nodes.push_back(r_node.Id());
+    for (auto it=rTarget.PropertiesBegin(); it!=rTarget.PropertiesEnd(); ++it) properties.push_back(it->Id());
+    for (const auto& r_geometry : rTarget.Geometries()) geometries.push_back(r_geometry.Id());
+    for (const auto& r_element : rTarget.Elements()) elements.push_back(r_element.Id());
+    for (const auto& r_condition : rTarget.Conditions()) conditions.push_back(r_condition.Id());
+
+    for (const Block& r_block : rBlocks) {
+        const std::string& r_type = r_block.Type();
+        if (r_type == "Nodes") {
+            nodes.insert(nodes.end(), r_block.mIntegers.begin(), r_block.mIntegers.end());
+        } else if (r_type == "Properties") {
+            properties.push_back(r_block.mIntegers.front());
+        } else if (r_type == "Geometries" || r_type == "Elements" || r_type == "Conditions") {
+            auto& r_ids = r_type == "Geometries" ? geometries : r_type == "Elements" ? elements : conditions;
+            for (std::size_t i=0; i<r_block.mIntegers.size(); i+=r_block.mIntegersPerLine) r_ids.push_back(r_block.mIntegers[i]);
+        }
+    }
+    for (auto p_ids : {&nodes, &properties, &geometries, &elements, &conditions}) MakeUnique(*p_ids);
+
+    for (const Block& r_block : rBlocks) {
+        const std::string& r_type = r_block.Type();
+        std::size_t missing = 0;
+        if (r_type == "Geometries") {
+            missing = CountMissing(r_block.mIntegers, r_block.mIntegersPerLine, 1, r_block.mIntegersPerLine - 1, nodes);
+        } else if (r_type == "Elements" || r_type == "Conditions") {
+            missing = CountMissing(r_block.mIntegers, r_block.mIntegersPerLine, 1, 1, properties)
+                    + CountMissing(r_block.mIntegers, r_block.mIntegersPerLine, 2, r_block.mIntegersPerLine - 2, nodes);
+        } else if (r_type == "SubModelPartNodes") {
+            missing = CountMissing(r_block.mIntegers, 1, 0, 1, nodes);
+        } else if (r_type == "SubModelPartProperties") {
+            missing = CountMissing(r_block.mIntegers, 1, 0, 1, properties);
+        } else if (r_type == "SubModelPartGeometries") {
+            missing = CountMissing(r_block.mIntegers, 1, 0, 1, geometries);
+        } else if (r_type == "SubModelPartElements") {
+            missing = CountMissing(r_block.mIntegers, 1, 0, 1, elements);
+        } else if (r_type == "SubModelPartConditions") {
+            missing = CountMissing(r_block.mIntegers, 1, 0, 1, conditions);
+        }
+        if (missing) return false;
+    }
+    return true;
+}
+
+
+/// @brief Construct the entities of a block in parallel, in the order they appear in the file.
+template <class TEntity>
+std::vector<typename TEntity::Pointer> MakeEntities(const Block& rBlock,
+                                                    const std::vector<ModelPart::NodeType::Pointer>& rNodes,
+                                                    Ref<ModelPart> rTarget)
+{
+    constexpr bool has_properties = !std::is_same_v<TEntity,ModelPart::GeometryType>;
+    const std::size_t stride = rBlock.mIntegersPerLine;
+    const std::size_t node_offset = has_properties ? 2 : 1;
+    const std::size_t entity_count = rBlock.mIntegers.size() / stride;
+    const std::size_t* p_records = rBlock.mIntegers.data();
+
+    std::vector<typename TEntity::Pointer> output(entity_count);
+    Detail::MakeEntities(KratosComponents<TEntity>::Get(rBlock.mWords[1]),
+                         entity_count,
+                         stride - node_offset,
+                         [=](std::size_t i_entity) {return p_records[i_entity * stride];},
+                         [=](std::size_t i_entity) {return p_records[i_entity * stride + 1];},
+                         [=, &rNodes](std::size_t i_entity, std::size_t i_node) {
+                             return *std::lower_bound(rNodes.begin(),
+                                                      rNodes.end(),
+                                                      p_records[i_entity * stride + node_offset + i_node],
+                                                      [](const auto& rp_node, std::size_t Id){return rp_node->Id() < Id;});
+                         },
+                         rTarget,
+                         output.data());
+
+    return output;
+}
+
+
+/// @brief Populate a (sub) model part with the contents of a block's children.
+void Populate(const std::vector<Block>& rBlocks,
+              std::size_t iBlock,
+              Ref<ModelPart> rModelPart)
+{
+    for (std::size_t i_child : rBlocks[iBlock].mChildren) {
+        const Block& r_block = rBlocks[i_child];
+        const std::string& r_type = r_block.Type();
+        const std::vector<ModelPart::IndexType> ids(r_block.mIntegers.begin(), r_block.mIntegers.end());
+
+        if (r_type == "SubModelPart") {
+            const std::string& r_name = r_block.mWords[1];
+            Populate(rBlocks,
+                     i_child,
+                     rModelPart.HasSubModelPart(r_name) ? rModelPart.GetSubModelPart(r_name) : rModelPart.CreateSubModelPart(r_name));
+        } else if (r_type == "SubModelPartNodes") {
+            rModelPart.AddNodes(ids);
+        } else if (r_type == "SubModelPartProperties") {
+            for (auto id : ids) rModelPart.AddProperties(rModelPart.GetRootModelPart().pGetProperties(id));
+        } else if (r_type == "SubModelPartGeometries") {
+            rModelPart.AddGeometries(ids);
+        } else if (r_type == "SubModelPartElements") {
+            rModelPart.AddElements(ids);
+        } else if (r_type == "SubModelPartConditions") {
+            rModelPart.AddConditions(ids);
+        }
+    }
+}
+
+
+/// @brief Number of lines a buffer holds before being written, bounding the writer's memory.
+constexpr std::size_t LinesPerBuffer = std::size_t(1) << 15;
+
+
+/// @brief @a std::to_chars equivalent of a stream's floating point formatting.
+struct FloatFormat
+{
+    std::chars_format mFormat;
+
+    int mPrecision;
+}; // struct FloatFormat
+
+
+/// @brief Coordinate format of @ref Kratos::ModelPartIO with @a IO::SCIENTIFIC_PRECISION.
+/// @details Must follow the core writer; mdpa_write_benchmark compares the outputs byte for byte.
+constexpr FloatFormat CoreFloatFormat {std::chars_format::scientific, 10};
+
+
+void Append(Ref<std::string> rBuffer, std::size_t Value)
+{
+    std::array<char,32> characters;
+    const auto result = std::to_chars(characters.data(), characters.data() + characters.size(), Value);
+    rBuffer.append(characters.data(), result.ptr);
+}
+
+
+void Append(Ref<std::string> rBuffer, double Value, const FloatFormat& rFormat)
+{
+    // Large enough for the fixed representation of any double.
+    std::array<char,512> characters;
+    const auto result = std::to_chars(characters.data(), characters.data() + characters.size(), Value, rFormat.mFormat, rFormat.mPrecision);
+    rBuffer.append(characters.data(), result.ptr);
+}
+
+
+/// @brief Format lines in parallel into per-thread buffers, and write them in order one batch at a time.
+/// @param Count Number of lines to write.
+/// @param rFormatLine Callable appending line i to a buffer: void(std::size_t, Ref<std::string>)
+template <class TFormatLine>
+void WriteLines(Ref<std::ostream> rStream, std::size_t Count, TFormatLine&& rFormatLine)
+{
+    const std::size_t buffer_count = ParallelUtilities::GetNumThreads();
+    std::vector<std::string> buffers(buffer_count);
+    const std::size_t batch_size = buffer_count * LinesPerBuffer;
+
+    for (std::size_t i_batch_begin=0; i_batch_begin<Count; i_batch_begin+=batch_size) {
+        const std::size_t i_batch_end = std::min(Count, i_batch_begin + batch_size);
+        const std::size_t lines_per_buffer = (i_batch_end - i_batch_begin + buffer_count - 1) / buffer_count;
+        IndexPartition<std::size_t>(buffer_count).for_each([&](std::size_t i_buffer) {
+            std::string& r_buffer = buffers[i_buffer];
+            r_buffer.clear();
+            const std::size_t i_begin = std::min(i_batch_end, i_batch_begin + i_buffer * lines_per_buffer);
+            const std::size_t i_end = std::min(i_batch_end, i_begin + lines_per_buffer);
+            for (std::size_t i_line=i_begin; i_line<i_end; ++i_line) rFormatLine(i_line, r_buffer);
+        });
+        for (const auto& r_buffer : buffers) rStream.write(r_buffer.data(), r_buffer.size());
+    }
+}
+
+
+/// @brief Check whether the model part only has data that @ref WriteModelPart writes.
+bool IsWritable(Ref<const ModelPart> rModelPart)
+{
+    if (rModelPart.NumberOfTables()
+        || rModelPart.NumberOfGeometries()
+        || rModelPart.NumberOfMasterSlaveConstraints()
+        || rModelPart.GetNodalSolutionStepVariablesList().size()
+        || !static_cast<const DataValueContainer&>(rModelPart).IsEmpty()) return false;
+
+    const std::size_t unsupported = block_for_each<SumReduction<std::size_t>>(rModelPart.Nodes(), [](const auto& r_node) -> std::size_t {
+            return !r_node.GetData().IsEmpty();
+        })
+        + block_for_each<SumReduction<std::size_t>>(rModelPart.Elements(), [](const auto& r_element) -> std::size_t {
+            return !r_element.GetData().IsEmpty() || !r_element.pGetProperties();
+        })
+        + block_for_each<SumReduction<std::size_t>>(rModelPart.Conditions(), [](const auto& r_condition) -> std::size_t {
+            return !r_condition.GetData().IsEmpty() || !r_condition.pGetProperties();
+        });
+    if (unsupported) return false;
+
+    for (const auto& r_name : rModelPart.GetSubModelPartNames()) {
+        if (!IsWritable(rModelPart.GetSubModelPart(r_name))) return false;
+    }
+    return true;
+}
+
+
+/// @brief Write an "Elements" or "Conditions" block for each run of consecutive entities with identical registered names.
+template <class TContainer>
+void WriteEntities(Ref<std::ostream> rStream, const TContainer& rEntities, const std::string& rBlockName)
+{
+    const Detail::EntityGrouping grouping = Detail::GroupByRegisteredName(rEntities);
+    std::vector<std::pair<std::size_t,const std::string*>> runs; // (first entity, name)
+    for (std::size_t i_entity=0; i_entity<rEntities.size(); ++i_entity) {
+        const std::string& r_name = grouping.mGroups[grouping.mPositions[i_entity].first].mName;
+        if (runs.empty() || *runs.back().second != r_name) runs.emplace_back(i_entity, &r_name);
+    }
+
+    for (std::size_t i_run=0; i_run<runs.size(); ++i_run) {
+        const std::size_t i_begin = runs[i_run].first;
+        const std::size_t i_end = i_run + 1 < runs.size() ? runs[i_run + 1].first : rEntities.size();
+        rStream << "Begin " << rBlockName << "\t" << *runs[i_run].second << "\n";
+        WriteLines(rStream, i_end - i_begin, [&rEntities, i_begin](std::size_t i_line, Ref<std::string> rBuffer) {
+            const auto& r_entity = *(rEntities.begin() + i_begin + i_line);
+            rBuffer.push_back('\t');
+            Append(rBuffer, r_entity.Id());
+            rBuffer.push_back('\t');
+            Append(rBuffer, r_entity.GetProperties().Id());
+            rBuffer.push_back('\t');
+            for (const auto& r_node : r_entity.GetGeometry()) {
+                Append(rBuffer, r_node.Id());
+                rBuffer.push_back('\t');
+            }
+            rBuffer.push_back('\n');
+        });
+        rStream << "End " << rBlockName << "\n\n";
+    }
+}
+
+
+/// @brief Write an ID list of a sub model part.
+template <class TIterator>
+void WriteIds(Ref<std::ostream> rStream,
+              TIterator itBegin,
+              std::size_t Count,
+              const std::string& rTabulation,
+              const std::string& rBlockName)
+{
+    rStream << rTabulation << "\tBegin " << rBlockName << "\n";
+    WriteLines(rStream, Count, [itBegin, &rTabulation](std::size_t i_line, Ref<std::string> rBuffer) {
+        rBuffer.append(rTabulation);
+        rBuffer.append("\t\t");
+        Append(rBuffer, (itBegin + i_line)->Id());
+        rBuffer.push_back('\n');
+    });
+    rStream << rTabulation << "\tEnd " << rBlockName << "\n";
+}
+
+
+void WriteSubModelParts(Ref<std::ostream> rStream, Ref<const ModelPart> rModelPart, const std::string& rTabulation)
+{
+    for (const auto& r_name : rModelPart.GetSubModelPartNames()) {
+        const ModelPart& r_sub_model_part = rModelPart.GetSubModelPart(r_name);
+        rStream << rTabulation << "Begin SubModelPart\t" << r_name << "\n"
+                << rTabulation << "\tBegin SubModelPartData\n"
+                << rTabulation << "\tEnd SubModelPartData\n"
+                << rTabulation << "\tBegin SubModelPartTables\n"
+                << rTabulation << "\tEnd SubModelPartTables\n";
+        WriteIds(rStream, r_sub_model_part.PropertiesBegin(), r_sub_model_part.NumberOfProperties(), rTabulation, "SubModelPartProperties");
+        WriteIds(rStream, r_sub_model_part.NodesBegin(), r_sub_model_part.NumberOfNodes(), rTabulation, "SubModelPartNodes");
+        WriteIds(rStream, r_sub_model_part.ElementsBegin(), r_sub_model_part.NumberOfElements(), rTabulation, "SubModelPartElements");
+        WriteIds(rStream, r_sub_model_part.ConditionsBegin(), r_sub_model_part.NumberOfConditions(), rTabulation, "SubModelPartConditions");
+        WriteSubModelParts(rStream, r_sub_model_part, rTabulation + "\t");
+        rStream << rTabulation << "End SubModelPart\n\n";
+    }
+}
+
+
+/// @brief Write a model part to a stream with @ref Kratos::ModelPartIO.
+std::string WriteWithCore(Ref<ModelPart> rModelPart)
+{
+    auto p_stream = std::make_shared<std::stringstream>();
+    Kratos::ModelPartIO(p_stream, IO::WRITE | IO::SCIENTIFIC_PRECISION).WriteModelPart(rModelPart);
+    return p_stream->str();
+}
+
+
+/// @brief Everything @ref Kratos::ModelPartIO writes before the nodes (model part data and properties).
+/// @details Formatted by the core writer on a model part that only shares the source's properties
+///          and process info, since this part of the output is small.
+std::string MakeHead(Ref<ModelPart> rSource)
+{
+    Model model;
+    ModelPart& r_proxy = model.CreateModelPart(rSource.Name());
+    r_proxy.SetProcessInfo(rSource.pGetProcessInfo());
+    r_proxy.SetBufferSize(rSource.GetBufferSize());
+    for (auto it=rSource.rProperties().ptr_begin(); it!=rSource.rProperties().ptr_end(); ++it) r_proxy.AddProperties(*it);
+
+    std::string head = WriteWithCore(r_proxy);
+    const auto position = head.find("Begin Nodes");
+    if (position != std::string::npos) head.resize(position);
+    return head;
+}
+
+
+/// @brief Write a model part the way @ref Kratos::ModelPartIO does, formatting nodes and entities in parallel.
+void WriteModelPart(Ref<std::ostream> rStream, Ref<ModelPart> rSource, const FloatFormat& rFormat)
+{
+    rStream << MakeHead(rSource);
+
+    const auto& r_nodes = rSource.Nodes();
+    rStream << "Begin Nodes\n";
+    WriteLines(rStream, r_nodes.size(), [&r_nodes, &rFormat](std::size_t i_line, Ref<std::string> rBuffer) {
+        const auto& r_node = *(r_nodes.begin() + i_line);
+        rBuffer.push_back('\t');
+        Append(rBuffer, r_node.Id());
+        for (double coordinate : {r_node.X(), r_node.Y(), r_node.Z()}) {
+            rBuffer.push_back('\t');
+            Append(rBuffer, coordinate, rFormat);
+        }
+        rBuffer.push_back('\n');
+    });
+    rStream << "End Nodes\n\n";
+
+    WriteEntities(rStream, rSource.Elements(), "Elements");
+    WriteEntities(rStream, rSource.Conditions(), "Conditions");
+    WriteSubModelParts(rStream, rSource, "");
+}
+
+
+} // unnamed namespace
+
+
+bool ReadMDPA(const std::filesystem::path& rFilePath, Ref<ModelPart> rTarget)
+{
+    KRATOS_TRY
+
+    if (rTarget.IsSubModelPart()) return false;
+    const auto p_file = MappedFile::Open(rFilePath);
+    if (!p_file) return false;
+    const Text file(reinterpret_cast<const char*>(p_file->Data()), p_file->Size());
+
+    // Parse and validate everything before touching the target.
+    auto maybe_blocks = MakeBlocks(file, FindMarkers(file));
+    if (!maybe_blocks.has_value()) return false;
+    auto& r_blocks = maybe_blocks.value();
+    if (!ConfigureBlocks(r_blocks, 0, false) || !ParseBlocks(r_blocks) || !CheckReferences(r_blocks, rTarget)) return false;
+
+    // Properties
+    for (const Block& r_block : r_blocks) {
+        if (r_block.Type() == "Properties" && !rTarget.HasProperties(r_block.mIntegers.front())) {
+            rTarget.CreateNewProperties(r_block.mIntegers.front());
+        }
+    }
+
+    // Nodes
+    const auto p_variables = rTarget.pGetNodalSolutionStepVariablesList();
+    const auto buffer_size = rTarget.GetBufferSize();
+    for (const Block& r_block : r_blocks) {
+        if (r_block.Type() != "Nodes") continue;
+        const std::size_t node_count = r_block.mIntegers.size();
+        std::vector<ModelPart::NodeType::Pointer> nodes(node_count);
+        IndexPartition<std::size_t>(node_count).for_each([&](std::size_t i_node) {
+            const double* p_coordinates = r_block.mReals.data() + 3 * i_node;
+            const std::array<double,3> coordinates {p_coordinates[0], p_coordinates[1], p_coordinates[2]};
+            nodes[i_node] = Detail::MakeNode(r_block.mIntegers[i_node], coordinates, coordinates, p_variables, buffer_size);
+        });
+
+        ModelPart::NodesContainerType container;
+        container.reserve(node_count);
+        for (const auto& rp_node : nodes) container.push_back(rp_node);
+        rTarget.AddNodes(container.begin(), container.end());
+    }
+
+    std::vector<ModelPart::NodeType::Pointer> nodes;
+    nodes.reserve(rTarget.NumberOfNodes());
+    for (auto it=rTarget.Nodes().ptr_begin(); it!=rTarget.Nodes().ptr_end(); ++it) nodes.push_back(*it);
+    if (!std::is_sorted(nodes.begin(), nodes.end(), [](const auto& rp_left, const auto& rp_right){return rp_left->Id() < rp_right->Id();})) {
+        std::sort(nodes.begin(), nodes.end(), [](const auto& rp_left, const auto& rp_right){return rp_left->Id() < rp_right->Id();});
+    }
+
+    // Geometries, elements and conditions, in the order of their blocks.
+    for (const Block& r_block : r_blocks) {
+        if (r_block.Type() == "Geometries") {
+            for (const auto& rp_geometry : MakeEntities<ModelPart::GeometryType>(r_block, nodes, rTarget)) rTarget.AddGeometry(rp_geometry);
+        } else if (r_block.Type() == "Elements") {
+            const auto elements = MakeEntities<Element>(r_block, nodes, rTarget);
+            ModelPart::ElementsContainerType container;
+            container.reserve(elements.size());
+            for (const auto& rp_element : elements) container.push_back(rp_element);
+            rTarget.AddElements(container.begin(), container.end());
+        } else if (r_block.Type() == "Conditions") {
+            const auto conditions = MakeEntities<Condition>(r_block, nodes, rTarget);
+            ModelPart::ConditionsContainerType container;
+            container.reserve(conditions.size());
+            for (const auto& rp_condition : conditions) container.push_back(rp_condition);
+            rTarget.AddConditions(container.begin(), container.end());
+        }
+    }
+
+    // Sub model parts
+    Populate(r_blocks, 0, rTarget);
+
+    return true;
+    KRATOS_CATCH("")
+}
+
+
+bool WriteMDPA(const std::filesystem::path& rFilePath, Ref<const ModelPart> rSource)
+{
+    KRATOS_TRY
+    if (!IsWritable(rSource)) return false;
+
+    std::ofstream file(rFilePath);
+    KRATOS_ERROR_IF_NOT(file) << "cannot open " << rFilePath << " for writing\n";
+    WriteModelPart(file, const_cast<ModelPart&>(rSource), CoreFloatFormat);
+    KRATOS_ERROR_IF_NOT(file.flush()) << "failed to write " << rFilePath << "\n";
+    return true;
+    KRATOS_CATCH("")
+}
+
+
+} // namespace Kratos::UtilityApp
@@ -0,0 +1,338 @@
+/// @author Máté Kelemen
+
+// --- MED Includes ---
+#include <med.h>
+
+// --- Core Includes ---
+#include "includes/model_part.h"
+#include "geometries/geometry_data.h"
+#include "utilities/parallel_utilities.h"
+
+// --- Utility Includes ---
+#include "UtilityApp/StreamingMED.hpp"
+
+// --- STL Includes ---
+#include <array> // array
+#include <vector> // vector
+#include <string> // string, to_string
+#include <map> // map
+#include <unordered_map> // unordered_map
+#include <optional> // optional
+#include <algorithm> // lower_bound, sort, max
+#include <limits> // numeric_limits
+#include <system_error> // error_code
+#include <filesystem> // path, remove, rename
+
+
+namespace Kratos::UtilityApp {
+
+
+namespace {
+
+
+using GeometryType = ModelPart::GeometryType;
+
+
+med_idt CheckMED(med_idt Status, const char* pWhat)
+{
+    KRATOS_ERROR_IF(Status < 0) << "MED failed to " << pWhat << "\n";
+    return Status;
+}
+
+
+/// @brief Owning wrapper of a MED file opened for writing.
+class MEDFile
+{
+public:
+    explicit MEDFile(const std::filesystem::path& rFilePath)
+        : mId(Create(rFilePath))
+    {
+    }
+
+    MEDFile(const MEDFile&) = delete;
+
+    ~MEDFile()
+    {
+        MEDfileClose(mId);
+    }
+
+    operator med_idt() const noexcept {return mId;}
+
+private:
+    /// @brief Create an empty file, since @a MED_ACC_CREAT opens existing ones (left over from failed writes) without truncating them.
+    static med_idt Create(const std::filesystem::path& rFilePath)
+    {
+        std::error_code error;
+        std::filesystem::remove(rFilePath, error);
+        KRATOS_ERROR_IF(error) << "failed to remove existing " << rFilePath << ": " << error.message() << "\n";
+        return CheckMED(MEDfileOpen(rFilePath.string().c_str(), MED_ACC_CREAT), "create file");
+    }
+
+    med_idt mId;
+}; // class MEDFile
+
+
+/// @brief MED cell type of Kratos geometries, along with the node ordering @ref Kratos::MedModelPartIO uses for it.
+struct CellType
+{
+    GeometryData::KratosGeometryFamily mFamily;
+
+    std::size_t mNodeCount;
+
+    med_geometry_type mMEDType;
+
+    /// @brief Position of each node of a Kratos geometry in the MED connectivity.
+    /// @details MED orders the nodes of faces and cells in the opposite orientation to Kratos,
+    ///          so the permutations swap pairs of nodes, and are therefore their own inverses.
+    std::vector<std::size_t> mPositions;
+}; // struct CellType
+
+
+const std::array<CellType,16> CellTypes {{
+    {GeometryData::KratosGeometryFamily::Kratos_Point,          1,  MED_POINT1,  {0}},
+    {GeometryData::KratosGeometryFamily::Kratos_Linear,         2,  MED_SEG2,    {0, 1}},
+    {GeometryData::KratosGeometryFamily::Kratos_Linear,         3,  MED_SEG3,    {0, 1, 2}},
+    {GeometryData::KratosGeometryFamily::Kratos_Triangle,       3,  MED_TRIA3,   {0, 2, 1}},
+    {GeometryData::KratosGeometryFamily::Kratos_Triangle,       6,  MED_TRIA6,   {0, 2, 1, 5, 4, 3}},
+    {GeometryData::KratosGeometryFamily::Kratos_Quadrilateral,  4,  MED_QUAD4,   {0, 3, 2, 1}},
+    {GeometryData::KratosGeometryFamily::Kratos_Quadrilateral,  8,  MED_QUAD8,   {0, 3, 2, 1, 7, 6, 5, 4}},
+    {GeometryData::KratosGeometryFamily::Kratos_Tetrahedra,     4,  MED_TETRA4,  {0, 2, 1, 3}},
+    {GeometryData::KratosGeometryFamily::Kratos_Tetrahedra,     10, MED_TETRA10, {0, 2, 1, 3, 6, 5, 4, 7, 9, 8}},
+    {GeometryData::KratosGeometryFamily::Kratos_Pyramid,        5,  MED_PYRA5,   {0, 3, 2, 1, 4}},
+    {GeometryData::KratosGeometryFamily::Kratos_Pyramid,        13, MED_PYRA13,  {0, 3, 2, 1, 4, 8, 7, 6, 5, 9, 12, 11, 10}},
+    {GeometryData::KratosGeometryFamily::Kratos_Prism,          6,  MED_PENTA6,  {0, 2, 1, 3, 5, 4}},
+    {GeometryData::KratosGeometryFamily::Kratos_Prism,          15, MED_PENTA15, {0, 2, 1, 3, 5, 4, 8, 7, 6, 11, 10, 9, 12, 14, 13}},
+    {GeometryData::KratosGeometryFamily::Kratos_Hexahedra,      8,  MED_HEXA8,   {0, 3, 2, 1, 4, 7, 6, 5}},
+    {GeometryData::KratosGeometryFamily::Kratos_Hexahedra,      20, MED_HEXA20,  {0, 3, 2, 1, 4, 7, 6, 5, 11, 10, 9, 8, 15, 14, 13, 12, 16, 19, 18, 17}},
+    {GeometryData::KratosGeometryFamily::Kratos_Hexahedra,      27, MED_HEXA27,  {0, 3, 2, 1, 4, 7, 6, 5, 11, 10, 9, 8, 15, 14, 13, 12, 16, 19, 18, 17, 20, 24, 23, 22, 21, 25, 26}}
+}};
+
+
+const CellType* FindCellType(const GeometryType& rGeometry)
+{
+    for (const CellType& r_type : CellTypes) {
+        if (r_type.mFamily == rGeometry.GetGeometryFamily() && r_type.mNodeCount == rGeometry.PointsNumber()) return &r_type;
+    }
+    return nullptr;
+}
+
+
+/// @brief Position of a node in a (sorted) nodes container.
+std::optional<std::size_t> FindNodeIndex(const ModelPart::NodesContainerType& rNodes, ModelPart::IndexType Id)
+{
+    const auto it = std::lower_bound(rNodes.begin(),
+                                     rNodes.end(),
+                                     Id,
+                                     [](const Node& r_node, ModelPart::IndexType target_id){
+                                        return r_node.Id() < target_id;
+                                     });
+    if (it == rNodes.end() || it->Id() != Id) return {};
+    return std::distance(rNodes.begin(), it);
+}
+
+
+/// @brief Collect the sub model parts of @p rModelPart recursively, along with their paths relative to it.
+void CollectGroups(const ModelPart& rModelPart,
+                   const std::string& rPrefix,
+                   std::vector<std::pair<std::string,const ModelPart*>>& rGroups)
+{
+    auto names = rModelPart.GetSubModelPartNames();
+    std::sort(names.begin(), names.end());
+    for (const auto& r_name : names) {
+        const ModelPart& r_sub_model_part = rModelPart.GetSubModelPart(r_name);
+        rGroups.emplace_back(rPrefix + r_name, &r_sub_model_part);
+        CollectGroups(r_sub_model_part, rPrefix + r_name + ".", rGroups);
+    }
+}
+
+
+/// @brief Write the nodes, geometries and sub model parts of a model part that was checked to be writable.
+void WriteFile(const std::filesystem::path& rFilePath, const ModelPart& rSource)
+{
+    const auto& r_nodes = rSource.Nodes();
+    const std::size_t node_count = r_nodes.size();
+
+    std::vector<med_float> coordinates(3 * node_count);
+    std::vector<med_int> node_numbers(node_count);
+    IndexPartition<std::size_t>(node_count).for_each([&](std::size_t i_node) {
+        const auto& r_node = *(r_nodes.begin() + i_node);
+        node_numbers[i_node] = static_cast<med_int>(r_node.Id());
+        coordinates[3 * i_node] = r_node.X();
+        coordinates[3 * i_node + 1] = r_node.Y();
+        coordinates[3 * i_node + 2] = r_node.Z();
+    });
+
+    // Cells grouped by type, in the order of the geometry container.
+    std::map<med_geometry_type,std::vector<const GeometryType*>> cells;
+    std::map<med_geometry_type,const CellType*> cell_types;
+    int mesh_dimension = 0;
+    for (const auto& r_geometry : rSource.Geometries()) {
+        const CellType* p_type = FindCellType(r_geometry);
+        cells[p_type->mMEDType].push_back(&r_geometry);
+        cell_types[p_type->mMEDType] = p_type;
+        mesh_dimension = std::max<int>(mesh_dimension, r_geometry.LocalSpaceDimension());
+    }
+
+    // Each distinct set of groups an entity belongs to is a family. Node families are
+    // positive, cell families negative, and family 0 has no groups.
+    std::vector<std::pair<std::string,const ModelPart*>> groups;
+    CollectGroups(rSource, "", groups);
+
+    std::vector<std::vector<int>> node_groups(node_count);
+    std::map<med_geometry_type,std::vector<std::vector<int>>> cell_groups;
+    for (const auto& [type, r_cells] : cells) cell_groups[type].resize(r_cells.size());
+
+    if (!groups.empty()) {
+        std::unordered_map<ModelPart::IndexType,std::pair<med_geometry_type,std::size_t>> cell_indices;
+        for (const auto& [type, r_cells] : cells) {
+            for (std::size_t i_cell=0; i_cell<r_cells.size(); ++i_cell) cell_indices.emplace(r_cells[i_cell]->Id(), std::make_pair(type, i_cell));
+        }
+
+        for (std::size_t i_group=0; i_group<groups.size(); ++i_group) {
+            const ModelPart& r_group = *groups[i_group].second;
+            // Nodes are unique within a group, so each node's list is only extended by one thread.
+            IndexPartition<std::size_t>(r_group.NumberOfNodes()).for_each([&](std::size_t i_node) {
+                node_groups[FindNodeIndex(r_nodes, (r_group.NodesBegin() + i_node)->Id()).value()].push_back(i_group);
+            });
+            for (const auto& r_geometry : r_group.Geometries()) {
+                const auto& [type, i_cell] = cell_indices.at(r_geometry.Id());
+                cell_groups[type][i_cell].push_back(i_group);
+            }
+        }
+    }
+
+    std::map<std::vector<int>,med_int> node_families, cell_families;
+    const auto get_family = [](std::map<std::vector<int>,med_int>& rFamilies, const std::vector<int>& rGroups, med_int Sign) -> med_int {
+        if (rGroups.empty()) return 0;
+        auto it_family = rFamilies.find(rGroups);
+        if (it_family == rFamilies.end()) {
+            it_family = rFamilies.emplace(rGroups, Sign * static_cast<med_int>(rFamilies.size() + 1)).first;
+        }
+        return it_family->second;
+    };
+
+    std::vector<med_int> node_family_numbers(node_count);
+    for (std::size_t i_node=0; i_node<node_count; ++i_node) {
+        node_family_numbers[i_node] = get_family(node_families, node_groups[i_node], 1);
+    }
+
+    std::map<med_geometry_type,std::vector<med_int>> cell_family_numbers;
+    for (const auto& [type, r_groups] : cell_groups) {
+        auto& r_numbers = cell_family_numbers[type];
+        r_numbers.reserve(r_groups.size());
+        for (const auto& r_cell_groups : r_groups) r_numbers.push_back(get_family(cell_families, r_cell_groups, -1));
+    }
+
+    // Mesh
+    MEDFile file(rFilePath);
+    const std::string mesh_name = rSource.Name().substr(0, MED_NAME_SIZE);
+    std::string axis_names(3 * MED_SNAME_SIZE, ' ');
+    axis_names[0] = 'X';
+    axis_names[MED_SNAME_SIZE] = 'Y';
+    axis_names[2 * MED_SNAME_SIZE] = 'Z';
+    const std::string axis_units(3 * MED_SNAME_SIZE, ' ');
+    CheckMED(MEDmeshCr(file,
+                       mesh_name.c_str(),
+                       3,
+                       mesh_dimension ? mesh_dimension : 3,
+                       MED_UNSTRUCTURED_MESH,
+                       "",
+                       "",
+                       MED_SORT_DTIT,
+                       MED_CARTESIAN,
+                       axis_names.c_str(),
+                       axis_units.c_str()),
+             "create mesh");
+
+    // Families
+    CheckMED(MEDfamilyCr(file, mesh_name.c_str(), "FAMILLE_ZERO", 0, 0, ""), "create family");
+    for (const auto* p_families : {&node_families, &cell_families}) {
+        for (const auto& [r_group_indices, number] : *p_families) {
+            std::string group_names(r_group_indices.size() * MED_LNAME_SIZE, '\0');
+            for (std::size_t i_group=0; i_group<r_group_indices.size(); ++i_group) {
+                const std::string& r_name = groups[r_group_indices[i_group]].first;
+                group_names.replace(i_group * MED_LNAME_SIZE, r_name.size(), r_name);
+            }
+            const std::string family_name = "FAM_" + std::to_string(number);
+            CheckMED(MEDfamilyCr(file, mesh_name.c_str(), family_name.c_str(), number, r_group_indices.size(), group_names.c_str()),
+                     "create family");
+        }
+    }
+
+    // Nodes
+    if (node_count) {
+        CheckMED(MEDmeshNodeCoordinateWr(file, mesh_name.c_str(), MED_NO_DT, MED_NO_IT, 0.0, MED_FULL_INTERLACE, node_count, coordinates.data()),
+                 "write node coordinates");
+        CheckMED(MEDmeshEntityNumberWr(file, mesh_name.c_str(), MED_NO_DT, MED_NO_IT, MED_NODE, MED_NONE, node_count, node_numbers.data()),
+                 "write node numbers");
+        CheckMED(MEDmeshEntityFamilyNumberWr(file, mesh_name.c_str(), MED_NO_DT, MED_NO_IT, MED_NODE, MED_NONE, node_count, node_family_numbers.data()),
+                 "write node families");
+    }
+
+    // Cells
+    for (const auto& [type, r_cells] : cells) {
+        const auto& r_positions = cell_types.at(type)->mPositions;
+        const std::size_t nodes_per_cell = r_positions.size();
+        std::vector<med_int> connectivities(r_cells.size() * nodes_per_cell), numbers(r_cells.size());
+        IndexPartition<std::size_t>(r_cells.size()).for_each([&](std::size_t i_cell) {
+            const GeometryType& r_geometry = *r_cells[i_cell];
+            numbers[i_cell] = static_cast<med_int>(r_geometry.Id());
+            for (std::size_t i_node=0; i_node<nodes_per_cell; ++i_node) {
+                // MED refers to nodes by their (1-based) position instead of their number.
+                connectivities[i_cell * nodes_per_cell + r_positions[i_node]] = static_cast<med_int>(FindNodeIndex(r_nodes, r_geometry[i_node].Id()).value() + 1);
+            }
+        });
+
+        CheckMED(MEDmeshElementConnectivityWr(file, mesh_name.c_str(), MED_NO_DT, MED_NO_IT, 0.0, MED_CELL, type, MED_NODAL, MED_FULL_INTERLACE, r_cells.size(), connectivities.data()),
+                 "write connectivities");
+        CheckMED(MEDmeshEntityNumberWr(file, mesh_name.c_str(), MED_NO_DT, MED_NO_IT, MED_CELL, type, r_cells.size(), numbers.data()),
+                 "write cell numbers");
+        CheckMED(MEDmeshEntityFamilyNumberWr(file, mesh_name.c_str(), MED_NO_DT, MED_NO_IT, MED_CELL, type, r_cells.size(), cell_family_numbers[type].data()),
+                 "write cell families");
+    }
+}
+
+
+} // unnamed namespace
+
+
+bool WriteMED(const std::filesystem::path& rFilePath, Ref<const ModelPart> rSource)
+{
+    KRATOS_TRY
+    if (rSource.NumberOfElements() || rSource.NumberOfConditions()) return false;
+
+    constexpr auto max_number = static_cast<std::size_t>(std::numeric_limits<med_int>::max());
+    if (!rSource.Nodes().empty() && max_number < (rSource.NodesEnd() - 1)->Id()) return false;
+
+    std::vector<std::pair<std::string,const ModelPart*>> groups;
+    CollectGroups(rSource, "", groups);
+    for (const auto& r_group : groups) {
+        if (MED_LNAME_SIZE < r_group.first.size()) return false;
+    }
+
+    for (const auto& r_geometry : rSource.Geometries()) {
+        const CellType* p_type = FindCellType(r_geometry);
+        if (!p_type || max_number < r_geometry.Id()) return false;
+        for (const auto& r_node : r_geometry) {
+            if (!FindNodeIndex(rSource.Nodes(), r_node.Id())) return false;
+        }
+    }
+
+    // The file is written next to the target and moved over it once it's complete,
+    // so a failed write leaves the previous file intact.
+    std::filesystem::path temporary_path = rFilePath;
+    temporary_path += ".partial";
+    try {
+        WriteFile(temporary_path, rSource);
+    } catch (...) {
+        std::error_code error;
+        std::filesystem::remove(temporary_path, error);
+        throw;
+    }
+    std::filesystem::rename(temporary_path, rFilePath);
+    return true;
+    KRATOS_CATCH("")
+}
+
+
+} // namespace Kratos::UtilityApp